@@ -0,0 +1,284 @@
+#!/bin/bash
+# Run the Day 1 benchmarks under controlled conditions, one JSON report
+#
+#   1. builds every benchmark in a Release tree (build-release by default)
+#   2. pins them to BENCH_CPUS with taskset (default: every CPU this shell
+#      may run on but the first, which takes most interrupts and housekeeping)
+#   3. where /sys is writable (root), switches those CPUs to the
+#      performance governor and turns turbo off, restoring both on exit
+#   4. runs each benchmark once, under `perf stat` when perf is installed
+#   5. writes wall time, exit status, perf counters and every result line
+#      the benchmark printed to bench-report.json
+#
+# Usage: ./bench.sh [options] [benchmark...]
+#   --quick            run the smaller training workloads from
+#                      day1/CMakeLists.txt instead of each default
+#   --perf             require perf and record the detailed event set
+#                      (cache, TLB and branch misses)
+#   --no-perf          wall time only, even when perf is installed
+#   --build-dir DIR    Release tree to build and run (default build-release)
+#   --no-build         run what DIR already holds (the CMake bench targets)
+#   --out FILE         report path (default bench-report.json)
+# Benchmark names restrict the run to those benchmarks.
+
+set -euo pipefail
+cd "$(dirname "$0")"
+# shellcheck source=bench_common.sh
+. ./bench_common.sh
+
+QUICK=0
+PERF_MODE=auto
+BUILD_DIR=build-release
+BUILD=1
+OUT=bench-report.json
+SELECTED=()
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --quick) QUICK=1 ;;
+        --perf) PERF_MODE=detailed ;;
+        --no-perf) PERF_MODE=off ;;
+        --build-dir) BUILD_DIR=$2; shift ;;
+        --no-build) BUILD=0 ;;
+        --out) OUT=$2; shift ;;
+        -*) echo "❌ Unknown option $1" >&2; exit 1 ;;
+        *) SELECTED+=("$1") ;;
+    esac
+    shift
+done
+
+if [ "$BUILD" = 1 ]; then
+    echo "🔨 Building $BUILD_DIR (Release)..."
+    cmake -S . -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release >/dev/null
+    cmake --build "$BUILD_DIR" --parallel >/dev/null
+fi
+MANIFEST="$BUILD_DIR/day1/benchmarks.txt"
+if [ ! -f "$MANIFEST" ]; then
+    echo "❌ No $MANIFEST; is $BUILD_DIR a configured build tree?" >&2
+    exit 1
+fi
+BUILD_TYPE=$(sed -n 's/^CMAKE_BUILD_TYPE:[A-Z]*=//p' "$BUILD_DIR/CMakeCache.txt")
+if [ "$BUILD_TYPE" != "Release" ]; then
+    echo "⚠️ $BUILD_DIR is a '${BUILD_TYPE:-default}' build; numbers are not comparable" >&2
+fi
+
+PERF=""
+if [ "$PERF_MODE" != off ] && command -v perf >/dev/null 2>&1 &&
+    perf stat -x, -o /dev/null true 2>/dev/null; then
+    PERF=perf
+fi
+if [ "$PERF_MODE" = detailed ] && [ -z "$PERF" ]; then
+    echo "❌ --perf: perf is not installed or perf_event_paranoid forbids it" >&2
+    exit 1
+fi
+PERF_EVENTS=()
+PERF_REPORT=off
+if [ -n "$PERF" ]; then
+    PERF_REPORT=default
+fi
+if [ "$PERF_MODE" = detailed ]; then
+    PERF_EVENTS=(-d -d -e L1-icache-load-misses)
+    PERF_REPORT=detailed
+fi
+
+# --- CPU placement and frequency -----------------------------------------------
+
+# "1-3,6" -> "1 2 3 6"
+expand_cpus() {
+    local part
+    for part in ${1//,/ }; do
+        if [[ $part == *-* ]]; then
+            seq "${part%-*}" "${part#*-}"
+        else
+            echo "$part"
+        fi
+    done
+}
+
+# A cgroup or an outer taskset may leave only some CPUs, not all of them
+ALLOWED=$(awk '/^Cpus_allowed_list:/ { print $2 }' /proc/self/status 2>/dev/null || true)
+if [ -z "$ALLOWED" ]; then
+    ALLOWED="0-$(($(cpu_count) - 1))"
+fi
+if [ -n "${BENCH_CPUS:-}" ]; then
+    CPUS=$BENCH_CPUS
+else
+    # The allowed list without its first CPU, e.g. "2-5,8" -> "3-5,8"
+    first=${ALLOWED%%,*}
+    rest=${ALLOWED#"$first"}
+    rest=${rest#,}
+    if [[ $first == *-* ]] && [ $((${first%-*} + 1)) -lt "${first#*-}" ]; then
+        first="$((${first%-*} + 1))-${first#*-}"
+    elif [[ $first == *-* ]]; then
+        first=${first#*-}
+    else
+        first=
+    fi
+    CPUS=$first${first:+${rest:+,}}$rest
+    if [ -z "$CPUS" ]; then
+        CPUS=$ALLOWED  # a single CPU: share it rather than not run
+    fi
+fi
+PIN=()
+if command -v taskset >/dev/null 2>&1; then
+    PIN=(taskset -c "$CPUS")
+else
+    CPUS="unpinned"
+fi
+
+# Every sysfs file changed, with the value to put back
+RESTORE=()
+set_sysfs() {
+    local file=$1 value=$2
+    if [ -w "$file" ]; then
+        RESTORE+=("$file=$(cat "$file")")
+        echo "$value" >"$file" 2>/dev/null || return 1
+        return 0
+    fi
+    return 1
+}
+restore_sysfs() {
+    local entry
+    for entry in "${RESTORE[@]+"${RESTORE[@]}"}"; do
+        echo "${entry#*=}" >"${entry%%=*}" 2>/dev/null || true
+    done
+}
+
+FREQUENCY=()
+governors=0
+if [ "$CPUS" = unpinned ]; then
+    targets=$(expand_cpus "$ALLOWED")
+else
+    targets=$(expand_cpus "$CPUS")
+fi
+for cpu in $targets; do
+    if set_sysfs "/sys/devices/system/cpu/cpu$cpu/cpufreq/scaling_governor" performance; then
+        governors=$((governors + 1))
+    fi
+done
+if [ "$governors" -gt 0 ]; then
+    FREQUENCY+=("performance governor on $governors CPUs")
+fi
+if set_sysfs /sys/devices/system/cpu/intel_pstate/no_turbo 1 ||
+    set_sysfs /sys/devices/system/cpu/cpufreq/boost 0; then
+    FREQUENCY+=("turbo off")
+fi
+if [ ${#FREQUENCY[@]} -eq 0 ]; then
+    FREQUENCY=("unchanged (no writable cpufreq controls)")
+fi
+
+# --- Running ---------------------------------------------------------------------
+
+json_escape() {
+    local s=$1
+    s=${s//\\/\\\\}
+    s=${s//\"/\\\"}
+    s=${s//$'\t'/ }
+    printf '%s' "$s"
+}
+
+# Result lines from bench::report ("  name   value unit") and the section
+# headers above them, as a JSON array. The value is the last field in
+# bench::report's %.3f format; rows whose unit starts with another number
+# or "/" ("0.000 / 8") are skipped rather than guessed at.
+results_json() {
+    awk '
+        function esc(s) { gsub(/\\/, "\\\\", s); gsub(/"/, "\\\"", s); gsub(/\t/, " ", s); return s }
+        function reported(s) { return s ~ /^-?[0-9]+\.[0-9][0-9][0-9]$|^-?(nan|inf)$/ }
+        /^=== .* ===$/ { section = substr($0, 5, length($0) - 8); next }
+        /^  +[^ ]/ {
+            at = 0
+            for (i = NF; i > 1 && !at; --i) if (reported($i)) at = i
+            if (!at) next
+            value = $at
+            unit = ""
+            for (i = at + 1; i <= NF; ++i) unit = unit (i > at + 1 ? " " : "") $i
+            if (unit ~ /^[0-9\/]/) next
+            name = $1
+            for (i = 2; i < at; ++i) name = name " " $i
+            if (value ~ /nan|inf/) value = "null"
+            printf "%s\n        {\"section\": \"%s\", \"name\": \"%s\", \"value\": %s, \"unit\": \"%s\"}",
+                   (count++ ? "," : ""), esc(section), esc(name), value, esc(unit)
+        }
+        END { printf "%s", (count ? "\n      " : "") }
+    ' "$1"
+}
+
+# perf stat -x, lines ("value,unit,event,...") as a JSON object
+counters_json() {
+    awk -F, '
+        $1 ~ /^[0-9.]+$/ && $3 != "" {
+            printf "%s\"%s\": %s", (count++ ? ", " : ""), $3, $1
+        }
+    ' "$1"
+}
+
+TMP=$(mktemp -d)
+trap 'restore_sysfs; rm -rf "$TMP"' EXIT
+
+echo "📌 CPUs: $CPUS; frequency: $(IFS=,; echo "${FREQUENCY[*]}")"
+echo "📊 perf: $PERF_REPORT"
+entries=()
+failures=0
+while read -r name args; do
+    if [ ${#SELECTED[@]} -gt 0 ] && [[ ! " ${SELECTED[*]} " =~ " $name " ]]; then
+        continue
+    fi
+    if [ "$QUICK" = 0 ]; then
+        args=""
+    fi
+    exe="$BUILD_DIR/day1/$name"
+    echo "▶️ $name $args"
+    cmd=("${PIN[@]+"${PIN[@]}"}")
+    if [ -n "$PERF" ]; then
+        cmd+=(perf stat -x, -o "$TMP/$name.perf" "${PERF_EVENTS[@]+"${PERF_EVENTS[@]}"}" --)
+    fi
+    start=$(now_ns)
+    status=0
+    # shellcheck disable=SC2086 # args is a list of words
+    "${cmd[@]+"${cmd[@]}"}" "$exe" $args </dev/null >"$TMP/$name.out" 2>"$TMP/$name.err" || status=$?
+    end=$(now_ns)
+    if [ "$status" != 0 ]; then
+        failures=$((failures + 1))
+        echo "❌ $name exited with $status" >&2
+        sed 's/^/    /' "$TMP/$name.err" >&2
+    fi
+    counters="{}"
+    if [ -n "$PERF" ] && [ -f "$TMP/$name.perf" ]; then
+        counters="{$(counters_json "$TMP/$name.perf")}"
+    fi
+    arg_list=""
+    for a in $args; do
+        arg_list+="${arg_list:+, }\"$(json_escape "$a")\""
+    done
+    entries+=("    {
+      \"name\": \"$name\",
+      \"args\": [$arg_list],
+      \"exit_code\": $status,
+      \"wall_ms\": $(((end - start) / 1000000)),
+      \"counters\": $counters,
+      \"results\": [$(results_json "$TMP/$name.out")]
+    }")
+done <"$MANIFEST"
+
+{
+    echo "{"
+    echo "  \"generated\": \"$(date -u +%Y-%m-%dT%H:%M:%SZ)\","
+    echo "  \"host\": \"$(json_escape "$(uname -n)")\","
+    echo "  \"cpu\": \"$(json_escape "$(sed -n 's/^model name[[:space:]]*: //p' /proc/cpuinfo 2>/dev/null | head -1)")\","
+    echo "  \"compiler\": \"$(json_escape "$(sed -n 's/^CMAKE_CXX_COMPILER:[A-Z]*=//p' "$BUILD_DIR/CMakeCache.txt")")\","
+    echo "  \"build_dir\": \"$(json_escape "$BUILD_DIR")\","
+    echo "  \"build_type\": \"$(json_escape "$BUILD_TYPE")\","
+    echo "  \"workload\": \"$([ "$QUICK" = 1 ] && echo quick || echo default)\","
+    echo "  \"cpus\": \"$CPUS\","
+    echo "  \"frequency\": \"$(json_escape "$(IFS=,; echo "${FREQUENCY[*]}")")\","
+    echo "  \"perf\": \"$PERF_REPORT\","
+    echo "  \"benchmarks\": ["
+    for i in "${!entries[@]}"; do
+        printf '%s%s\n' "${entries[$i]}" "$([ "$i" -lt $((${#entries[@]} - 1)) ] && echo ,)"
+    done
+    echo "  ]"
+    echo "}"
+} >"$OUT"
+
+echo "✅ ${#entries[@]} benchmarks, $failures failed; report in $OUT"
+[ "$failures" = 0 ]
@@ -0,0 +1,42 @@
+# Shell helpers shared by the benchmark scripts; source, don't run
+#
+# Only POSIX tools and bash 3.2 (what macOS ships): `date +%s%N` and
+# `nproc` are GNU coreutils, and $EPOCHREALTIME needs bash 5.
+
+# Monotonic time in nanoseconds. perl starts in a few milliseconds, so it
+# is preferred over python3; without either, whole seconds from date.
+if perl -MTime::HiRes=clock_gettime,CLOCK_MONOTONIC -e 1 2>/dev/null; then
+    now_ns() {
+        perl -MTime::HiRes=clock_gettime,CLOCK_MONOTONIC \
+            -e 'printf "%.0f\n", clock_gettime(CLOCK_MONOTONIC) * 1e9'
+    }
+elif python3 -c 'import time; time.monotonic_ns()' 2>/dev/null; then
+    now_ns() {
+        python3 -c 'import time; print(time.monotonic_ns())'
+    }
+else
+    echo "⚠️ Neither perl Time::HiRes nor python3 found; timing to the second" >&2
+    now_ns() {
+        echo "$(date +%s)000000000"
+    }
+fi
+
+# Number of online CPUs
+cpu_count() {
+    nproc 2>/dev/null || getconf _NPROCESSORS_ONLN
+}
+
+# Best wall time of three runs of a command in milliseconds
+run_ms() {
+    local start end ms best=0
+    for _ in 1 2 3; do
+        start=$(now_ns)
+        "$@" </dev/null >/dev/null
+        end=$(now_ns)
+        ms=$(((end - start) / 1000000))
+        if [ "$best" = 0 ] || [ "$ms" -lt "$best" ]; then
+            best=$ms
+        fi
+    done
+    echo "$best"
+}
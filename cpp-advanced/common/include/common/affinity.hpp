@@ -0,0 +1,41 @@
+// common/include/common/affinity.hpp
+// CPU affinity: which CPUs a thread may run on, and pinning it to one
+//
+// A pinned thread keeps its caches and branch history warm and is never
+// migrated mid-measurement; pinning one worker per CPU also keeps a pool
+// from oversubscribing cores that taskset or a cgroup took away:
+//
+//     auto cpus = common::allowed_cpus();
+//     common::pin_current_thread(cpus.back());
+//
+// Linux only. Elsewhere allowed_cpus() lists 0..hardware_threads()-1, pin
+// calls return false and current_cpu() returns -1, so callers can treat
+// pinning as a best-effort hint.
+
+#pragma once
+
+#include <thread>
+#include <vector>
+
+namespace common {
+
+// std::thread::hardware_concurrency(), never 0
+unsigned hardware_threads();
+
+// CPUs this process may run on, ascending: the affinity mask it started
+// with, so pinning threads later does not shrink it
+std::vector<int> allowed_cpus();
+
+// Restrict the calling thread to one CPU; false if the CPU is not allowed
+bool pin_current_thread(int cpu);
+
+// Same for another thread, e.g. right after constructing it
+bool pin_thread(std::thread &thread, int cpu);
+
+// Allow the calling thread on every CPU in allowed_cpus() again
+bool unpin_current_thread();
+
+// CPU the calling thread is running on right now, or -1 if unknown
+int current_cpu();
+
+}  // namespace common
@@ -0,0 +1,122 @@
+// common/include/common/aligned.hpp
+// Over-aligned heap memory: raw blocks, an allocator and owning arrays
+//
+// SIMD loads are fastest on 32/64-byte boundaries and per-thread buffers
+// should not share their first or last cache line with a neighbour, but
+// std::allocator only promises alignof(std::max_align_t), usually 16:
+//
+//     common::aligned_vector<float> samples(n);            // 64-byte aligned
+//     auto scratch = common::make_aligned_array<double>(n, 4096);
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "common/cache_line.hpp"
+
+namespace common {
+
+// alignment must be a power of two; throws std::bad_alloc on failure.
+// Release with aligned_free.
+inline void *aligned_allocate(std::size_t bytes, std::size_t alignment) {
+    if (alignment < alignof(void *)) {
+        alignment = alignof(void *);
+    }
+    if ((alignment & (alignment - 1)) != 0) {
+        throw std::bad_alloc();
+    }
+    // std::aligned_alloc wants a size that is a multiple of the alignment
+    const std::size_t rounded = (bytes + alignment - 1) & ~(alignment - 1);
+    if (rounded < bytes) {
+        throw std::bad_alloc();
+    }
+    void *memory = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+inline void aligned_free(void *memory) noexcept {
+    std::free(memory);
+}
+
+template <typename T, std::size_t Align = kCacheLine>
+class AlignedAllocator {
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0,
+                  "AlignedAllocator alignment must be a power of two at least alignof(T)");
+
+   public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(aligned_allocate(n * sizeof(T), Align));
+    }
+
+    void deallocate(T *p, std::size_t) noexcept {
+        aligned_free(p);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align> &) const noexcept {
+        return true;
+    }
+};
+
+template <typename T, std::size_t Align = kCacheLine>
+using aligned_vector = std::vector<T, AlignedAllocator<T, Align>>;
+
+// Destroys the elements and frees the block of an aligned array
+template <typename T>
+struct AlignedArrayDeleter {
+    std::size_t count = 0;
+
+    void operator()(T *p) const noexcept {
+        std::destroy_n(p, count);
+        aligned_free(p);
+    }
+};
+
+template <typename T>
+using aligned_array = std::unique_ptr<T[], AlignedArrayDeleter<T>>;
+
+// n value-initialized elements on an `alignment`-byte boundary
+template <typename T>
+aligned_array<T> make_aligned_array(std::size_t n, std::size_t alignment = kCacheLine) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    if (alignment < alignof(T)) {
+        alignment = alignof(T);
+    }
+    T *p = static_cast<T *>(aligned_allocate(n * sizeof(T), alignment));
+    try {
+        std::uninitialized_value_construct_n(p, n);
+    } catch (...) {
+        aligned_free(p);
+        throw;
+    }
+    return aligned_array<T>(p, AlignedArrayDeleter<T>{n});
+}
+
+}  // namespace common
@@ -0,0 +1,49 @@
+// common/include/common/cache_line.hpp
+// Cache-line size and padding that keeps hot values on lines of their own
+//
+// Two threads writing different variables on one cache line still bounce
+// the line between their cores (false sharing). Wrapping each per-thread
+// counter in CachePadded gives it a whole line:
+//
+//     std::vector<common::CachePadded<std::atomic<long>>> hits(threads);
+//     hits[t]->fetch_add(1, std::memory_order_relaxed);
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace common {
+
+// std::hardware_destructive_interference_size would be the portable
+// spelling, but GCC warns that it varies with -mtune, which would make it
+// an ABI hazard across translation units. 64 bytes holds for every x86-64
+// core. Apple M-series lines are 128 bytes; use CachePadded<T, 128> there.
+inline constexpr std::size_t kCacheLine = 64;
+
+template <typename T, std::size_t Align = kCacheLine>
+struct alignas(Align) CachePadded {
+    static_assert(Align % kCacheLine == 0, "CachePadded alignment must be whole cache lines");
+
+    T value;
+
+    CachePadded() = default;
+
+    template <typename... Args>
+    explicit CachePadded(std::in_place_t, Args &&...args) : value(std::forward<Args>(args)...) {}
+
+    T &operator*() {
+        return value;
+    }
+    const T &operator*() const {
+        return value;
+    }
+    T *operator->() {
+        return &value;
+    }
+    const T *operator->() const {
+        return &value;
+    }
+};
+
+}  // namespace common
@@ -0,0 +1,84 @@
+// common/include/common/thread_pool.hpp
+// Fixed-size FIFO thread pool for independent tasks
+//
+// Workers take tasks from one shared queue in submission order. That suits
+// coarse, independent jobs (one file per task, one request per task); for
+// recursive fork-join work use day1::WorkStealingPool, whose per-worker
+// deques avoid contention on a single queue.
+//
+//     common::ThreadPool pool;                       // one worker per allowed CPU
+//     auto size = pool.submit([&] { return load(path).size(); });
+//     pool.wait_idle();
+//     use(size.get());                               // rethrows the task's exception
+//
+// With ThreadPool::Options::pin_workers, worker i is pinned to the i-th CPU
+// in allowed_cpus() (wrapping around), which keeps measurements stable.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+class ThreadPool {
+   public:
+    struct Options {
+        // 0: one worker per CPU in allowed_cpus()
+        std::size_t threads = 0;
+        bool pin_workers = false;
+    };
+
+   private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable idle_;
+    std::size_t running_ = 0;
+    bool stopping_ = false;
+
+    void worker_loop();
+    void enqueue(std::function<void()> task);
+
+   public:
+    ThreadPool();
+    explicit ThreadPool(Options options);
+    // Runs every task already queued, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    // Queue f(args...); the future carries its result or exception
+    template <typename F, typename... Args>
+    auto submit(F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>> {
+        using R = std::invoke_result_t<F, Args...>;
+        // std::function needs a copyable target, so share the task
+        auto task = std::make_shared<std::packaged_task<R()>>(
+            [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable {
+                return std::invoke(std::move(f), std::move(args)...);
+            });
+        std::future<R> result = task->get_future();
+        enqueue([task] { (*task)(); });
+        return result;
+    }
+
+    // Block until the queue is empty and no task is running
+    void wait_idle();
+};
+
+}  // namespace common
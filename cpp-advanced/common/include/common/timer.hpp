@@ -0,0 +1,117 @@
+// common/include/common/timer.hpp
+// Wall-clock stopwatches and calibrated cycle-counter timing
+//
+// Stopwatch wraps std::chrono::steady_clock, good to ~20-50ns per read.
+// For timing a few hundred instructions, read the time-stamp counter
+// instead (rdtsc on x86-64, cntvct_el0 on arm64) and convert ticks with the
+// rate measured once against steady_clock:
+//
+//     auto t0 = common::cycle_count();
+//     kernel();
+//     double ns = common::ticks_to_ns(common::cycle_count() - t0);
+//
+// The counter ticks at a fixed rate on CPUs with an invariant TSC (check
+// has_invariant_tsc()), independent of turbo and frequency scaling, so a
+// tick is a unit of time, not a core clock cycle.
+//
+//     {
+//         common::ScopedTimer t("rebuild index");  // prints "rebuild index: 12.3 ms"
+//         rebuild();
+//     }
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace common {
+
+using Clock = std::chrono::steady_clock;
+
+class Stopwatch {
+   private:
+    Clock::time_point start_ = Clock::now();
+
+   public:
+    void reset() {
+        start_ = Clock::now();
+    }
+
+    Clock::duration elapsed() const {
+        return Clock::now() - start_;
+    }
+
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(elapsed()).count();
+    }
+
+    double elapsed_us() const {
+        return std::chrono::duration<double, std::micro>(elapsed()).count();
+    }
+};
+
+// Raw counter read. Not serializing: the CPU may move it across nearby
+// instructions, which only matters for spans of a few dozen cycles.
+inline std::uint64_t cycle_count() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+            .count());
+#endif
+}
+
+// Waits for every earlier instruction to finish before reading; use at the
+// end of a timed region
+inline std::uint64_t cycle_count_ordered() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned aux;
+    return __rdtscp(&aux);
+#elif defined(__aarch64__)
+    asm volatile("isb" ::: "memory");
+    return cycle_count();
+#else
+    return cycle_count();
+#endif
+}
+
+// Counter ticks per nanosecond, measured against steady_clock on first
+// use (about 30ms, once per process)
+double ticks_per_ns();
+
+inline double ticks_to_ns(std::uint64_t ticks) {
+    return static_cast<double>(ticks) / ticks_per_ns();
+}
+
+// True when the counter rate does not follow the core clock (CPUID
+// 0x80000007 EDX bit 8 on x86-64; always true for the arm64 generic timer)
+bool has_invariant_tsc();
+
+// Prints "<label>: <ms> ms" to `out` when it goes out of scope
+class ScopedTimer {
+   private:
+    std::string label_;
+    std::ostream &out_;
+    Stopwatch watch_;
+
+   public:
+    explicit ScopedTimer(std::string label);
+    ScopedTimer(std::string label, std::ostream &out);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
+
+}  // namespace common
@@ -0,0 +1,121 @@
+// common/lib/affinity.cpp
+// Linux affinity calls behind common/affinity.hpp
+
+#include "common/affinity.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace common {
+
+unsigned hardware_threads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+// Linux masks are per thread, so once a thread is pinned its own mask no
+// longer says what the process may use. Read the main thread's mask (which
+// taskset and cgroup cpusets narrow) during static initialization instead.
+struct StartupMask {
+    cpu_set_t set;
+    bool valid;
+
+    StartupMask() {
+        CPU_ZERO(&set);
+        valid = sched_getaffinity(0, sizeof set, &set) == 0;
+    }
+};
+
+const StartupMask startup_mask;
+
+bool process_mask(cpu_set_t &set) {
+    set = startup_mask.set;
+    return startup_mask.valid;
+}
+
+bool pin(pthread_t thread, int cpu) {
+    cpu_set_t allowed;
+    if (cpu < 0 || cpu >= CPU_SETSIZE || !process_mask(allowed) || !CPU_ISSET(cpu, &allowed)) {
+        return false;
+    }
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(cpu, &one);
+    return pthread_setaffinity_np(thread, sizeof one, &one) == 0;
+}
+
+}  // namespace
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    if (process_mask(set)) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (cpus.empty()) {
+        for (unsigned cpu = 0; cpu < hardware_threads(); ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+bool pin_current_thread(int cpu) {
+    return pin(pthread_self(), cpu);
+}
+
+bool pin_thread(std::thread &thread, int cpu) {
+    return pin(thread.native_handle(), cpu);
+}
+
+bool unpin_current_thread() {
+    cpu_set_t set;
+    if (!process_mask(set)) {
+        return false;
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof set, &set) == 0;
+}
+
+int current_cpu() {
+    return sched_getcpu();
+}
+
+#else
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+    for (unsigned cpu = 0; cpu < hardware_threads(); ++cpu) {
+        cpus.push_back(static_cast<int>(cpu));
+    }
+    return cpus;
+}
+
+bool pin_current_thread(int) {
+    return false;
+}
+
+bool pin_thread(std::thread &, int) {
+    return false;
+}
+
+bool unpin_current_thread() {
+    return false;
+}
+
+int current_cpu() {
+    return -1;
+}
+
+#endif
+
+}  // namespace common
@@ -0,0 +1,69 @@
+// common/lib/thread_pool.cpp
+// Worker threads and queue of common::ThreadPool
+
+#include "common/thread_pool.hpp"
+
+#include "common/affinity.hpp"
+
+namespace common {
+
+ThreadPool::ThreadPool() : ThreadPool(Options{}) {}
+
+ThreadPool::ThreadPool(Options options) {
+    const std::vector<int> cpus = allowed_cpus();
+    const std::size_t count = options.threads != 0 ? options.threads : cpus.size();
+    workers_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+        if (options.pin_workers) {
+            pin_thread(workers_.back(), cpus[i % cpus.size()]);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    work_ready_.notify_one();
+}
+
+void ThreadPool::wait_idle() {
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return queue_.empty() && running_ == 0; });
+}
+
+void ThreadPool::worker_loop() {
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        work_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;  // stopping, and nothing left to drain
+        }
+        std::function<void()> task = std::move(queue_.front());
+        queue_.pop_front();
+        ++running_;
+        lock.unlock();
+        // packaged_task stores any exception in the future
+        task();
+        lock.lock();
+        --running_;
+        if (queue_.empty() && running_ == 0) {
+            idle_.notify_all();
+        }
+    }
+}
+
+}  // namespace common
@@ -0,0 +1,80 @@
+// common/lib/timer.cpp
+// Time-stamp counter calibration and ScopedTimer output
+
+#include "common/timer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace common {
+
+namespace {
+
+// Ticks per ns over one busy-wait of `span`. Each counter read sits next
+// to the clock read that bounds the span; a preemption between the two
+// skews only this run, which calibrate() discards by taking the median
+double measure_rate(std::chrono::microseconds span) {
+    const std::uint64_t c0 = cycle_count_ordered();
+    const auto t0 = Clock::now();
+    auto t1 = t0;
+    while (t1 - t0 < span) {
+        t1 = Clock::now();
+    }
+    const std::uint64_t c1 = cycle_count_ordered();
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return static_cast<double>(c1 - c0) / ns;
+}
+
+double calibrate() {
+    // Median of five short runs shrugs off one run that got descheduled
+    std::array<double, 5> rates{};
+    for (auto &rate : rates) {
+        rate = measure_rate(std::chrono::microseconds(6000));
+    }
+    std::sort(rates.begin(), rates.end());
+    return rates[rates.size() / 2];
+}
+
+}  // namespace
+
+double ticks_per_ns() {
+    static const double rate = calibrate();
+    return rate;
+}
+
+bool has_invariant_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+        return false;
+    }
+    __cpuid(0x80000007, eax, ebx, ecx, edx);
+    return (edx & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+ScopedTimer::ScopedTimer(std::string label) : ScopedTimer(std::move(label), std::cout) {}
+
+ScopedTimer::ScopedTimer(std::string label, std::ostream &out)
+    : label_(std::move(label)), out_(out) {}
+
+ScopedTimer::~ScopedTimer() {
+    const auto flags = out_.flags();
+    const auto precision = out_.precision();
+    out_ << label_ << ": " << std::fixed << std::setprecision(3) << watch_.elapsed_ms() << " ms\n";
+    out_.flags(flags);
+    out_.precision(precision);
+}
+
+}  // namespace common
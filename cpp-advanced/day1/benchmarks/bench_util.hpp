@@ -0,0 +1,90 @@
+// day1/benchmarks/bench_util.hpp
+// Small timing and reporting helpers shared by the Day 1 benchmarks
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "common/timer.hpp"
+
+namespace bench {
+
+using Clock = common::Clock;
+
+// Run f once and return the elapsed wall time in milliseconds
+template <typename F>
+double time_ms(F &&f) {
+    common::Stopwatch watch;
+    f();
+    return watch.elapsed_ms();
+}
+
+// Best of `reps` runs; the minimum is the least noisy estimate on a busy box
+template <typename F>
+double best_of_ms(int reps, F &&f) {
+    double best = time_ms(f);
+    for (int i = 1; i < reps; ++i) {
+        best = std::min(best, time_ms(f));
+    }
+    return best;
+}
+
+// Keep the compiler from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Parse counts like "1000000", "10M", "1B" or "64K"
+inline std::size_t parse_count(std::string_view text) {
+    std::size_t multiplier = 1;
+    if (!text.empty()) {
+        switch (text.back()) {
+            case 'K':
+            case 'k':
+                multiplier = 1'000;
+                break;
+            case 'M':
+            case 'm':
+                multiplier = 1'000'000;
+                break;
+            case 'B':
+            case 'b':
+            case 'G':
+            case 'g':
+                multiplier = 1'000'000'000;
+                break;
+        }
+        if (multiplier != 1) {
+            text.remove_suffix(1);
+        }
+    }
+    return std::strtoull(std::string(text).c_str(), nullptr, 10) * multiplier;
+}
+
+// Positional count argument with a default, e.g. `./bench 10M`
+inline std::size_t arg_count(int argc, char **argv, int index, std::size_t fallback) {
+    return index < argc ? parse_count(argv[index]) : fallback;
+}
+
+inline void print_header(std::string_view title) {
+    std::cout << "\n=== " << title << " ===\n";
+}
+
+inline void report(std::string_view name, double value, std::string_view unit) {
+    std::printf("  %-52.*s %12.3f %s\n", static_cast<int>(name.size()), name.data(), value,
+                std::string(unit).c_str());
+}
+
+inline void report_speedup(std::string_view name, double baseline_ms, double ms) {
+    report(name, ms > 0.0 ? baseline_ms / ms : 0.0, "x");
+}
+
+}  // namespace bench
@@ -0,0 +1,145 @@
+// day1/benchmarks/bloom_filter_bench.cpp
+// Filter-then-container lookups vs container-only lookups
+//
+// Usage: bloom_filter_bench [keys=1M]
+//
+// Probes are string_views (heterogeneous lookup) mixed at several hit
+// rates. A miss the filter rejects skips the container entirely; hits and
+// false positives pay for both, so the gain depends on how often lookups
+// miss and how expensive a container miss is.
+
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "bloom_filter.hpp"
+#include "flat_hash_map.hpp"
+
+namespace {
+
+std::string make_word(std::mt19937_64 &rng) {
+    static constexpr std::string_view kLetters = "abcdefghijklmnopqrstuvwxyz";
+    std::string word(8 + rng() % 16, ' ');
+    for (auto &ch : word) {
+        ch = kLetters[rng() % kLetters.size()];
+    }
+    return word;
+}
+
+// Probes with the requested fraction of stored words, shuffled
+std::vector<std::string_view> make_probes(const std::vector<std::string> &stored,
+                                          const std::vector<std::string> &missing,
+                                          double hit_rate, std::mt19937_64 &rng) {
+    std::vector<std::string_view> probes(stored.size());
+    std::bernoulli_distribution hit(hit_rate);
+    for (auto &probe : probes) {
+        probe = hit(rng) ? stored[rng() % stored.size()] : missing[rng() % missing.size()];
+    }
+    return probes;
+}
+
+template <typename Container, typename Filter>
+void run_lookups(const char *name, const Container &container, const Filter &filter,
+                 const std::vector<std::string_view> &probes) {
+    const double n = static_cast<double>(probes.size());
+    std::size_t found = 0;
+    double plain_ms = bench::best_of_ms(3, [&] {
+        for (auto probe : probes) {
+            found += container.find(probe) != container.end();
+        }
+    });
+    std::size_t filtered_found = 0;
+    double filtered_ms = bench::best_of_ms(3, [&] {
+        for (auto probe : probes) {
+            filtered_found += filter.contains(probe) && container.find(probe) != container.end();
+        }
+    });
+    if (found != filtered_found) {
+        throw std::runtime_error("Bloom filter produced a false negative");
+    }
+    bench::report(std::string(name) + " only", plain_ms * 1e6 / n, "ns/op");
+    bench::report(std::string(name) + " behind filter", filtered_ms * 1e6 / n, "ns/op");
+    bench::report_speedup(std::string(name) + " filtered vs plain", plain_ms, filtered_ms);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 1'000'000);
+    std::mt19937_64 rng(11);
+    std::vector<std::string> stored(n);
+    for (auto &w : stored) {
+        w = make_word(rng) + "+";  // '+' keeps stored and missing words disjoint
+    }
+    std::vector<std::string> missing(n);
+    for (auto &w : missing) {
+        w = make_word(rng) + "-";
+    }
+
+    std::set<std::string, std::less<>> tree(stored.begin(), stored.end());
+    std::unordered_set<std::string, day1::string_hash, std::equal_to<>> hashed(stored.begin(),
+                                                                              stored.end());
+    day1::flat_hash_set<std::string> flat(stored.begin(), stored.end());
+
+    bench::print_header("filter sizing, " + std::to_string(n) + " keys");
+    for (double target : {0.1, 0.01, 0.001}) {
+        day1::BlockedBloomFilter<std::string> filter(n, target);
+        double build_ms = bench::time_ms([&] {
+            for (const auto &w : stored) {
+                filter.insert(w);
+            }
+        });
+        std::size_t false_positives = 0;
+        double query_ms = bench::time_ms([&] {
+            for (const auto &w : missing) {
+                false_positives += filter.contains(std::string_view(w));
+            }
+        });
+        const std::string tag = "fpr " + std::to_string(target).substr(0, 5);
+        bench::report(tag + ": bits per key",
+                      static_cast<double>(filter.memory_bytes() * 8) / static_cast<double>(n), "");
+        bench::report(tag + ": measured false-positive rate",
+                      static_cast<double>(false_positives) / static_cast<double>(n), "");
+        bench::report(tag + ": insert", build_ms * 1e6 / static_cast<double>(n), "ns/op");
+        bench::report(tag + ": query (miss)", query_ms * 1e6 / static_cast<double>(n), "ns/op");
+    }
+
+    day1::BlockedBloomFilter<std::string> filter(n, 0.01);
+    day1::CountingBloomFilter<std::string> counting(n, 0.01);
+    for (const auto &w : stored) {
+        filter.insert(w);
+        counting.insert(w);
+    }
+    for (double hit_rate : {0.01, 0.1, 0.5, 0.9}) {
+        auto probes = make_probes(stored, missing, hit_rate, rng);
+        bench::print_header("lookups at " + std::to_string(static_cast<int>(hit_rate * 100)) +
+                            "% hits, 1% filter");
+        run_lookups("std::set", tree, filter, probes);
+        run_lookups("std::unordered_set", hashed, filter, probes);
+        run_lookups("day1::flat_hash_set", flat, filter, probes);
+        run_lookups("std::set (counting filter)", tree, counting, probes);
+    }
+
+    bench::print_header("serialization");
+    const auto path = std::filesystem::temp_directory_path() / "day1_bloom_bench.bin";
+    double save_ms = bench::time_ms([&] { filter.save(path.string()); });
+    std::size_t reloaded_hits = 0;
+    double load_ms = bench::time_ms([&] {
+        auto loaded = day1::BlockedBloomFilter<std::string>::load(path.string());
+        for (const auto &w : stored) {
+            reloaded_hits += loaded.contains(w);
+        }
+    });
+    std::filesystem::remove(path);
+    bench::report("save", save_ms, "ms");
+    bench::report("load + verify every key", load_ms, "ms");
+    bench::report("file size", static_cast<double>(filter.memory_bytes()) / (1 << 20), "MB");
+    return reloaded_hits == n ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// day1/benchmarks/btree_map_bench.cpp
+// day1::btree_map vs std::map: build, point lookups, range scans, erase
+//
+// Usage: btree_map_bench [keys=10M]
+// 10M uint64 -> uint64 entries need ~0.8GB on the std::map side.
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "btree_map.hpp"
+
+namespace {
+
+struct Workload {
+    std::vector<std::uint64_t> keys;     // insertion order (random)
+    std::vector<std::uint64_t> hits;     // lookups of stored keys
+    std::vector<std::uint64_t> misses;   // lookups of absent keys
+    std::vector<std::uint64_t> starts;   // range-scan start keys
+};
+
+Workload make_workload(std::size_t n) {
+    Workload w;
+    std::mt19937_64 rng(99);
+    w.keys.resize(n);
+    for (auto &k : w.keys) {
+        k = rng() | 1;  // stored keys are odd, misses even
+    }
+    const std::size_t lookups = std::min<std::size_t>(n, 2'000'000);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        w.hits.push_back(w.keys[rng() % n]);
+        w.misses.push_back(rng() & ~std::uint64_t{1});
+    }
+    for (std::size_t i = 0; i < 1000; ++i) {
+        w.starts.push_back(rng());
+    }
+    return w;
+}
+
+template <typename Map>
+void run_suite(const char *name, const Workload &w) {
+    const double n = static_cast<double>(w.keys.size());
+    const double lookups = static_cast<double>(w.hits.size());
+    std::string label = name;
+    Map map;
+    double insert_ms = bench::time_ms([&] {
+        for (auto k : w.keys) {
+            map.try_emplace(k, k);
+        }
+    });
+    bench::report(label + " insert (random order)", insert_ms * 1e6 / n, "ns/op");
+
+    std::uint64_t sum = 0;
+    double hit_ms = bench::time_ms([&] {
+        for (auto k : w.hits) {
+            sum += (*map.find(k)).second;
+        }
+    });
+    double miss_ms = bench::time_ms([&] {
+        for (auto k : w.misses) {
+            sum += map.find(k) != map.end();
+        }
+    });
+    bench::report(label + " find (hit)", hit_ms * 1e6 / lookups, "ns/op");
+    bench::report(label + " find (miss)", miss_ms * 1e6 / lookups, "ns/op");
+
+    for (std::size_t length : {16, 1000, 100'000}) {
+        std::size_t visited = 0;
+        double scan_ms = bench::time_ms([&] {
+            for (auto start : w.starts) {
+                auto it = map.lower_bound(start);
+                for (std::size_t i = 0; i < length && it != map.end(); ++i, ++it) {
+                    sum += (*it).second;
+                    ++visited;
+                }
+            }
+        });
+        bench::report(label + " range scan of " + std::to_string(length),
+                      scan_ms * 1e6 / static_cast<double>(std::max<std::size_t>(1, visited)),
+                      "ns/elem");
+    }
+    double full_ms = bench::time_ms([&] {
+        for (const auto &kv : map) {
+            sum += kv.second;
+        }
+    });
+    bench::report(label + " full iteration", full_ms * 1e6 / n, "ns/elem");
+
+    double erase_ms = bench::time_ms([&] {
+        for (std::size_t i = 0; i < w.keys.size(); i += 2) {
+            map.erase(w.keys[i]);
+        }
+    });
+    bench::report(label + " erase half", erase_ms * 1e6 / (n / 2), "ns/op");
+    bench::do_not_optimize(sum);
+}
+
+template <std::size_t NodeBytes>
+void run_bulk(const Workload &w, std::vector<std::pair<std::uint64_t, std::uint64_t>> &sorted) {
+    using Map = day1::btree_map<std::uint64_t, std::uint64_t, std::less<>, NodeBytes>;
+    const std::string label = "btree<" + std::to_string(NodeBytes) + "B>";
+    Map map;
+    double build_ms = bench::time_ms([&] {
+        map = Map(day1::sorted_unique, sorted.begin(), sorted.end());
+    });
+    std::uint64_t sum = 0;
+    double hit_ms = bench::time_ms([&] {
+        for (auto k : w.hits) {
+            sum += (*map.find(k)).second;
+        }
+    });
+    double scan_ms = bench::time_ms([&] {
+        for (const auto &kv : map) {
+            sum += kv.second;
+        }
+    });
+    const double n = static_cast<double>(sorted.size());
+    bench::report(label + " bulk load (sorted)", build_ms * 1e6 / n, "ns/elem");
+    bench::report(label + " find (hit), height " + std::to_string(map.height()),
+                  hit_ms * 1e6 / static_cast<double>(w.hits.size()), "ns/op");
+    bench::report(label + " full iteration", scan_ms * 1e6 / n, "ns/elem");
+    bench::do_not_optimize(sum);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 10'000'000);
+    Workload w = make_workload(n);
+
+    bench::print_header("std::map<uint64, uint64>, " + std::to_string(n) + " keys");
+    run_suite<std::map<std::uint64_t, std::uint64_t>>("std::map", w);
+
+    bench::print_header("day1::btree_map<uint64, uint64> (512B nodes)");
+    run_suite<day1::btree_map<std::uint64_t, std::uint64_t>>("btree_map", w);
+
+    // Node size trades search depth against bytes touched per node
+    bench::print_header("bulk load and node size");
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> sorted;
+    sorted.reserve(n);
+    for (auto k : w.keys) {
+        sorted.emplace_back(k, k);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                             [](const auto &a, const auto &b) { return a.first == b.first; }),
+                 sorted.end());
+    run_bulk<256>(w, sorted);
+    run_bulk<512>(w, sorted);
+    run_bulk<1024>(w, sorted);
+    run_bulk<4096>(w, sorted);
+    return 0;
+}
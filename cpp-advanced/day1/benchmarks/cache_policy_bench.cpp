@@ -0,0 +1,146 @@
+// day1/benchmarks/cache_policy_bench.cpp
+// Trace replay: hit ratio and cost of LRU, W-TinyLFU and ARC
+//
+// Usage: cache_policy_bench [requests=1M] [trace_file]
+//
+// Each trace is replayed through ResourceManager with each policy at a
+// fixed entry capacity. Built-in traces:
+//
+//   - zipf: skewed requests (s = 0.9) over 20K assets, capacity 1K
+//   - zipf + scans: the same, interrupted every 50K requests by a pass
+//     over 20K assets that are never requested again (a level load)
+//   - loop: a cyclic pass over 1.2x capacity, which defeats LRU entirely
+//
+// A trace_file (one path per line, e.g. from an access log) is replayed
+// too, at capacities of 1% and 10% of its distinct paths.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "cache_policy.hpp"
+#include "resource_manager.hpp"
+
+namespace {
+
+struct Blob {
+    std::uint64_t id;
+};
+
+std::unique_ptr<Blob> load_blob(const std::string &path) {
+    return std::make_unique<Blob>(Blob{path.size()});
+}
+
+std::string asset(const char *kind, std::size_t i) {
+    return std::string("assets/") + kind + "_" + std::to_string(i) + ".bin";
+}
+
+std::vector<std::string> zipf_trace(std::size_t count, std::size_t keys, std::size_t scan_every,
+                                    std::size_t scan_length) {
+    std::vector<double> cdf(keys);
+    double sum = 0;
+    for (std::size_t i = 0; i < keys; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), 0.9);
+        cdf[i] = sum;
+    }
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> u(0.0, sum);
+    std::vector<std::string> trace;
+    trace.reserve(count);
+    std::size_t scanned = 0;
+    while (trace.size() < count) {
+        if (scan_every && trace.size() % scan_every == scan_every - 1) {
+            for (std::size_t i = 0; i < scan_length && trace.size() < count; ++i) {
+                trace.push_back(asset("scan", scanned++));
+            }
+            if (trace.size() == count) {
+                break;  // the scan filled the trace
+            }
+        }
+        const auto key = static_cast<std::size_t>(std::upper_bound(cdf.begin(), cdf.end(), u(rng)) -
+                                                  cdf.begin());
+        trace.push_back(asset("hot", std::min(key, keys - 1)));
+    }
+    return trace;
+}
+
+std::vector<std::string> loop_trace(std::size_t count, std::size_t keys) {
+    std::vector<std::string> trace;
+    trace.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        trace.push_back(asset("loop", i % keys));
+    }
+    return trace;
+}
+
+struct Result {
+    double hit_ratio;
+    double ns_per_op;
+};
+
+template <template <typename> class Policy>
+Result replay(const std::vector<std::string> &trace, std::size_t capacity) {
+    day1::ResourceManager<Blob, Policy> manager(capacity, load_blob);
+    std::uint64_t sink = 0;
+    double ms = bench::time_ms([&] {
+        for (const auto &path : trace) {
+            sink += manager.get(path)->id;
+        }
+    });
+    bench::do_not_optimize(sink);
+    return {manager.stats().hit_ratio(), ms * 1e6 / static_cast<double>(trace.size())};
+}
+
+void run(const std::string &name, const std::vector<std::string> &trace, std::size_t capacity) {
+    bench::print_header(name + ": " + std::to_string(trace.size()) + " requests, capacity " +
+                        std::to_string(capacity));
+    const Result lru = replay<day1::LruPolicy>(trace, capacity);
+    const Result tiny = replay<day1::WTinyLfuPolicy>(trace, capacity);
+    const Result arc = replay<day1::ArcPolicy>(trace, capacity);
+    bench::report("LRU: hit ratio", lru.hit_ratio, "");
+    bench::report("W-TinyLFU: hit ratio", tiny.hit_ratio, "");
+    bench::report("ARC: hit ratio", arc.hit_ratio, "");
+    bench::report("LRU: get()", lru.ns_per_op, "ns/op");
+    bench::report("W-TinyLFU: get()", tiny.ns_per_op, "ns/op");
+    bench::report("ARC: get()", arc.ns_per_op, "ns/op");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t requests = bench::arg_count(argc, argv, 1, 1'000'000);
+    constexpr std::size_t kCapacity = 1'000;
+
+    run("zipf", zipf_trace(requests, 20'000, 0, 0), kCapacity);
+    run("zipf + scans", zipf_trace(requests, 20'000, 50'000, 20'000), kCapacity);
+    run("loop", loop_trace(requests, kCapacity * 6 / 5), kCapacity);
+
+    if (argc > 2) {
+        std::ifstream in(argv[2]);
+        if (!in) {
+            std::cerr << "cannot open " << argv[2] << "\n";
+            return 1;
+        }
+        std::vector<std::string> trace;
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty()) {
+                trace.push_back(std::move(line));
+            }
+        }
+        const std::size_t distinct =
+            std::unordered_set<std::string>(trace.begin(), trace.end()).size();
+        for (std::size_t percent : {1, 10}) {
+            run(std::string(argv[2]) + " (" + std::to_string(percent) + "%)", trace,
+                std::max<std::size_t>(1, distinct * percent / 100));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+// day1/benchmarks/common_utils_bench.cpp
+// The common/ utilities: timer overhead, false sharing, pinned task pools
+//
+// Usage: common_utils_bench [ops=10M] [max_threads=8]
+//
+// Timers: the cost of one Stopwatch read against one counter read, and a
+// short kernel timed in counter ticks. False sharing: every thread bumps
+// its own counter, once with all counters packed into one cache line and
+// once with each in a CachePadded slot, threads pinned one per allowed CPU.
+// Task pools: independent small tasks through common::ThreadPool (unpinned
+// and pinned) and day1::WorkStealingPool.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "common/affinity.hpp"
+#include "common/aligned.hpp"
+#include "common/cache_line.hpp"
+#include "common/thread_pool.hpp"
+#include "common/timer.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace {
+
+constexpr int kReps = 3;
+
+// Runs body(t) on `threads` threads, thread t pinned to the t-th allowed CPU
+template <typename Body>
+void run_pinned(unsigned threads, const std::vector<int> &cpus, Body body) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            common::pin_current_thread(cpus[t % cpus.size()]);
+            body(t);
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+// Mops/s for `ops` increments split across `threads` counters
+template <typename Counter>
+double bump(unsigned threads, std::size_t ops, const std::vector<int> &cpus, Counter counter) {
+    const double ms = bench::best_of_ms(kReps, [&] {
+        run_pinned(threads, cpus, [&](unsigned t) {
+            const std::size_t share = ops / threads + (t < ops % threads);
+            for (std::size_t i = 0; i < share; ++i) {
+                counter(t).fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    });
+    return static_cast<double>(ops) / (ms * 1e3);
+}
+
+// Stand-in for one independent job: a few microseconds of arithmetic
+std::uint64_t small_task(std::uint64_t seed) {
+    std::uint64_t x = seed | 1;
+    for (int i = 0; i < 2000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t ops = bench::arg_count(argc, argv, 1, 10'000'000);
+    const std::size_t max_threads = bench::arg_count(argc, argv, 2, 8);
+    const std::vector<int> cpus = common::allowed_cpus();
+    const auto threads =
+        static_cast<unsigned>(std::clamp<std::size_t>(cpus.size(), 1, max_threads));
+    std::cout << "allowed CPUs: " << cpus.size() << ", invariant TSC: "
+              << common::has_invariant_tsc() << "\n";
+
+    bench::print_header("timers");
+    {
+        common::ScopedTimer timer("  counter calibration (once per process)");
+        common::ticks_per_ns();
+    }
+    const std::size_t reads = std::min<std::size_t>(ops, 1'000'000);
+    std::uint64_t sink = 0;
+    common::Stopwatch clock;
+    double ms = bench::best_of_ms(kReps, [&] {
+        for (std::size_t i = 0; i < reads; ++i) {
+            sink += static_cast<std::uint64_t>(clock.elapsed().count());
+        }
+    });
+    bench::report("Stopwatch::elapsed", ms * 1e6 / static_cast<double>(reads), "ns/read");
+    ms = bench::best_of_ms(kReps, [&] {
+        for (std::size_t i = 0; i < reads; ++i) {
+            sink += common::cycle_count();
+        }
+    });
+    bench::report("cycle_count", ms * 1e6 / static_cast<double>(reads), "ns/read");
+    ms = bench::best_of_ms(kReps, [&] {
+        for (std::size_t i = 0; i < reads; ++i) {
+            sink += common::cycle_count_ordered();
+        }
+    });
+    bench::report("cycle_count_ordered", ms * 1e6 / static_cast<double>(reads), "ns/read");
+
+    // Too short for a Stopwatch: the fastest of many tick-counted runs
+    common::aligned_vector<double> values(1024);
+    std::iota(values.begin(), values.end(), 1.0);
+    std::uint64_t best_ticks = UINT64_MAX;
+    for (int run = 0; run < 1000; ++run) {
+        const std::uint64_t t0 = common::cycle_count();
+        double sum = std::accumulate(values.begin(), values.end(), 0.0);
+        bench::do_not_optimize(sum);
+        best_ticks = std::min(best_ticks, common::cycle_count_ordered() - t0);
+    }
+    bench::report("sum of 1024 aligned doubles", common::ticks_to_ns(best_ticks), "ns");
+    bench::do_not_optimize(sink);
+
+    bench::print_header("false sharing, " + std::to_string(threads) + " pinned threads");
+    // One aligned block, so every counter lands on the same cache line
+    auto packed = common::make_aligned_array<std::atomic<std::uint64_t>>(threads);
+    std::vector<common::CachePadded<std::atomic<std::uint64_t>>> padded(threads);
+    const double packed_rate =
+        bump(threads, ops, cpus, [&](unsigned t) -> auto & { return packed[t]; });
+    const double padded_rate =
+        bump(threads, ops, cpus, [&](unsigned t) -> auto & { return *padded[t]; });
+    bench::report("packed counters", packed_rate, "Mops/s");
+    bench::report("CachePadded counters", padded_rate, "Mops/s");
+    bench::report("padding speedup", padded_rate / packed_rate, "x");
+
+    const std::size_t tasks = std::max<std::size_t>(1, ops / 100);
+    bench::print_header(std::to_string(tasks) + " independent tasks, " +
+                        std::to_string(threads) + " workers");
+    for (bool pin : {false, true}) {
+        common::ThreadPool pool({.threads = threads, .pin_workers = pin});
+        std::vector<std::future<std::uint64_t>> results;
+        results.reserve(tasks);
+        ms = bench::best_of_ms(kReps, [&] {
+            results.clear();
+            for (std::size_t i = 0; i < tasks; ++i) {
+                results.push_back(pool.submit(small_task, i));
+            }
+            pool.wait_idle();
+        });
+        for (auto &result : results) {
+            sink += result.get();
+        }
+        bench::report(pin ? "common::ThreadPool (pinned)" : "common::ThreadPool",
+                      ms * 1e6 / static_cast<double>(tasks), "ns/task");
+    }
+    {
+        day1::WorkStealingPool pool(threads);
+        std::vector<std::uint64_t> results(tasks);
+        ms = bench::best_of_ms(kReps, [&] {
+            day1::TaskGroup group(pool);
+            for (std::size_t i = 0; i < tasks; ++i) {
+                group.run([&results, i] { results[i] = small_task(i); });
+            }
+            group.wait();
+        });
+        sink += std::accumulate(results.begin(), results.end(), std::uint64_t{0});
+        bench::report("day1::WorkStealingPool", ms * 1e6 / static_cast<double>(tasks),
+                      "ns/task");
+    }
+    bench::do_not_optimize(sink);
+    return 0;
+}
@@ -0,0 +1,189 @@
+// day1/benchmarks/concurrent_resource_manager_bench.cpp
+// get() throughput: sharded ConcurrentResourceManager vs one global mutex
+//
+// Usage: concurrent_resource_manager_bench [ops=2M] [max_threads=64]
+//
+// 100K distinct paths, cache capacity 50K, skewed access (a small hot set
+// takes most requests, ~70% hits). The same total number of get() calls is
+// split across 1, 2, 4, ... max_threads threads. With fewer cores than
+// threads the upper rows show how each design copes with preemption
+// rather than parallel speedup.
+//
+// The thundering-herd rows release 32 threads at once onto the same cold
+// paths, with and without single-flight load sharing. The loader waits 1ms
+// like a disk read, then spends CPU time decoding 1MB.
+
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "concurrent_resource_manager.hpp"
+#include "resource_manager.hpp"
+
+namespace {
+
+struct Blob {
+    std::uint64_t id;
+};
+
+std::unique_ptr<Blob> load_blob(const std::string &path) {
+    return std::make_unique<Blob>(Blob{path.size()});
+}
+
+// The straightforward way to share ResourceManager between threads
+class GlobalLockManager {
+   public:
+    explicit GlobalLockManager(std::size_t max_size) : manager_(max_size, load_blob) {}
+
+    std::shared_ptr<Blob> get(const std::string &path) {
+        std::lock_guard lock(mutex_);
+        return manager_.get(path);
+    }
+
+    day1::CacheStats stats() const {
+        return manager_.stats();
+    }
+
+   private:
+    std::mutex mutex_;
+    day1::ResourceManager<Blob> manager_;
+};
+
+// Requests follow u^3 over the path list: the first 10% of paths take
+// about 46% of requests
+std::vector<std::uint32_t> make_requests(std::size_t count, std::size_t paths, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<std::uint32_t> requests(count);
+    for (auto &r : requests) {
+        const double x = u(rng);
+        r = static_cast<std::uint32_t>(static_cast<double>(paths) * x * x * x);
+    }
+    return requests;
+}
+
+// Mops/s of get() and the resulting hit ratio
+template <typename Manager>
+std::pair<double, double> run(Manager &manager, const std::vector<std::string> &paths,
+                              const std::vector<std::vector<std::uint32_t>> &requests) {
+    std::vector<std::uint64_t> sinks(requests.size());
+    std::size_t total = 0;
+    for (const auto &r : requests) {
+        total += r.size();
+    }
+    double ms = bench::time_ms([&] {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < requests.size(); ++t) {
+            workers.emplace_back([&, t] {
+                std::uint64_t sink = 0;
+                for (std::uint32_t index : requests[t]) {
+                    sink += manager.get(paths[index])->id;
+                }
+                sinks[t] = sink;
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+    });
+    bench::do_not_optimize(sinks);
+    const auto stats = manager.stats();
+    const double lookups = static_cast<double>(stats.hits + stats.misses);
+    return {static_cast<double>(total) / (ms * 1e3),
+            lookups > 0 ? static_cast<double>(stats.hits) / lookups : 0.0};
+}
+
+struct HerdResult {
+    double ms;
+    std::uint64_t loads;
+};
+
+HerdResult thundering_herd(bool single_flight, std::size_t threads, std::size_t cold_paths) {
+    day1::ConcurrentResourceOptions options;
+    options.single_flight = single_flight;
+    day1::ConcurrentResourceManager<Blob> manager(
+        1024,
+        [](const std::string &path) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::vector<std::uint8_t> decoded(1 << 20);
+            for (std::size_t i = 0; i < decoded.size(); ++i) {
+                decoded[i] = static_cast<std::uint8_t>(i * 31 + path.size());
+            }
+            bench::do_not_optimize(decoded.data());
+            return load_blob(path);
+        },
+        options);
+    std::barrier start(static_cast<std::ptrdiff_t>(threads));
+    std::vector<std::uint64_t> sinks(threads);
+    double ms = bench::time_ms([&] {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                start.arrive_and_wait();
+                for (std::size_t p = 0; p < cold_paths; ++p) {
+                    sinks[t] += manager.get("assets/level2/chunk_" + std::to_string(p))->id;
+                }
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+    });
+    bench::do_not_optimize(sinks);
+    return {ms, manager.loads()};
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t ops = bench::arg_count(argc, argv, 1, 2'000'000);
+    const std::size_t max_threads = bench::arg_count(argc, argv, 2, 64);
+    constexpr std::size_t kPaths = 100'000;
+    constexpr std::size_t kCapacity = 50'000;
+
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < kPaths; ++i) {
+        paths.push_back("assets/textures/tile_" + std::to_string(i) + ".png");
+    }
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    bench::print_header("get(): " + std::to_string(ops) + " calls, " + std::to_string(kPaths) +
+                        " paths, capacity " + std::to_string(kCapacity));
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::vector<std::vector<std::uint32_t>> requests;
+        for (std::size_t t = 0; t < threads; ++t) {
+            requests.push_back(make_requests(ops / threads, kPaths, static_cast<unsigned>(t + 1)));
+        }
+        GlobalLockManager locked(kCapacity);
+        day1::ConcurrentResourceManager<Blob> sharded(kCapacity, load_blob);
+        auto [locked_mops, locked_hits] = run(locked, paths, requests);
+        auto [sharded_mops, sharded_hits] = run(sharded, paths, requests);
+
+        const std::string suffix = ", " + std::to_string(threads) + " threads";
+        bench::report("global mutex" + suffix, locked_mops, "Mops/s");
+        bench::report("sharded (" + std::to_string(sharded.shard_count()) + " shards)" + suffix,
+                      sharded_mops, "Mops/s");
+        bench::report("  hit ratio, global mutex" + suffix, locked_hits, "");
+        bench::report("  hit ratio, sharded" + suffix, sharded_hits, "");
+    }
+
+    constexpr std::size_t kHerd = 32;
+    constexpr std::size_t kColdPaths = 20;
+    bench::print_header("thundering herd: " + std::to_string(kHerd) + " threads, " +
+                        std::to_string(kColdPaths) + " cold paths");
+    HerdResult without = thundering_herd(false, kHerd, kColdPaths);
+    HerdResult with = thundering_herd(true, kHerd, kColdPaths);
+    bench::report("without single flight: loader calls", static_cast<double>(without.loads),
+                  "calls");
+    bench::report("with single flight: loader calls", static_cast<double>(with.loads), "calls");
+    bench::report("without single flight: wall time", without.ms, "ms");
+    bench::report("with single flight: wall time", with.ms, "ms");
+    return 0;
+}
@@ -0,0 +1,231 @@
+// day1/benchmarks/concurrent_skip_map_bench.cpp
+// day1::concurrent_skip_map vs std::map behind a std::shared_mutex
+//
+// Usage: concurrent_skip_map_bench [ops=1M] [max_threads=64]
+//
+// Every workload runs the same total number of operations split across 1,
+// 2, 4, ... max_threads threads and reports aggregate throughput. With fewer
+// cores than threads the rows above the core count measure how each design
+// copes with preemption (a descheduled lock holder stalls everybody) rather
+// than parallel speedup.
+//
+// A final stress pass checks snapshot consistency: writers churn a few keys
+// while a reader walks each snapshot twice; both walks must return the same
+// strictly increasing keys. Any violation fails the run.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "concurrent_skip_map.hpp"
+
+namespace {
+
+struct LockedMap {
+    std::map<std::uint64_t, std::uint64_t> map;
+    mutable std::shared_mutex mutex;
+
+    bool insert(std::uint64_t key, std::uint64_t value) {
+        std::unique_lock lock(mutex);
+        return map.try_emplace(key, value).second;
+    }
+    bool erase(std::uint64_t key) {
+        std::unique_lock lock(mutex);
+        return map.erase(key) != 0;
+    }
+    bool contains(std::uint64_t key) const {
+        std::shared_lock lock(mutex);
+        return map.contains(key);
+    }
+    std::uint64_t scan(std::uint64_t from, std::size_t count) const {
+        std::shared_lock lock(mutex);
+        std::uint64_t sum = 0;
+        auto it = map.lower_bound(from);
+        for (std::size_t i = 0; i < count && it != map.end(); ++i, ++it) {
+            sum += it->second;
+        }
+        return sum;
+    }
+};
+
+struct SkipMap {
+    day1::concurrent_skip_map<std::uint64_t, std::uint64_t> map;
+
+    bool insert(std::uint64_t key, std::uint64_t value) {
+        return map.try_emplace(key, value);
+    }
+    bool erase(std::uint64_t key) {
+        return map.erase(key);
+    }
+    bool contains(std::uint64_t key) const {
+        return map.contains(key);
+    }
+    std::uint64_t scan(std::uint64_t from, std::size_t count) const {
+        auto snap = map.make_snapshot();
+        std::uint64_t sum = 0;
+        auto it = snap.lower_bound(from);
+        for (std::size_t i = 0; i < count && it != snap.end(); ++i, ++it) {
+            sum += (*it).second;
+        }
+        return sum;
+    }
+};
+
+enum class Workload { insert, mixed, scan };
+
+const char *workload_name(Workload w) {
+    switch (w) {
+        case Workload::insert:
+            return "insert only";
+        case Workload::mixed:
+            return "90% lookup / 5% insert / 5% erase";
+        default:
+            return "50% insert / 50% snapshot scan of 100";
+    }
+}
+
+// Mops/s for `ops` operations split across `threads` threads
+template <typename Map>
+double run(Workload workload, std::size_t ops, unsigned threads, std::size_t key_space) {
+    Map map;
+    if (workload != Workload::insert) {
+        // Start half full so inserts and erases both mostly succeed
+        std::mt19937_64 rng(1);
+        for (std::size_t i = 0; i < key_space / 2; ++i) {
+            map.insert(rng() % key_space, i);
+        }
+    }
+    std::vector<std::uint64_t> sinks(threads);
+    double ms = bench::time_ms([&] {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937_64 rng(100 + t);
+                const std::size_t share = ops / threads + (t < ops % threads);
+                std::uint64_t sink = 0;
+                for (std::size_t i = 0; i < share; ++i) {
+                    const std::uint64_t key = rng() % key_space;
+                    const unsigned roll = static_cast<unsigned>(rng() % 100);
+                    switch (workload) {
+                        case Workload::insert:
+                            sink += map.insert(key, i);
+                            break;
+                        case Workload::mixed:
+                            if (roll < 90) {
+                                sink += map.contains(key);
+                            } else if (roll < 95) {
+                                sink += map.insert(key, i);
+                            } else {
+                                sink += map.erase(key);
+                            }
+                            break;
+                        case Workload::scan:
+                            if (roll < 50) {
+                                sink += map.insert(key, i);
+                            } else {
+                                sink += map.scan(key, 100);
+                            }
+                            break;
+                    }
+                }
+                sinks[t] = sink;
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+    });
+    bench::do_not_optimize(sinks);
+    return static_cast<double>(ops) / (ms * 1e3);
+}
+
+// Snapshots out of `snapshots` that were inconsistent: a repeated or
+// out-of-order key, or two walks of one snapshot that disagree. Writers
+// insert and erase on a tiny key space so most operations race on the same
+// nodes.
+std::size_t snapshot_violations(std::size_t snapshots, unsigned writers) {
+    constexpr std::uint64_t kKeys = 64;
+    day1::concurrent_skip_map<std::uint64_t, std::uint64_t> map;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < writers; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 rng(900 + t);
+            while (!done.load(std::memory_order_relaxed)) {
+                const std::uint64_t key = rng() % kKeys;
+                if (rng() & 1) {
+                    map.try_emplace(key, key);
+                } else {
+                    map.erase(key);
+                }
+            }
+        });
+    }
+    std::size_t violations = 0;
+    std::vector<std::uint64_t> first;
+    std::vector<std::uint64_t> second;
+    for (std::size_t i = 0; i < snapshots; ++i) {
+        auto snap = map.make_snapshot();
+        first.clear();
+        second.clear();
+        for (auto [key, value] : snap) {
+            first.push_back(key);
+        }
+        std::this_thread::yield();
+        for (auto [key, value] : snap) {
+            second.push_back(key);
+        }
+        const bool ordered = std::adjacent_find(first.begin(), first.end(),
+                                                std::greater_equal<>{}) == first.end();
+        violations += !ordered || first != second;
+    }
+    done = true;
+    for (auto &t : threads) {
+        t.join();
+    }
+    return violations;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t ops = bench::arg_count(argc, argv, 1, 1'000'000);
+    const std::size_t max_threads = bench::arg_count(argc, argv, 2, 64);
+    const std::size_t key_space = ops;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    for (Workload workload : {Workload::insert, Workload::mixed, Workload::scan}) {
+        bench::print_header(std::string(workload_name(workload)) + ", " + std::to_string(ops) +
+                            " ops, " + std::to_string(key_space) + " keys");
+        for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+            const auto t = static_cast<unsigned>(threads);
+            double locked = run<LockedMap>(workload, ops, t, key_space);
+            double skip = run<SkipMap>(workload, ops, t, key_space);
+            const std::string suffix = ", " + std::to_string(threads) + " threads";
+            bench::report("shared_mutex + std::map" + suffix, locked, "Mops/s");
+            bench::report("concurrent_skip_map" + suffix, skip, "Mops/s");
+            bench::report("  ratio" + suffix, skip / locked, "x");
+        }
+    }
+
+    const std::size_t snapshots = std::max<std::size_t>(ops / 100, 1000);
+    bench::print_header("snapshot consistency, 3 writers on 64 keys");
+    const std::size_t violations = snapshot_violations(snapshots, 3);
+    bench::report("snapshots checked", static_cast<double>(snapshots), "");
+    bench::report("inconsistent snapshots", static_cast<double>(violations), "");
+    if (violations != 0) {
+        std::cerr << "concurrent_skip_map snapshots were inconsistent\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+// day1/benchmarks/cpu_dispatch_bench.cpp
+// Runtime CPU dispatch: which level runs, and what each tier is worth
+//
+// Usage: cpu_dispatch_bench [elements=256K]
+//        DAY1_CPU_LEVEL=v3 cpu_dispatch_bench   (stop at x86-64-v3)
+//
+// The default size stays in L2 so the tiers differ in compute rather than
+// memory bandwidth. Forces every level up to the startup level in turn,
+// checks that the dispatched kernels really switched, and times two of
+// them: fused-pipeline compaction (4- and 8-byte lanes) and
+// day1::simd::sum. Compaction must
+// match the portable kernel exactly; sums may differ by rounding, since
+// wider vectors add in a different order.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "cpu_dispatch.hpp"
+#include "fused_pipeline.hpp"
+#include "simd_reductions.hpp"
+
+namespace {
+
+constexpr int kReps = 5;
+
+double gb_per_s(std::size_t bytes, double ms) {
+    return static_cast<double>(bytes) / (ms * 1e6);
+}
+
+template <typename V, typename M>
+std::size_t compact_all(const std::vector<V> &in, const std::vector<M> &mask, std::vector<V> &out) {
+    return day1::fused::fused_detail::compact(in.data(), mask.data(), in.size(), out.data());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 256'000);
+    namespace cpu = day1::cpu;
+
+    const cpu::Level detected = cpu::detect_level();
+    const cpu::Level startup = cpu::active_level();
+    bench::print_header("CPU levels");
+    std::cout << "  detected: " << cpu::level_name(detected) << "\n"
+              << "  at startup (after DAY1_CPU_LEVEL): " << cpu::level_name(startup) << "\n"
+#if defined(__AVX512F__)
+              << "  compiled baseline: AVX-512 (not portable)\n";
+#elif defined(__AVX2__)
+              << "  compiled baseline: AVX2 (not portable)\n";
+#elif defined(__SSE4_2__)
+              << "  compiled baseline: SSE4.2\n";
+#else
+              << "  compiled baseline: SSE2\n";
+#endif
+
+    // About half the lanes survive, in no pattern a branch predictor learns
+    std::mt19937_64 rng(11);
+    std::vector<std::uint32_t> values32(n);
+    std::vector<std::uint32_t> mask32(n);
+    std::vector<std::uint64_t> values64(n);
+    std::vector<std::uint64_t> mask64(n);
+    std::vector<double> doubles(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t r = rng();
+        values32[i] = static_cast<std::uint32_t>(r);
+        values64[i] = r;
+        mask32[i] = (r >> 40) & 1 ? ~std::uint32_t{0} : 0;
+        mask64[i] = (r >> 40) & 1 ? ~std::uint64_t{0} : 0;
+        doubles[i] = static_cast<double>(r >> 11) * 0x1p-53;
+    }
+    std::vector<std::uint32_t> out32(n);
+    std::vector<std::uint64_t> out64(n);
+
+    // Reference results from the portable kernels
+    cpu::force_level(cpu::Level::baseline);
+    const std::size_t kept32 = compact_all(values32, mask32, out32);
+    const std::vector<std::uint32_t> expected32(out32.begin(), out32.begin() + kept32);
+    const std::size_t kept64 = compact_all(values64, mask64, out64);
+    const std::vector<std::uint64_t> expected64(out64.begin(), out64.begin() + kept64);
+    const double expected_sum = day1::simd::sum(std::span<const double>(doubles));
+
+    bool ok = true;
+    double baseline32 = 0;
+    double baseline64 = 0;
+    double baseline_sum = 0;
+    for (auto level : {cpu::Level::baseline, cpu::Level::v2, cpu::Level::v3, cpu::Level::v4}) {
+        if (level > startup) {
+            break;
+        }
+        const cpu::Level used = cpu::force_level(level);
+        const std::string tag = std::string(" [") + cpu::level_name(used) + "]";
+        bench::print_header(std::string("dispatch") + tag);
+        if (used != level || cpu::active_level() != level) {
+            std::cerr << "  requested " << cpu::level_name(level) << " but "
+                      << cpu::level_name(cpu::active_level()) << " is active\n";
+            ok = false;
+        }
+        std::cout << "  simd reductions use " << day1::simd::isa_name(day1::simd::active_isa())
+                  << "\n";
+
+        std::size_t kept = 0;
+        double ms = bench::best_of_ms(kReps, [&] { kept = compact_all(values32, mask32, out32); });
+        ok = ok && std::equal(expected32.begin(), expected32.end(), out32.begin()) &&
+             kept == kept32;
+        bench::report("compact, 4-byte lanes" + tag, gb_per_s(n * 8, ms), "GB/s");
+        if (level == cpu::Level::baseline) {
+            baseline32 = ms;
+        } else {
+            bench::report_speedup("  vs baseline", baseline32, ms);
+        }
+
+        ms = bench::best_of_ms(kReps, [&] { kept = compact_all(values64, mask64, out64); });
+        ok = ok && std::equal(expected64.begin(), expected64.end(), out64.begin()) &&
+             kept == kept64;
+        bench::report("compact, 8-byte lanes" + tag, gb_per_s(n * 16, ms), "GB/s");
+        if (level == cpu::Level::baseline) {
+            baseline64 = ms;
+        } else {
+            bench::report_speedup("  vs baseline", baseline64, ms);
+        }
+
+        double total = 0;
+        ms = bench::best_of_ms(kReps,
+                               [&] { total = day1::simd::sum(std::span<const double>(doubles)); });
+        bench::do_not_optimize(total);
+        bench::report("simd::sum" + tag, gb_per_s(n * sizeof(double), ms), "GB/s");
+        if (level == cpu::Level::baseline) {
+            baseline_sum = ms;
+        } else {
+            bench::report_speedup("  vs baseline", baseline_sum, ms);
+        }
+        ok = ok && std::abs(total - expected_sum) <= 1e-9 * std::abs(expected_sum);
+    }
+
+    if (!ok) {
+        std::cerr << "dispatched kernels disagree with the portable ones\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,250 @@
+// day1/benchmarks/disk_tier_bench.cpp
+// Cold start vs warm start from the DiskCache second tier
+//
+// Usage: disk_tier_bench [assets=64] [cache_file=/tmp/day1_disk_tier.l2]
+//
+// Each asset is a 1MB image whose "decode" is a few passes of per-pixel
+// arithmetic. A first run starts with an empty disk cache, so it decodes
+// every asset, then spills them all at shutdown. Later runs reopen the
+// file as a restarted process would and get() the same assets:
+//
+//   - copy codec: decode() copies the mapped bytes into a vector
+//   - view codec: decode() points the image at the mapping, no copy
+//
+// "page cache dropped" runs first ask the kernel to drop the file's cached
+// pages (posix_fadvise), so the bytes come from the disk. Systems without
+// POSIX_FADV_DONTNEED (macOS) keep the pages, and those runs read from
+// memory like the others. Each run touches one byte per 4KB page of every
+// image, as an upload would.
+//
+// A last check edits a real source file and erases a key, and fails the run
+// unless the tier ignores the stale record and the erase survives a rescan.
+// Another opens the cache over damaged indexes, which must fall back to
+// scanning the log.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "disk_cache.hpp"
+#include "resource_manager.hpp"
+
+namespace {
+
+constexpr std::size_t kImageBytes = 1 << 20;
+
+struct Image {
+    std::vector<std::byte> owned;
+    std::span<const std::byte> pixels;  // into owned, or into the disk cache mapping
+
+    std::size_t byte_size() const {
+        return sizeof(*this) + owned.capacity();
+    }
+};
+
+std::unique_ptr<Image> decode_image(const std::string &path) {
+    auto image = std::make_unique<Image>();
+    image->owned.resize(kImageBytes);
+    std::uint32_t state = static_cast<std::uint32_t>(path.size()) * 2654435761u;
+    for (int pass = 0; pass < 4; ++pass) {
+        for (std::size_t i = 0; i < kImageBytes; ++i) {
+            state = state * 1664525u + 1013904223u;
+            image->owned[i] = static_cast<std::byte>(static_cast<std::uint32_t>(image->owned[i]) ^
+                                                     (state >> 24));
+        }
+    }
+    image->pixels = image->owned;
+    return image;
+}
+
+struct CopyCodec {
+    static void encode(const Image &image, std::vector<std::byte> &out) {
+        out.assign(image.pixels.begin(), image.pixels.end());
+    }
+    static std::unique_ptr<Image> decode(std::span<const std::byte> bytes) {
+        auto image = std::make_unique<Image>();
+        image->owned.assign(bytes.begin(), bytes.end());
+        image->pixels = image->owned;
+        return image;
+    }
+};
+
+struct ViewCodec : CopyCodec {
+    static std::unique_ptr<Image> decode(std::span<const std::byte> bytes) {
+        auto image = std::make_unique<Image>();
+        image->pixels = bytes;
+        return image;
+    }
+};
+
+void drop_page_cache(const std::string &file) {
+#ifdef POSIX_FADV_DONTNEED
+    const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#endif
+}
+
+struct Run {
+    double open_ms;
+    double get_ms;
+    std::uint64_t tier_hits;
+};
+
+template <typename Codec>
+Run start(const std::string &file, const std::vector<std::string> &paths) {
+    std::unique_ptr<day1::DiskCache> l2;
+    const double open_ms = bench::time_ms(
+        [&] { l2 = std::make_unique<day1::DiskCache>(file, paths.size() * (kImageBytes + 4096)); });
+    day1::ResourceManager<Image> images(paths.size(), decode_image);
+    images.set_tier(day1::disk_tier<Image, Codec>(*l2));
+    std::uint64_t sink = 0;
+    const double get_ms = bench::time_ms([&] {
+        for (const auto &path : paths) {
+            auto image = images.get(path);
+            for (std::size_t i = 0; i < image->pixels.size(); i += 4096) {
+                sink += static_cast<std::uint64_t>(image->pixels[i]);
+            }
+        }
+    });
+    bench::do_not_optimize(sink);
+    const std::uint64_t tier_hits = images.stats().tier_hits;
+    images.spill_all();
+    return {open_ms, get_ms, tier_hits};
+}
+
+void report(const std::string &name, const Run &run) {
+    bench::report(name + ": open", run.open_ms, "ms");
+    bench::report(name + ": get all", run.get_ms, "ms");
+    bench::report(name + ": from disk", static_cast<double>(run.tier_hits), "assets");
+}
+
+void write_source(const std::string &path, const std::string &contents) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+}
+
+// Stale records are skipped and rewritten, and an erase outlives the index
+bool check_invalidation(const std::string &file) {
+    const std::string source = file + ".src";
+    write_source(source, "v1");
+    bool ok = true;
+    {
+        day1::DiskCache l2(file, 1 << 20);
+        auto tier = day1::disk_tier<Image, CopyCodec>(l2);
+        Image image;
+        image.pixels = std::as_bytes(std::span(source));
+        tier.store(source, image);
+        ok = ok && tier.fetch(source) != nullptr;
+        write_source(source, "version 2");
+        ok = ok && tier.fetch(source) == nullptr && l2.stats().stale == 1;
+        tier.store(source, image);
+        ok = ok && tier.fetch(source) != nullptr;
+        ok = ok && l2.erase(source);
+    }
+    std::filesystem::remove(file + ".idx");  // force the reopen to scan the log
+    {
+        day1::DiskCache l2(file, 1 << 20);
+        ok = ok && !l2.opened_from_index() && !l2.contains(source);
+    }
+    std::filesystem::remove(source);
+    std::filesystem::remove(file);
+    std::filesystem::remove(file + ".idx");
+    return ok;
+}
+
+// Overlong key lengths, extents that wrap around and a truncated index
+// must each be rejected, so the cache rebuilds its index from the log
+bool check_corrupt_index(const std::string &file) {
+    const std::string value = "payload";
+    const auto bytes = std::as_bytes(std::span(value));
+    {
+        day1::DiskCache l2(file, 1 << 20);
+        l2.put("key", bytes);
+    }
+    std::vector<char> good(std::filesystem::file_size(file + ".idx"));
+    std::ifstream(file + ".idx", std::ios::binary).read(good.data(), std::ssize(good));
+
+    // The index is a 3-word header, then per key 5 words (offset, size,
+    // source size, source mtime, key length) and the key
+    auto with_word = [&](std::size_t word, std::uint64_t value) {
+        std::vector<char> bad = good;
+        std::memcpy(bad.data() + word * sizeof(std::uint64_t), &value, sizeof(value));
+        return bad;
+    };
+    const std::vector<std::vector<char>> damaged = {
+        with_word(7, std::uint64_t{1} << 62),  // key length
+        with_word(3, ~std::uint64_t{0} - 2),   // offset + size wraps
+        with_word(4, ~std::uint64_t{0}),       // size
+        std::vector<char>(good.begin(), good.end() - 2),
+    };
+    bool ok = true;
+    for (const auto &index : damaged) {
+        std::ofstream(file + ".idx", std::ios::binary | std::ios::trunc)
+            .write(index.data(), std::ssize(index));
+        try {
+            day1::DiskCache l2(file, 1 << 20);
+            auto found = l2.find("key");
+            ok = ok && !l2.opened_from_index() && found &&
+                 std::ranges::equal(*found, bytes);
+        } catch (...) {
+            ok = false;
+        }
+    }
+    std::filesystem::remove(file);
+    std::filesystem::remove(file + ".idx");
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t assets = bench::arg_count(argc, argv, 1, 64);
+    const std::string file = argc > 2 ? argv[2] : "/tmp/day1_disk_tier.l2";
+    std::filesystem::remove(file);
+    std::filesystem::remove(file + ".idx");
+
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < assets; ++i) {
+        paths.push_back("assets/textures/atlas_" + std::to_string(i) + ".png");
+    }
+
+    bench::print_header(std::to_string(assets) + " x 1MB images");
+    bench::report("assets", static_cast<double>(assets), "");
+    const Run cold = start<CopyCodec>(file, paths);
+    report("cold start (decode)", cold);
+    report("warm start, copy codec", start<CopyCodec>(file, paths));
+    const Run warm = start<ViewCodec>(file, paths);
+    report("warm start, view codec", warm);
+    drop_page_cache(file);
+    report("page cache dropped, copy codec", start<CopyCodec>(file, paths));
+    drop_page_cache(file);
+    report("page cache dropped, view codec", start<ViewCodec>(file, paths));
+    bench::report_speedup("warm (view) vs cold", cold.open_ms + cold.get_ms,
+                          warm.open_ms + warm.get_ms);
+
+    std::filesystem::remove(file);
+    std::filesystem::remove(file + ".idx");
+    if (!check_invalidation(file)) {
+        std::cerr << "disk tier served a stale record or lost an erase\n";
+        return 1;
+    }
+    if (!check_corrupt_index(file)) {
+        std::cerr << "disk cache trusted a damaged index\n";
+        return 1;
+    }
+    return 0;
+}
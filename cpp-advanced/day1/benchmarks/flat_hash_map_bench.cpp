@@ -0,0 +1,132 @@
+// day1/benchmarks/flat_hash_map_bench.cpp
+// day1::flat_hash_map/set vs std::unordered_map and std::set
+//
+// Usage: flat_hash_map_bench [keys=1M]
+// Sweep e.g. 1M, 10M, 100M; 100M integer keys need ~6GB for the std side.
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "flat_hash_map.hpp"
+
+struct Keys {
+    std::vector<std::uint64_t> present;
+    std::vector<std::uint64_t> absent;
+};
+
+Keys make_keys(std::size_t n) {
+    Keys keys;
+    keys.present.resize(n);
+    keys.absent.resize(n);
+    std::mt19937_64 rng(7);
+    for (std::size_t i = 0; i < n; ++i) {
+        // Disjoint by construction: odd keys are stored, even keys are misses
+        keys.present[i] = rng() | 1;
+        keys.absent[i] = rng() & ~std::uint64_t{1};
+    }
+    return keys;
+}
+
+template <typename Map>
+void run_integer_suite(const char *name, const Keys &keys) {
+    const double n = static_cast<double>(keys.present.size());
+    Map map;
+    double insert_ms = bench::time_ms([&] {
+        for (auto k : keys.present) {
+            map.try_emplace(k, k);
+        }
+    });
+
+    std::uint64_t sum = 0;
+    double hit_ms = bench::time_ms([&] {
+        for (auto k : keys.present) {
+            sum += map.find(k)->second;
+        }
+    });
+    double miss_ms = bench::time_ms([&] {
+        for (auto k : keys.absent) {
+            sum += map.find(k) != map.end();
+        }
+    });
+    double iterate_ms = bench::time_ms([&] {
+        for (const auto &kv : map) {
+            sum += kv.second;
+        }
+    });
+    double erase_ms = bench::time_ms([&] {
+        for (auto k : keys.present) {
+            map.erase(k);
+        }
+    });
+    bench::do_not_optimize(sum);
+
+    const std::string prefix = std::string(name) + " ";
+    bench::report(prefix + "insert", insert_ms * 1e6 / n, "ns/op");
+    bench::report(prefix + "find (hit)", hit_ms * 1e6 / n, "ns/op");
+    bench::report(prefix + "find (miss)", miss_ms * 1e6 / n, "ns/op");
+    bench::report(prefix + "iterate", iterate_ms * 1e6 / n, "ns/elem");
+    bench::report(prefix + "erase", erase_ms * 1e6 / n, "ns/op");
+}
+
+template <typename Set>
+double string_lookup_ns(const std::vector<std::string> &words,
+                        const std::vector<std::string_view> &probes) {
+    Set set(words.begin(), words.end());
+    std::size_t found = 0;
+    double ms = bench::best_of_ms(3, [&] {
+        for (auto probe : probes) {
+            found += set.find(probe) != set.end();
+        }
+    });
+    bench::do_not_optimize(found);
+    return ms * 1e6 / static_cast<double>(probes.size());
+}
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 1'000'000);
+
+    bench::print_header("Integer keys (" + std::to_string(n) + ")");
+    {
+        Keys keys = make_keys(n);
+        run_integer_suite<std::unordered_map<std::uint64_t, std::uint64_t>>("std::unordered_map",
+                                                                            keys);
+        run_integer_suite<day1::flat_hash_map<std::uint64_t, std::uint64_t>>("flat_hash_map",
+                                                                             keys);
+    }
+
+    // String keys probed through string_view (50% hit rate)
+    const std::size_t word_count = n / 4 > 0 ? n / 4 : 1;
+    bench::print_header("Heterogeneous string_view lookup (" + std::to_string(word_count) +
+                        " strings)");
+    std::vector<std::string> words;
+    std::vector<std::string> misses;
+    words.reserve(word_count);
+    misses.reserve(word_count);
+    for (std::size_t i = 0; i < word_count; ++i) {
+        words.push_back("resource/texture_" + std::to_string(i * 2) + ".png");
+        misses.push_back("resource/texture_" + std::to_string(i * 2 + 1) + ".png");
+    }
+    std::vector<std::string_view> probes;
+    probes.reserve(2 * word_count);
+    for (std::size_t i = 0; i < word_count; ++i) {
+        probes.push_back(words[(i * 7919) % word_count]);
+        probes.push_back(misses[(i * 104729) % word_count]);
+    }
+
+    bench::report("std::set<std::string, std::less<>>",
+                  string_lookup_ns<std::set<std::string, std::less<>>>(words, probes), "ns/op");
+    bench::report("std::unordered_set (transparent hash)",
+                  string_lookup_ns<std::unordered_set<std::string, day1::string_hash,
+                                                      std::equal_to<>>>(words, probes),
+                  "ns/op");
+    bench::report("flat_hash_set<std::string>",
+                  string_lookup_ns<day1::flat_hash_set<std::string>>(words, probes), "ns/op");
+    return 0;
+}
@@ -0,0 +1,112 @@
+// day1/benchmarks/flat_map_bench.cpp
+// day1::flat_map vs std::map: build, lookup, batch insert and range scans
+//
+// Usage: flat_map_bench [keys=1M]
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "flat_map.hpp"
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 1'000'000);
+
+    std::mt19937_64 rng(11);
+    std::vector<std::uint64_t> keys(n);
+    std::vector<std::uint64_t> values(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = rng();
+        values[i] = i;
+    }
+
+    bench::print_header("Build from " + std::to_string(n) + " unsorted keys");
+    std::map<std::uint64_t, std::uint64_t> tree;
+    double tree_build = bench::time_ms([&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            tree.emplace(keys[i], values[i]);
+        }
+    });
+    day1::flat_map<std::uint64_t, std::uint64_t> flat;
+    double flat_build = bench::time_ms([&] {
+        flat = day1::flat_map<std::uint64_t, std::uint64_t>(keys, values);
+    });
+    bench::report("std::map insert loop", tree_build, "ms");
+    bench::report("flat_map bulk build", flat_build, "ms");
+    bench::report_speedup("speedup", tree_build, flat_build);
+
+    bench::print_header("Point lookups");
+    std::uint64_t sink = 0;
+    double tree_find = bench::time_ms([&] {
+        for (auto k : keys) {
+            sink += tree.find(k)->second;
+        }
+    });
+    double flat_find = bench::time_ms([&] {
+        for (auto k : keys) {
+            sink += flat.find(k)->second;
+        }
+    });
+    bench::report("std::map find", tree_find * 1e6 / n, "ns/op");
+    bench::report("flat_map find", flat_find * 1e6 / n, "ns/op");
+
+    // Range scans of increasing width starting at random keys
+    for (std::size_t width : {std::size_t{16}, std::size_t{1'000}, std::size_t{100'000}}) {
+        if (width > n) {
+            continue;
+        }
+        const std::size_t scans = std::max<std::size_t>(1, 20'000'000 / width);
+        std::vector<std::uint64_t> starts(scans);
+        for (auto &s : starts) {
+            s = flat.keys()[rng() % (n - width + 1)];
+        }
+        bench::print_header("Range scan of " + std::to_string(width) + " elements x " +
+                            std::to_string(scans));
+        double tree_scan = bench::time_ms([&] {
+            for (auto start : starts) {
+                auto it = tree.lower_bound(start);
+                for (std::size_t i = 0; i < width; ++i, ++it) {
+                    sink += it->second;
+                }
+            }
+        });
+        double flat_scan = bench::time_ms([&] {
+            for (auto start : starts) {
+                auto first = flat.lower_bound(start);
+                auto last = first + static_cast<std::ptrdiff_t>(width);
+                for (auto it = first; it != last; ++it) {
+                    sink += (*it).second;
+                }
+            }
+        });
+        const double elems = static_cast<double>(scans * width);
+        bench::report("std::map scan", tree_scan * 1e6 / elems, "ns/elem");
+        bench::report("flat_map scan", flat_scan * 1e6 / elems, "ns/elem");
+        bench::report_speedup("speedup", tree_scan, flat_scan);
+    }
+
+    // Batch of 10% new keys
+    const std::size_t batch_size = std::max<std::size_t>(1, n / 10);
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> batch(batch_size);
+    for (auto &kv : batch) {
+        kv = {rng(), 0};
+    }
+    bench::print_header("Batch insert of " + std::to_string(batch_size) + " new keys");
+    double tree_batch = bench::time_ms([&] { tree.insert(batch.begin(), batch.end()); });
+    double flat_batch = bench::time_ms([&] { flat.insert(batch.begin(), batch.end()); });
+    bench::report("std::map insert(first, last)", tree_batch, "ms");
+    bench::report("flat_map merge insert", flat_batch, "ms");
+    bench::report_speedup("speedup", tree_batch, flat_batch);
+
+    bench::do_not_optimize(sink);
+    if (tree.size() != flat.size()) {
+        std::cerr << "Size mismatch: " << tree.size() << " vs " << flat.size() << "\n";
+        return 1;
+    }
+    return 0;
+}
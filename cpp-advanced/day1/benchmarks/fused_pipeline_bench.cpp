@@ -0,0 +1,109 @@
+// day1/benchmarks/fused_pipeline_bench.cpp
+// Fused filter/transform pipelines vs the equivalent std::views chains
+//
+// Usage: fused_pipeline_bench [elements=100M] [threads=hardware_concurrency]
+//
+// Inputs are random, so the `even` filter is a coin flip per element and
+// the branchy views loop pays for mispredictions the fused masks avoid.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "fused_pipeline.hpp"
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 100'000'000);
+    const unsigned threads = static_cast<unsigned>(
+        bench::arg_count(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+    day1::WorkStealingPool pool(threads);
+    const auto par = day1::execution::par.on(pool);
+    constexpr int kReps = 3;
+
+    std::vector<int> numbers(n);
+    std::mt19937 rng(42);
+    // Squares stay <= 1e10, so the default 100M elements sum to < 1e18
+    // and the long accumulators cannot overflow
+    std::uniform_int_distribution<int> dist(-100'000, 100'000);
+    for (auto &v : numbers) {
+        v = dist(rng);
+    }
+    auto even = [](int v) { return v % 2 == 0; };
+    auto square = [](int v) { return static_cast<long>(v) * v; };
+    bool ok = true;
+
+    bench::print_header("sum of even squares, " + std::to_string(n) + " ints");
+    long views_sum = 0;
+    double views_ms = bench::best_of_ms(kReps, [&] {
+        long sum = 0;
+        for (long v : numbers | std::views::filter(even) | std::views::transform(square)) {
+            sum += v;
+        }
+        views_sum = sum;
+    });
+    const auto squares =
+        day1::fused::from(numbers) | day1::fused::filter(even) | day1::fused::transform(square);
+    long fused_seq_sum = 0;
+    double fused_seq_ms = bench::best_of_ms(
+        kReps, [&] { fused_seq_sum = squares.reduce(day1::execution::seq, 0L); });
+    long fused_par_sum = 0;
+    double fused_par_ms =
+        bench::best_of_ms(kReps, [&] { fused_par_sum = squares.reduce(par, 0L); });
+    ok = ok && views_sum == fused_seq_sum && views_sum == fused_par_sum;
+    bench::report("views::filter | views::transform, range-for", views_ms, "ms");
+    bench::report("fused reduce(seq)", fused_seq_ms, "ms");
+    bench::report("fused reduce(par)", fused_par_ms, "ms");
+    bench::report("input bandwidth, fused(seq)",
+                  static_cast<double>(n * sizeof(int)) / (fused_seq_ms * 1e6), "GB/s");
+    bench::report_speedup("fused(seq) vs views", views_ms, fused_seq_ms);
+    bench::report_speedup("fused(par) vs views", views_ms, fused_par_ms);
+
+    bench::print_header("count with two chained filters");
+    auto positive = [](int v) { return v > 0; };
+    std::size_t views_count = 0;
+    double views_count_ms = bench::best_of_ms(kReps, [&] {
+        views_count = static_cast<std::size_t>(std::ranges::distance(
+            numbers | std::views::filter(even) | std::views::filter(positive)));
+    });
+    std::size_t fused_count = 0;
+    const auto even_positive =
+        day1::fused::from(numbers) | day1::fused::filter(even) | day1::fused::filter(positive);
+    double fused_count_ms = bench::best_of_ms(
+        kReps, [&] { fused_count = even_positive.count(day1::execution::seq); });
+    ok = ok && views_count == fused_count;
+    bench::report("ranges::distance(filter | filter)", views_count_ms, "ms");
+    bench::report("fused count(seq)", fused_count_ms, "ms");
+    bench::report_speedup("fused(seq) vs views", views_count_ms, fused_count_ms);
+
+    bench::print_header("materialize filter | transform into a vector");
+    std::vector<long> views_out;
+    double views_copy_ms = bench::best_of_ms(kReps, [&] {
+        views_out.clear();
+        std::ranges::copy(numbers | std::views::filter(even) | std::views::transform(square),
+                          std::back_inserter(views_out));
+    });
+    std::vector<long> fused_seq_out;
+    double fused_copy_seq_ms =
+        bench::best_of_ms(kReps, [&] { fused_seq_out = squares.to_vector(day1::execution::seq); });
+    std::vector<long> fused_par_out;
+    double fused_copy_par_ms =
+        bench::best_of_ms(kReps, [&] { fused_par_out = squares.to_vector(par); });
+    ok = ok && views_out == fused_seq_out && views_out == fused_par_out;
+    bench::report("ranges::copy -> back_inserter", views_copy_ms, "ms");
+    bench::report("fused to_vector(seq)", fused_copy_seq_ms, "ms");
+    bench::report("fused to_vector(par)", fused_copy_par_ms, "ms");
+    bench::report_speedup("fused(seq) vs views", views_copy_ms, fused_copy_seq_ms);
+
+    if (!ok) {
+        std::cerr << "fused pipeline results differ from std::views\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,203 @@
+// day1/benchmarks/hot_reload_bench.cpp
+// Hot reload: reloads per deployed file and swap latency, with and
+// without debouncing
+//
+// Usage: hot_reload_bench [files=16] [writes_per_file=20]
+//
+// The cached files are rewritten writes_per_file times each in a burst,
+// the way a deploy tool copies in chunks, while reader threads keep
+// calling get(). Every file holds one version number repeated, and
+// readers check that each resource they hold is self-consistent. Reported:
+// inotify events seen, reloads run, time from the end of the deploy until
+// the last reload finished, and torn reads (which must be zero).
+//
+// A final check reloads a path while a slow load of it is in flight: the
+// load read the old version, so it must not stay cached. Failing it fails
+// the run.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "concurrent_resource_manager.hpp"
+#include "file_watcher.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A file parsed as a list of version numbers; all equal unless torn
+struct Config {
+    std::vector<std::uint32_t> values;
+
+    bool consistent() const {
+        for (std::uint32_t v : values) {
+            if (v != values.front()) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+std::unique_ptr<Config> load_config(const std::string &path) {
+    std::ifstream in(path);
+    auto config = std::make_unique<Config>();
+    for (std::uint32_t v; in >> v;) {
+        config->values.push_back(v);
+    }
+    return config->values.empty() ? nullptr : std::move(config);
+}
+
+// Writes to a temporary name and renames it into place, as deploys do
+void write_version(const fs::path &file, std::uint32_t version) {
+    const fs::path tmp = file.string() + ".tmp";
+    {
+        std::ofstream out(tmp);
+        for (int i = 0; i < 1000; ++i) {
+            out << version << '\n';
+        }
+    }
+    fs::rename(tmp, file);
+}
+
+struct Result {
+    std::uint64_t events;
+    std::uint64_t reloads;
+    double settle_ms;
+    std::uint64_t torn;
+};
+
+Result deploy(const fs::path &dir, std::size_t files, std::size_t writes,
+              std::chrono::milliseconds debounce) {
+    std::vector<std::string> paths;
+    for (std::size_t f = 0; f < files; ++f) {
+        paths.push_back((dir / ("config_" + std::to_string(f) + ".txt")).string());
+        write_version(paths.back(), 0);
+    }
+    day1::ConcurrentResourceManager<Config> configs(4 * files, load_config);
+    for (const auto &path : paths) {
+        configs.get(path);
+    }
+
+    std::atomic<std::uint64_t> reloads{0};
+    std::atomic<std::int64_t> last_reload_ns{0};
+    day1::FileWatcher watcher(
+        [&](const std::string &path) {
+            if (configs.reload(path)) {
+                reloads.fetch_add(1, std::memory_order_relaxed);
+            }
+            last_reload_ns.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                                 std::memory_order_relaxed);
+        },
+        debounce);
+    watcher.watch(dir.string());
+
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> torn{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (const auto &path : paths) {
+                    auto config = configs.get(path);
+                    if (config && !config->consistent()) {
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    for (std::size_t w = 1; w <= writes; ++w) {
+        for (const auto &path : paths) {
+            write_version(path, static_cast<std::uint32_t>(w));
+        }
+    }
+    const auto deployed = std::chrono::steady_clock::now();
+    // Wait until every file serves the final version
+    for (bool done = false; !done;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        done = true;
+        for (const auto &path : paths) {
+            auto config = configs.get(path);
+            done = done && config && config->values.front() == writes;
+        }
+    }
+    stop = true;
+    for (auto &r : readers) {
+        r.join();
+    }
+    const auto last = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(last_reload_ns.load()));
+    return {watcher.stats().events, reloads.load(),
+            std::chrono::duration<double, std::milli>(std::max(last, deployed) - deployed).count(),
+            torn.load()};
+}
+
+// A file changes, and is reloaded, while a load that read the old version
+// is still running; get() afterwards must see the new version
+bool check_reload_during_load() {
+    std::atomic<std::uint32_t> on_disk{1};
+    std::atomic<bool> loading{false};
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    day1::ConcurrentResourceManager<Config> configs(16, [&](const std::string &) {
+        auto config = std::make_unique<Config>();
+        config->values.push_back(on_disk.load());
+        if (!loading.exchange(true)) {
+            gate.wait();  // only the first load is slow
+        }
+        return config;
+    });
+    auto pending = configs.get_async("config.txt");
+    while (!loading.load()) {
+        std::this_thread::yield();
+    }
+    on_disk = 2;
+    configs.reload("config.txt");
+    release.set_value();
+    const bool old_served = pending.get()->values.front() == 1;
+    return old_served && configs.get("config.txt")->values.front() == 2;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t files = bench::arg_count(argc, argv, 1, 16);
+    const std::size_t writes = bench::arg_count(argc, argv, 2, 20);
+    const fs::path dir = fs::temp_directory_path() / "day1_hot_reload";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    bench::print_header(std::to_string(files) + " files x " + std::to_string(writes) +
+                        " rewrites");
+    for (int debounce_ms : {0, 50}) {
+        const Result r = deploy(dir, files, writes, std::chrono::milliseconds(debounce_ms));
+        const std::string name = "debounce " + std::to_string(debounce_ms) + "ms";
+        bench::report(name + ": inotify events", static_cast<double>(r.events), "");
+        bench::report(name + ": reloads", static_cast<double>(r.reloads), "");
+        bench::report(name + ": settled after deploy", r.settle_ms, "ms");
+        bench::report(name + ": torn reads", static_cast<double>(r.torn), "");
+    }
+    fs::remove_all(dir);
+
+    bench::print_header("reload during a slow load");
+    const bool fresh = check_reload_during_load();
+    bench::report("stale version cached", fresh ? 0.0 : 1.0, "");
+    if (!fresh) {
+        std::cerr << "a load overtaken by reload() cached the old version\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+// day1/benchmarks/multi_resource_bench.cpp
+// One variant-typed cache vs one cache per type (MultiResourceManager)
+//
+// Usage: multi_resource_bench [lookups=4M]
+//
+// 2K textures and 20K sounds are cached by both designs; their payloads
+// are left empty, so only the resource objects, cache entries and control
+// blocks are measured. A Texture carries 96 bytes of metadata and a Sound
+// 32, so every variant entry is the size of a Texture.
+//
+//   - heap: bytes allocated while filling the cache, counted by the
+//     replacement operator new/delete below
+//   - get<T>() hits, uniformly over the cached paths: the variant design
+//     also checks the alternative and builds an aliasing shared_ptr
+//
+// Paths and request order are generated before timing.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "multi_resource_manager.hpp"
+#include "resource_manager.hpp"
+
+namespace {
+
+// Live bytes requested through the replacement operator new below. Each
+// block carries its size in a max_align_t-sized header so the unsized
+// operator delete can subtract it again.
+std::atomic<std::size_t> g_heap_in_use{0};
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+}  // namespace
+
+void *operator new(std::size_t bytes) {
+    auto *block = static_cast<unsigned char *>(std::malloc(bytes + kHeader));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(block) = bytes;
+    g_heap_in_use.fetch_add(bytes, std::memory_order_relaxed);
+    return block + kHeader;
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto *block = static_cast<unsigned char *>(ptr) - kHeader;
+    g_heap_in_use.fetch_sub(*reinterpret_cast<std::size_t *>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+namespace {
+
+constexpr std::size_t kTextures = 2'000;
+constexpr std::size_t kSounds = 20'000;
+
+struct Texture {
+    std::vector<std::uint8_t> data;
+    std::uint32_t width = 1024, height = 1024, format = 0, mip_levels = 11;
+    std::array<std::uint32_t, 14> mip_offsets{};
+};
+
+struct Sound {
+    std::vector<std::int16_t> samples;
+    std::uint32_t sample_rate = 44100, channels = 2;
+};
+
+std::unique_ptr<Texture> load_texture(const std::string &) {
+    return std::make_unique<Texture>();
+}
+std::unique_ptr<Sound> load_sound(const std::string &) {
+    return std::make_unique<Sound>();
+}
+
+using AnyResource = std::variant<Texture, Sound>;
+
+// The design MultiResourceManager replaced: one cache, dispatch on the
+// variant's alternative at every access
+class VariantManager {
+   public:
+    VariantManager()
+        : manager_(std::numeric_limits<std::size_t>::max(), [](const std::string &path) {
+              return path.ends_with(".png")
+                         ? std::make_unique<AnyResource>(std::in_place_type<Texture>)
+                         : std::make_unique<AnyResource>(std::in_place_type<Sound>);
+          }) {}
+
+    template <typename T>
+    std::shared_ptr<T> get(const std::string &path) {
+        auto resource = manager_.get(path);
+        if (auto *ptr = resource ? std::get_if<T>(resource.get()) : nullptr) {
+            return std::shared_ptr<T>(std::move(resource), ptr);
+        }
+        return nullptr;
+    }
+
+   private:
+    day1::ResourceManager<AnyResource> manager_;
+};
+
+using TypedManager = day1::MultiResourceManager<Texture, Sound>;
+
+std::size_t heap_in_use() {
+    return g_heap_in_use.load(std::memory_order_relaxed);
+}
+
+struct Paths {
+    std::vector<std::string> textures;
+    std::vector<std::string> sounds;
+};
+
+Paths make_paths() {
+    Paths paths;
+    for (std::size_t i = 0; i < kTextures; ++i) {
+        paths.textures.push_back("tex/" + std::to_string(i) + ".png");
+    }
+    for (std::size_t i = 0; i < kSounds; ++i) {
+        paths.sounds.push_back("sfx/" + std::to_string(i) + ".wav");
+    }
+    return paths;
+}
+
+template <typename Manager>
+void fill(Manager &manager, const Paths &paths) {
+    for (const auto &p : paths.textures) {
+        manager.template get<Texture>(p);
+    }
+    for (const auto &p : paths.sounds) {
+        manager.template get<Sound>(p);
+    }
+}
+
+// ns per get<T>() over indices into paths
+template <typename T, typename Manager>
+double lookup_ns(Manager &manager, const std::vector<std::string> &paths,
+                 const std::vector<std::uint32_t> &order) {
+    std::uint64_t sink = 0;
+    const double ms = bench::time_ms([&] {
+        for (std::uint32_t i : order) {
+            sink += reinterpret_cast<std::uintptr_t>(manager.template get<T>(paths[i]).get());
+        }
+    });
+    bench::do_not_optimize(sink);
+    return ms * 1e6 / static_cast<double>(order.size());
+}
+
+std::vector<std::uint32_t> make_order(std::size_t count, std::size_t range) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(range - 1));
+    std::vector<std::uint32_t> order(count);
+    for (auto &i : order) {
+        i = pick(rng);
+    }
+    return order;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t lookups = bench::arg_count(argc, argv, 1, 4'000'000);
+    const Paths paths = make_paths();
+    const auto texture_order = make_order(lookups, kTextures);
+    const auto sound_order = make_order(lookups, kSounds);
+    bench::print_header("variant cache vs per-type caches, " + std::to_string(kTextures) +
+                        " textures + " + std::to_string(kSounds) + " sounds");
+
+    bench::report("sizeof(Texture)", sizeof(Texture), "bytes");
+    bench::report("sizeof(Sound)", sizeof(Sound), "bytes");
+    bench::report("sizeof(variant<Texture, Sound>)", sizeof(AnyResource), "bytes");
+
+    std::size_t before = heap_in_use();
+    auto variant = std::make_unique<VariantManager>();
+    fill(*variant, paths);
+    const auto variant_heap = heap_in_use() - before;
+
+    before = heap_in_use();
+    auto typed = std::make_unique<TypedManager>(
+        std::numeric_limits<std::size_t>::max(),
+        day1::ResourceConfig<Texture>{.loader = load_texture},
+        day1::ResourceConfig<Sound>{.loader = load_sound});
+    fill(*typed, paths);
+    const auto typed_heap = heap_in_use() - before;
+
+    bench::report("variant: heap", static_cast<double>(variant_heap) / 1024, "KB");
+    bench::report("per-type: heap", static_cast<double>(typed_heap) / 1024, "KB");
+    bench::report_speedup("heap reduction", static_cast<double>(variant_heap),
+                          static_cast<double>(typed_heap));
+
+    const double variant_tex = lookup_ns<Texture>(*variant, paths.textures, texture_order);
+    const double typed_tex = lookup_ns<Texture>(*typed, paths.textures, texture_order);
+    const double variant_sound = lookup_ns<Sound>(*variant, paths.sounds, sound_order);
+    const double typed_sound = lookup_ns<Sound>(*typed, paths.sounds, sound_order);
+    bench::report("variant: get<Texture>()", variant_tex, "ns/op");
+    bench::report("per-type: get<Texture>()", typed_tex, "ns/op");
+    bench::report_speedup("get<Texture>()", variant_tex, typed_tex);
+    bench::report("variant: get<Sound>()", variant_sound, "ns/op");
+    bench::report("per-type: get<Sound>()", typed_sound, "ns/op");
+    bench::report_speedup("get<Sound>()", variant_sound, typed_sound);
+    return 0;
+}
@@ -0,0 +1,121 @@
+// day1/benchmarks/parallel_algorithms_bench.cpp
+// day1 parallel algorithms vs serial STL and std::execution::par_unseq
+//
+// Usage: parallel_algorithms_bench [elements=10M] [threads=hardware_concurrency]
+//
+// The std::execution rows show what the toolchain actually delivers: with
+// libstdc++ and no TBB they match the serial numbers.
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "parallel_algorithms.hpp"
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 10'000'000);
+    const unsigned threads = static_cast<unsigned>(
+        bench::arg_count(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+
+    day1::WorkStealingPool pool(threads);
+    const auto par = day1::execution::par.on(pool);
+    constexpr int kReps = 5;
+
+    std::vector<double> data(n);
+    std::iota(data.begin(), data.end(), 1.0);
+    double sink = 0.0;
+
+    bench::print_header("reduce: sum of " + std::to_string(n) + " doubles, " +
+                        std::to_string(pool.size()) + " pool threads");
+    double acc_ms = bench::best_of_ms(kReps, [&] {
+        sink += std::accumulate(data.begin(), data.end(), 0.0);
+    });
+    double std_par_ms = bench::best_of_ms(kReps, [&] {
+        sink += std::reduce(std::execution::par_unseq, data.begin(), data.end(), 0.0);
+    });
+    double pool_ms = bench::best_of_ms(kReps, [&] {
+        sink += day1::reduce(par, data.begin(), data.end(), 0.0);
+    });
+    bench::report("std::accumulate", acc_ms, "ms");
+    bench::report("std::reduce(par_unseq)", std_par_ms, "ms");
+    bench::report("day1::reduce(par)", pool_ms, "ms");
+    bench::report_speedup("speedup vs std::accumulate", acc_ms, pool_ms);
+    bench::report_speedup("speedup vs std::reduce(par_unseq)", std_par_ms, pool_ms);
+
+    std::vector<double> out(n);
+    auto heavy = [](double x) { return std::sqrt(x) * std::sin(x); };
+
+    bench::print_header("transform (sqrt * sin)");
+    double tr_seq = bench::best_of_ms(kReps, [&] {
+        std::transform(data.begin(), data.end(), out.begin(), heavy);
+    });
+    double tr_par = bench::best_of_ms(kReps, [&] {
+        day1::transform(par, data.begin(), data.end(), out.begin(), heavy);
+    });
+    bench::report("std::transform", tr_seq, "ms");
+    bench::report("day1::transform(par)", tr_par, "ms");
+    bench::report_speedup("speedup", tr_seq, tr_par);
+
+    bench::print_header("for_each (in-place update)");
+    double fe_seq = bench::best_of_ms(kReps, [&] {
+        std::for_each(out.begin(), out.end(), [](double &x) { x = x * 1.0001 + 1.0; });
+    });
+    double fe_par = bench::best_of_ms(kReps, [&] {
+        day1::for_each(par, out.begin(), out.end(), [](double &x) { x = x * 1.0001 + 1.0; });
+    });
+    bench::report("std::for_each", fe_seq, "ms");
+    bench::report("day1::for_each(par)", fe_par, "ms");
+    bench::report_speedup("speedup", fe_seq, fe_par);
+
+    bench::print_header("inclusive_scan");
+    double sc_seq = bench::best_of_ms(kReps, [&] {
+        std::inclusive_scan(data.begin(), data.end(), out.begin());
+    });
+    double sc_par = bench::best_of_ms(kReps, [&] {
+        day1::inclusive_scan(par, data.begin(), data.end(), out.begin());
+    });
+    bench::report("std::inclusive_scan", sc_seq, "ms");
+    bench::report("day1::inclusive_scan(par)", sc_par, "ms");
+    bench::report_speedup("speedup", sc_seq, sc_par);
+    sink += out.back();
+
+    bench::print_header("sort of " + std::to_string(n) + " random uint64");
+    std::vector<std::uint64_t> original(n);
+    std::mt19937_64 rng(3);
+    for (auto &v : original) {
+        v = rng();
+    }
+    std::vector<std::uint64_t> work;
+    // Best of kReps sorts of a fresh copy; the copy stays outside the timing
+    auto time_sort = [&](auto &&sort) {
+        double best = 0;
+        for (int rep = 0; rep < kReps; ++rep) {
+            work = original;
+            double ms = bench::time_ms([&] { sort(work.begin(), work.end()); });
+            best = rep == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    };
+    double so_seq = time_sort([](auto first, auto last) { std::sort(first, last); });
+    double so_std_par = time_sort(
+        [](auto first, auto last) { std::sort(std::execution::par, first, last); });
+    double so_par = time_sort([&](auto first, auto last) { day1::sort(par, first, last); });
+    bench::report("std::sort", so_seq, "ms");
+    bench::report("std::sort(par)", so_std_par, "ms");
+    bench::report("day1::sort(par)", so_par, "ms");
+    bench::report_speedup("speedup vs std::sort", so_seq, so_par);
+
+    bench::do_not_optimize(sink);
+    if (!std::is_sorted(work.begin(), work.end())) {
+        std::cerr << "day1::sort produced unsorted output\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// day1/benchmarks/pool_allocator_bench.cpp
+// std::allocator vs day1::PoolAllocator under node-based containers
+//
+// Usage: pool_allocator_bench [elements=1M] [threads=hardware_concurrency]
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "pool_allocator.hpp"
+
+template <template <typename> class Alloc>
+struct Containers {
+    using List = std::list<std::uint64_t, Alloc<std::uint64_t>>;
+    using Map = std::map<std::uint64_t, std::uint64_t, std::less<>,
+                         Alloc<std::pair<const std::uint64_t, std::uint64_t>>>;
+    using HashMap = std::unordered_map<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>,
+                                       std::equal_to<>,
+                                       Alloc<std::pair<const std::uint64_t, std::uint64_t>>>;
+};
+
+template <typename List>
+std::uint64_t list_workload(std::size_t n) {
+    List list;
+    for (std::size_t i = 0; i < n; ++i) {
+        list.push_back(i);
+    }
+    // Churn: drop every other node and refill, the pattern that fragments heaps
+    for (auto it = list.begin(); it != list.end();) {
+        it = list.erase(it);
+        if (it != list.end()) {
+            ++it;
+        }
+    }
+    for (std::size_t i = 0; i < n / 2; ++i) {
+        list.push_front(i);
+    }
+    return std::accumulate(list.begin(), list.end(), std::uint64_t{0});
+}
+
+template <typename Map>
+std::uint64_t map_workload(const std::vector<std::uint64_t> &keys) {
+    Map map;
+    for (auto k : keys) {
+        map.emplace(k, k);
+    }
+    std::uint64_t sum = 0;
+    for (auto k : keys) {
+        sum += map.find(k)->second;
+    }
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+        map.erase(keys[i]);
+    }
+    return sum + map.size();
+}
+
+template <template <typename> class Alloc>
+void run_suite(const char *label, std::size_t n, const std::vector<std::uint64_t> &keys,
+               double (&out)[3]) {
+    using C = Containers<Alloc>;
+    out[0] = bench::best_of_ms(
+        3, [&] { bench::do_not_optimize(list_workload<typename C::List>(n)); });
+    out[1] = bench::best_of_ms(
+        3, [&] { bench::do_not_optimize(map_workload<typename C::Map>(keys)); });
+    out[2] = bench::best_of_ms(
+        3, [&] { bench::do_not_optimize(map_workload<typename C::HashMap>(keys)); });
+    bench::report(std::string("std::list   ") + label, out[0], "ms");
+    bench::report(std::string("std::map    ") + label, out[1], "ms");
+    bench::report(std::string("std::unordered_map ") + label, out[2], "ms");
+}
+
+template <template <typename> class Alloc>
+double threaded_list(std::size_t n, unsigned threads) {
+    using List = typename Containers<Alloc>::List;
+    return bench::time_ms([&] {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([n, threads] {
+                bench::do_not_optimize(list_workload<List>(n / threads));
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    });
+}
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 1'000'000);
+    const unsigned threads = static_cast<unsigned>(
+        bench::arg_count(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+
+    std::vector<std::uint64_t> keys(n);
+    std::mt19937_64 rng(42);
+    for (auto &k : keys) {
+        k = rng();
+    }
+
+    bench::print_header("Single-threaded node allocation (" + std::to_string(n) + " elements)");
+    double std_ms[3];
+    double pool_ms[3];
+    run_suite<std::allocator>("(std::allocator)", n, keys, std_ms);
+    run_suite<day1::PoolAllocator>("(PoolAllocator)", n, keys, pool_ms);
+    bench::report_speedup("list speedup", std_ms[0], pool_ms[0]);
+    bench::report_speedup("map speedup", std_ms[1], pool_ms[1]);
+    bench::report_speedup("unordered_map speedup", std_ms[2], pool_ms[2]);
+
+    bench::print_header("Multi-threaded list churn (" + std::to_string(threads) + " threads)");
+    double std_mt = threaded_list<std::allocator>(n, threads);
+    double pool_mt = threaded_list<day1::PoolAllocator>(n, threads);
+    bench::report("std::allocator", std_mt, "ms");
+    bench::report("PoolAllocator", pool_mt, "ms");
+    bench::report_speedup("speedup", std_mt, pool_mt);
+
+    bench::print_header("Pool statistics");
+    auto before = day1::pool_stats();
+    day1::pool_trim();
+    auto after = day1::pool_stats();
+    bench::report("chunks allocated (lifetime)",
+                  static_cast<double>(std::accumulate(
+                      after.classes.begin(), after.classes.end(), std::size_t{0},
+                      [](std::size_t s, const day1::PoolStats &c) {
+                          return s + c.chunks_allocated;
+                      })),
+                  "chunks");
+    bench::report("reserved before trim", before.bytes_reserved() / 1024.0, "KB");
+    bench::report("reserved after trim", after.bytes_reserved() / 1024.0, "KB");
+    bench::report("chunks released (lifetime)", static_cast<double>(after.chunks_released()),
+                  "chunks");
+    bench::report("large allocations", static_cast<double>(after.large_allocations), "calls");
+    return 0;
+}
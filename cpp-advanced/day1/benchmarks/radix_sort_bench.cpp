@@ -0,0 +1,112 @@
+// day1/benchmarks/radix_sort_bench.cpp
+// day1::radix_sort vs std::sort, std::sort(par) and day1::sort(par)
+//
+// Usage: radix_sort_bench [elements=10M] [threads=hardware_concurrency]
+// Sweep 1M..1B; at 1B the double and pair rows need ~16GB each.
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "radix_sort.hpp"
+
+bool g_ok = true;
+
+template <typename T, typename Less, typename Radix>
+void run_case(const std::string &label, const std::vector<T> &original, Less less,
+              Radix radix_par, const day1::execution::parallel_policy &par) {
+    bench::print_header(label + " (" + std::to_string(original.size()) + " elements)");
+    std::vector<T> expected = original;
+    double std_ms =
+        bench::time_ms([&] { std::stable_sort(expected.begin(), expected.end(), less); });
+
+    std::vector<T> work = original;
+    double std_unstable_ms = bench::time_ms([&] { std::sort(work.begin(), work.end(), less); });
+
+    work = original;
+    double std_par_ms =
+        bench::time_ms([&] { std::sort(std::execution::par, work.begin(), work.end(), less); });
+
+    work = original;
+    double pool_ms = bench::time_ms([&] { day1::sort(par, work.begin(), work.end(), less); });
+
+    work = original;
+    double radix_seq_ms = bench::time_ms([&] { radix_par(day1::execution::seq, work); });
+    g_ok = g_ok && work == expected;
+
+    work = original;
+    double radix_par_ms = bench::time_ms([&] { radix_par(par, work); });
+    g_ok = g_ok && work == expected;
+
+    bench::report("std::stable_sort", std_ms, "ms");
+    bench::report("std::sort", std_unstable_ms, "ms");
+    bench::report("std::sort(std::execution::par)", std_par_ms, "ms");
+    bench::report("day1::sort(par)", pool_ms, "ms");
+    bench::report("day1::radix_sort(seq)", radix_seq_ms, "ms");
+    bench::report("day1::radix_sort(par)", radix_par_ms, "ms");
+    bench::report_speedup("radix(par) vs std::sort", std_unstable_ms, radix_par_ms);
+    bench::report_speedup("radix(par) vs std::sort(par)", std_par_ms, radix_par_ms);
+}
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 10'000'000);
+    const unsigned threads = static_cast<unsigned>(
+        bench::arg_count(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+    day1::WorkStealingPool pool(threads);
+    const auto par = day1::execution::par.on(pool);
+    std::mt19937_64 rng(2024);
+
+    {
+        std::vector<std::int32_t> ints(n);
+        for (auto &v : ints) {
+            v = static_cast<std::int32_t>(rng());
+        }
+        run_case("int32 keys", ints, std::less<>{},
+                 [](auto policy, auto &v) { day1::radix_sort(policy, v.begin(), v.end()); }, par);
+    }
+    {
+        std::vector<std::uint64_t> wide(n);
+        for (auto &v : wide) {
+            v = rng();
+        }
+        run_case("uint64 keys", wide, std::less<>{},
+                 [](auto policy, auto &v) { day1::radix_sort(policy, v.begin(), v.end()); }, par);
+    }
+    {
+        std::normal_distribution<double> dist(0.0, 1e6);
+        std::vector<double> doubles(n);
+        for (auto &v : doubles) {
+            v = dist(rng);
+        }
+        run_case("double keys (mixed sign)", doubles, std::less<>{},
+                 [](auto policy, auto &v) { day1::radix_sort(policy, v.begin(), v.end()); }, par);
+    }
+    {
+        // Few distinct keys: stability is observable through the payload
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            pairs[i] = {static_cast<std::uint32_t>(rng() % 100'000), static_cast<std::uint32_t>(i)};
+        }
+        run_case(
+            "uint32 -> uint32 pairs by key", pairs,
+            [](const auto &a, const auto &b) { return a.first < b.first; },
+            [](auto policy, auto &v) {
+                day1::radix_sort(policy, v.begin(), v.end(),
+                                 [](const auto &kv) { return kv.first; });
+            },
+            par);
+    }
+
+    if (!g_ok) {
+        std::cerr << "radix_sort output differs from std::stable_sort\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// day1/benchmarks/resource_budget_bench.cpp
+// Entry-count capacity vs byte budgets on a mixed texture/sound workload
+//
+// Usage: resource_budget_bench [requests=2M]
+//
+// Textures cost 4MB and sounds 176KB (nominal sizes reported by
+// byte_size(); nothing that large is allocated). Requests are skewed over
+// 200 textures and 2K sounds, one in five a texture. Every configuration
+// aims at about 64MB:
+//
+//   - entry caps: 16 entries is 64MB if all are textures, 128 entries is
+//     64MB if about 1 in 10 are; neither holds for the actual mix
+//   - one manager with a 64MB byte limit
+//   - textures and sounds in separate managers sharing a 64MB budget, with
+//     48MB and 24MB sub-budgets
+//
+// Peak resident bytes show whether the limit holds; hit ratios show what
+// the memory buys.
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "resource_budget.hpp"
+#include "resource_manager.hpp"
+
+namespace {
+
+constexpr std::size_t kTextureBytes = 1024 * 1024 * 4;
+constexpr std::size_t kSoundBytes = 44100 * 2 * 2;
+constexpr std::size_t kMB = 1 << 20;
+
+struct Asset {
+    std::size_t bytes;
+    std::size_t byte_size() const {
+        return bytes;
+    }
+};
+
+std::unique_ptr<Asset> load_asset(const std::string &path) {
+    return std::make_unique<Asset>(Asset{path.ends_with(".png") ? kTextureBytes : kSoundBytes});
+}
+
+std::vector<std::string> make_requests(std::size_t count) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<std::string> requests;
+    requests.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const bool texture = u(rng) < 0.2;
+        const double x = u(rng);
+        const auto index = static_cast<std::size_t>((texture ? 200 : 2'000) * x * x * x);
+        requests.push_back(texture ? "tex/" + std::to_string(index) + ".png"
+                                   : "sfx/" + std::to_string(index) + ".wav");
+    }
+    return requests;
+}
+
+struct Result {
+    double ns_per_op;
+    std::size_t peak_bytes;
+    double hit_ratio;
+};
+
+// get() routes each request; resident() and stats() sum over managers
+template <typename Get, typename Resident, typename Stats>
+Result replay(const std::vector<std::string> &requests, Get get, Resident resident, Stats stats) {
+    std::size_t peak = 0;
+    std::uint64_t sink = 0;
+    double ms = bench::time_ms([&] {
+        for (const auto &path : requests) {
+            sink += get(path)->bytes;
+            peak = std::max(peak, resident());
+        }
+    });
+    bench::do_not_optimize(sink);
+    const day1::CacheStats s = stats();
+    return {ms * 1e6 / static_cast<double>(requests.size()), peak, s.hit_ratio()};
+}
+
+void report(const std::string &name, const Result &r) {
+    bench::report(name + ": peak resident", static_cast<double>(r.peak_bytes) / kMB, "MB");
+    bench::report(name + ": hit ratio", r.hit_ratio, "");
+    bench::report(name + ": get()", r.ns_per_op, "ns/op");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t count = bench::arg_count(argc, argv, 1, 2'000'000);
+    const auto requests = make_requests(count);
+    bench::print_header("mixed textures/sounds, " + std::to_string(count) + " requests, ~64MB");
+
+    for (std::size_t entries : {16, 128}) {
+        day1::ResourceManager<Asset> manager(entries, load_asset);
+        report(std::to_string(entries) + "-entry cap",
+               replay(
+                   requests, [&](const std::string &p) { return manager.get(p); },
+                   [&] { return manager.resident_bytes(); }, [&] { return manager.stats(); }));
+    }
+    {
+        day1::ResourceManager<Asset> manager({.max_bytes = 64 * kMB}, load_asset);
+        report("64MB byte limit",
+               replay(
+                   requests, [&](const std::string &p) { return manager.get(p); },
+                   [&] { return manager.resident_bytes(); }, [&] { return manager.stats(); }));
+    }
+    {
+        day1::ResourceBudget budget(64 * kMB);
+        day1::ResourceManager<Asset> textures({.max_bytes = 48 * kMB, .shared = &budget},
+                                              load_asset);
+        day1::ResourceManager<Asset> sounds({.max_bytes = 24 * kMB, .shared = &budget}, load_asset);
+        Result r = replay(
+            requests,
+            [&](const std::string &p) {
+                return p.ends_with(".png") ? textures.get(p) : sounds.get(p);
+            },
+            [&] { return budget.resident_bytes(); },
+            [&] {
+                day1::CacheStats total = textures.stats();
+                total.hits += sounds.stats().hits;
+                total.misses += sounds.stats().misses;
+                return total;
+            });
+        report("64MB shared, 48MB/24MB per type", r);
+        bench::report("  texture hit ratio", textures.stats().hit_ratio(), "");
+        bench::report("  sound hit ratio", sounds.stats().hit_ratio(), "");
+        bench::report("  evictions by the shared budget", static_cast<double>(budget.evictions()),
+                      "");
+    }
+    return 0;
+}
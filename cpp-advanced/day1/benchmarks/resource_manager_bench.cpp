@@ -0,0 +1,151 @@
+// day1/benchmarks/resource_manager_bench.cpp
+// day1::ResourceManager (O(1) LRU) vs the linear-scan evict_lru() design
+//
+// Usage: resource_manager_bench [cached_entries=1M]
+//
+// Both caches are filled to capacity, then every request misses, so every
+// request evicts. The linear-scan design walks the whole unordered_map on
+// each eviction, so it only gets a handful of misses.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "resource_manager.hpp"
+
+namespace {
+
+struct Blob {
+    std::uint64_t id;
+};
+
+std::unique_ptr<Blob> load_blob(const std::string &path) {
+    return std::make_unique<Blob>(Blob{path.size()});
+}
+
+// The original design: last_access timestamps and a full scan per eviction
+template <typename Resource>
+class LinearScanResourceManager {
+   private:
+    struct ResourceData {
+        std::shared_ptr<Resource> resource;
+        std::chrono::steady_clock::time_point last_access;
+        std::size_t access_count = 0;
+    };
+
+    std::unordered_map<std::string, ResourceData> cache_;
+    std::function<std::unique_ptr<Resource>(const std::string &)> loader_;
+    std::size_t max_cache_size_;
+
+   public:
+    LinearScanResourceManager(std::size_t max_size,
+                              std::function<std::unique_ptr<Resource>(const std::string &)> loader)
+        : loader_(std::move(loader)), max_cache_size_(max_size) {}
+
+    std::shared_ptr<Resource> get(const std::string &path) {
+        auto it = cache_.find(path);
+        if (it != cache_.end()) {
+            it->second.last_access = std::chrono::steady_clock::now();
+            it->second.access_count++;
+            return it->second.resource;
+        }
+        if (cache_.size() >= max_cache_size_) {
+            evict_lru();
+        }
+        auto resource = loader_(path);
+        if (!resource) {
+            return nullptr;
+        }
+        auto shared = std::shared_ptr<Resource>(std::move(resource));
+        cache_[path] = {shared, std::chrono::steady_clock::now(), 1};
+        return shared;
+    }
+
+   private:
+    void evict_lru() {
+        auto oldest = cache_.begin();
+        auto oldest_time = oldest->second.last_access;
+        for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+            if (it->second.last_access < oldest_time) {
+                oldest = it;
+                oldest_time = it->second.last_access;
+            }
+        }
+        cache_.erase(oldest);
+    }
+};
+
+std::vector<std::string> make_paths(std::size_t first, std::size_t count) {
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for (std::size_t i = first; i < first + count; ++i) {
+        paths.push_back("assets/textures/tile_" + std::to_string(i) + ".png");
+    }
+    return paths;
+}
+
+struct Timings {
+    double hit_ns;
+    double miss_ns;
+};
+
+// Fill to capacity, time hits on the cached set, then time misses
+template <typename Manager>
+Timings measure(Manager &manager, const std::vector<std::string> &resident,
+                const std::vector<std::string> &hits, const std::vector<std::string> &misses) {
+    for (const auto &path : resident) {
+        manager.get(path);
+    }
+    std::uint64_t sink = 0;
+    double hit_ms = bench::time_ms([&] {
+        for (const auto &path : hits) {
+            sink += manager.get(path)->id;
+        }
+    });
+    double miss_ms = bench::time_ms([&] {
+        for (const auto &path : misses) {
+            sink += manager.get(path)->id;
+        }
+    });
+    bench::do_not_optimize(sink);
+    return {hit_ms * 1e6 / static_cast<double>(hits.size()),
+            miss_ms * 1e6 / static_cast<double>(misses.size())};
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 1'000'000);
+    const std::size_t lookups = std::min<std::size_t>(n, 1'000'000);
+    const std::size_t linear_misses = 20;
+
+    const auto resident = make_paths(0, n);
+    const auto missing = make_paths(n, lookups);
+    std::vector<std::string> hits;
+    hits.reserve(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        hits.push_back(resident[(i * 7919) % n]);
+    }
+
+    bench::print_header("ResourceManager at capacity, " + std::to_string(n) + " cached entries");
+    day1::ResourceManager<Blob> lru(n, load_blob);
+    Timings fast = measure(lru, resident, hits, missing);
+
+    LinearScanResourceManager<Blob> linear(n, load_blob);
+    const std::vector<std::string> few_misses(missing.begin(),
+                                              missing.begin() + std::min(linear_misses, lookups));
+    Timings slow = measure(linear, resident, hits, few_misses);
+
+    bench::report("linear-scan evict_lru: hit", slow.hit_ns, "ns/op");
+    bench::report("O(1) LRU: hit", fast.hit_ns, "ns/op");
+    bench::report("linear-scan evict_lru: miss + evict", slow.miss_ns, "ns/op");
+    bench::report("O(1) LRU: miss + evict", fast.miss_ns, "ns/op");
+    bench::report_speedup("miss speedup", slow.miss_ns, fast.miss_ns);
+    return 0;
+}
@@ -0,0 +1,159 @@
+// day1/benchmarks/resource_prefetch_bench.cpp
+// ConcurrentResourceManager: async loads, prefetch and demand priority
+//
+// Usage: resource_prefetch_bench [load_us=2000] [io_threads=4]
+//
+// The loader sleeps load_us like a disk read, so these rows measure how
+// well waiting is overlapped, not CPU throughput:
+//
+//   - cold batch: 64 paths through get() one after another vs get_async()
+//     for all of them, then waiting
+//   - streaming: a consumer walks 64 assets doing 1ms of work on each,
+//     with and without prefetching the next few paths
+//   - pre-emption: the prefetch queue is full, then single demand loads
+//     arrive; they should take about one load_us, not wait for the backlog
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "concurrent_resource_manager.hpp"
+
+namespace {
+
+struct Blob {
+    std::uint64_t id;
+};
+
+using Manager = day1::ConcurrentResourceManager<Blob>;
+
+std::vector<std::string> make_paths(const std::string &prefix, std::size_t count) {
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < count; ++i) {
+        paths.push_back(prefix + std::to_string(i) + ".bin");
+    }
+    return paths;
+}
+
+Manager make_manager(std::chrono::microseconds load_time, std::size_t io_threads) {
+    day1::ConcurrentResourceOptions options;
+    options.io_threads = io_threads;
+    options.max_queued_prefetches = 256;
+    return Manager(
+        4096,
+        [load_time](const std::string &path) {
+            std::this_thread::sleep_for(load_time);
+            return std::make_unique<Blob>(Blob{path.size()});
+        },
+        options);
+}
+
+void spin_for(std::chrono::microseconds work) {
+    const auto until = std::chrono::steady_clock::now() + work;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const auto load_time = std::chrono::microseconds(bench::arg_count(argc, argv, 1, 2000));
+    const std::size_t io_threads = bench::arg_count(argc, argv, 2, 4);
+    constexpr std::size_t kBatch = 64;
+    constexpr std::size_t kLookahead = 8;
+    constexpr std::size_t kBacklog = 256;
+    constexpr std::size_t kDemands = 16;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << ", io threads: " << io_threads << "\n";
+
+    bench::print_header("cold batch: " + std::to_string(kBatch) + " paths");
+    const auto batch = make_paths("assets/batch_", kBatch);
+    std::uint64_t sink = 0;
+    double sync_ms = 0;
+    {
+        Manager manager = make_manager(load_time, io_threads);
+        sync_ms = bench::time_ms([&] {
+            for (const auto &path : batch) {
+                sink += manager.get(path)->id;
+            }
+        });
+    }
+    double async_ms = 0;
+    {
+        Manager manager = make_manager(load_time, io_threads);
+        async_ms = bench::time_ms([&] {
+            std::vector<Manager::SharedLoad> pending;
+            for (const auto &path : batch) {
+                pending.push_back(manager.get_async(path));
+            }
+            for (auto &f : pending) {
+                sink += f.get()->id;
+            }
+        });
+    }
+    bench::report("get() one by one", sync_ms, "ms");
+    bench::report("get_async() all, then wait", async_ms, "ms");
+    bench::report_speedup("async speedup", sync_ms, async_ms);
+
+    bench::print_header("streaming: " + std::to_string(kBatch) + " assets, 1ms work each");
+    const auto level = make_paths("assets/level_", kBatch);
+    double plain_ms = 0;
+    {
+        Manager manager = make_manager(load_time, io_threads);
+        plain_ms = bench::time_ms([&] {
+            for (const auto &path : level) {
+                sink += manager.get(path)->id;
+                spin_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    double prefetch_ms = 0;
+    {
+        Manager manager = make_manager(load_time, io_threads);
+        prefetch_ms = bench::time_ms([&] {
+            for (std::size_t i = 0; i < level.size(); ++i) {
+                const std::size_t ahead = std::min(level.size(), i + 1 + kLookahead);
+                if (i + 1 < ahead) {
+                    manager.prefetch(std::span(level).subspan(i + 1, ahead - i - 1));
+                }
+                sink += manager.get(level[i])->id;
+                spin_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    bench::report("no prefetch", plain_ms, "ms");
+    bench::report("prefetch next " + std::to_string(kLookahead), prefetch_ms, "ms");
+    bench::report_speedup("prefetch speedup", plain_ms, prefetch_ms);
+
+    bench::print_header("pre-emption: " + std::to_string(kBacklog) + " prefetches queued");
+    {
+        Manager manager = make_manager(load_time, io_threads);
+        const auto backlog = make_paths("assets/speculative_", kBacklog);
+        const auto wanted = make_paths("assets/wanted_", kDemands);
+        double drain_ms = bench::time_ms([&] {
+            manager.prefetch(backlog);
+            double demand_ms = 0;
+            for (const auto &path : wanted) {
+                demand_ms += bench::time_ms([&] { sink += manager.get_async(path).get()->id; });
+            }
+            // A prefetched path that becomes a demand jumps the queue as well
+            const double promoted_ms =
+                bench::time_ms([&] { sink += manager.get(backlog.back())->id; });
+            for (const auto &path : backlog) {
+                sink += manager.get(path)->id;
+            }
+            bench::report("demand load latency", demand_ms / kDemands, "ms");
+            bench::report("promoted prefetch latency", promoted_ms, "ms");
+        });
+        bench::report("whole backlog drained after", drain_ms, "ms");
+    }
+    bench::do_not_optimize(sink);
+    return 0;
+}
@@ -0,0 +1,164 @@
+// day1/benchmarks/simd_reductions_bench.cpp
+// day1::simd reductions vs std::accumulate / std::reduce, per ISA tier
+//
+// Usage: simd_reductions_bench [elements=10M]
+//
+// Large inputs are memory bound; run with e.g. 32K to see the in-cache
+// compute rate. Accuracy is the relative error against a long double
+// compensated sum, in units of double epsilon.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "common/aligned.hpp"
+#include "simd_reductions.hpp"
+
+namespace {
+
+constexpr int kReps = 5;
+
+double gb_per_s(std::size_t bytes, double ms) {
+    return static_cast<double>(bytes) / (ms * 1e6);
+}
+
+double eps_error(double value, long double reference) {
+    return static_cast<double>(std::fabs((value - reference) / reference) / DBL_EPSILON);
+}
+
+long double reference_sum(std::span<const double> values) {
+    long double s = 0;
+    long double c = 0;
+    for (double v : values) {
+        long double t = s + v;
+        c += std::fabs(s) >= std::fabs(v) ? (s - t) + v : (v - t) + s;
+        s = t;
+    }
+    return s + c;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = bench::arg_count(argc, argv, 1, 10'000'000);
+    const std::size_t bytes = n * sizeof(double);
+
+    // Mixed signs and 12 decades of magnitude make rounding error visible
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> mantissa(0.0, 1.0);
+    std::uniform_real_distribution<double> exponent(-6.0, 6.0);
+    // Cache-line aligned, so no vector load straddles two lines
+    common::aligned_vector<double> values(n);
+    for (auto &v : values) {
+        v = (rng() & 1 ? 1.0 : -1.0) * mantissa(rng) * std::pow(10.0, exponent(rng));
+    }
+    common::aligned_vector<double> weights(n);
+    for (auto &w : weights) {
+        w = mantissa(rng);
+    }
+    common::aligned_vector<std::uint32_t> keys(n);
+    for (auto &k : keys) {
+        k = static_cast<std::uint32_t>(rng() % 8);
+    }
+    const long double reference = reference_sum(values);
+    const std::span<const double> span(values);
+    double sink = 0;
+
+    bench::print_header("std baselines, " + std::to_string(n) + " doubles");
+    double result = 0;
+    double ms = bench::best_of_ms(kReps, [&] {
+        result = std::accumulate(values.begin(), values.end(), 0.0);
+    });
+    bench::report("std::accumulate", gb_per_s(bytes, ms), "GB/s");
+    bench::report("std::accumulate error", eps_error(result, reference), "eps");
+    ms = bench::best_of_ms(kReps, [&] { result = std::reduce(values.begin(), values.end(), 0.0); });
+    bench::report("std::reduce", gb_per_s(bytes, ms), "GB/s");
+    bench::report("std::reduce error", eps_error(result, reference), "eps");
+    ms = bench::best_of_ms(kReps, [&] {
+        result = std::reduce(std::execution::unseq, values.begin(), values.end(), 0.0);
+    });
+    bench::report("std::reduce(unseq)", gb_per_s(bytes, ms), "GB/s");
+    bench::report("std::reduce(unseq) error", eps_error(result, reference), "eps");
+    ms = bench::best_of_ms(kReps, [&] {
+        sink += std::inner_product(values.begin(), values.end(), weights.begin(), 0.0);
+    });
+    bench::report("std::inner_product", gb_per_s(2 * bytes, ms), "GB/s");
+    ms = bench::best_of_ms(kReps, [&] {
+        auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+        sink += *lo + *hi;
+    });
+    bench::report("std::minmax_element", gb_per_s(bytes, ms), "GB/s");
+    std::size_t std_argmin = 0;
+    ms = bench::best_of_ms(kReps, [&] {
+        std_argmin = static_cast<std::size_t>(std::min_element(values.begin(), values.end()) -
+                                              values.begin());
+    });
+    bench::report("std::min_element", gb_per_s(bytes, ms), "GB/s");
+    std::vector<std::uint64_t> std_counts(8);
+    ms = bench::best_of_ms(kReps, [&] {
+        std::fill(std_counts.begin(), std_counts.end(), 0);
+        for (std::uint32_t k : keys) {
+            ++std_counts[k];
+        }
+    });
+    bench::report("histogram, 8 buckets (scalar loop)", gb_per_s(n * sizeof(std::uint32_t), ms),
+                  "GB/s");
+
+    bool ok = true;
+    // One level per kernel set; DAY1_CPU_LEVEL caps the sweep
+    const auto startup = day1::cpu::active_level();
+    for (auto level : {day1::cpu::Level::baseline, day1::cpu::Level::v3, day1::cpu::Level::v4}) {
+        if (level > startup) {
+            break;
+        }
+        day1::cpu::force_level(level);
+        const auto tier = day1::simd::active_isa();
+        const std::string tag = std::string(" [") + day1::simd::isa_name(tier) + "]";
+        bench::print_header(std::string("day1::simd") + tag);
+
+        for (auto [mode, name] : {std::pair{day1::simd::SumMode::fast, "sum fast"},
+                                  std::pair{day1::simd::SumMode::pairwise, "sum pairwise"},
+                                  std::pair{day1::simd::SumMode::compensated, "sum compensated"}}) {
+            ms = bench::best_of_ms(kReps, [&] { result = day1::simd::sum(span, mode); });
+            bench::report(name + tag, gb_per_s(bytes, ms), "GB/s");
+            bench::report(std::string(name) + " error" + tag, eps_error(result, reference), "eps");
+        }
+        ms = bench::best_of_ms(kReps, [&] {
+            sink += day1::simd::dot(span, std::span<const double>(weights));
+        });
+        bench::report("dot" + tag, gb_per_s(2 * bytes, ms), "GB/s");
+        ms = bench::best_of_ms(kReps, [&] {
+            auto [lo, hi] = day1::simd::min_max(span);
+            sink += lo + hi;
+        });
+        bench::report("min_max" + tag, gb_per_s(bytes, ms), "GB/s");
+        std::size_t at = 0;
+        ms = bench::best_of_ms(kReps, [&] { at = day1::simd::argmin(span); });
+        ok = ok && at == std_argmin;
+        bench::report("argmin" + tag, gb_per_s(bytes, ms), "GB/s");
+        std::vector<std::uint64_t> counts(8);
+        ms = bench::best_of_ms(kReps, [&] {
+            std::fill(counts.begin(), counts.end(), 0);
+            day1::simd::histogram(std::span<const std::uint32_t>(keys), counts);
+        });
+        ok = ok && counts == std_counts;
+        bench::report("histogram, 8 buckets" + tag, gb_per_s(n * sizeof(std::uint32_t), ms),
+                      "GB/s");
+    }
+    bench::do_not_optimize(sink);
+
+    if (!ok) {
+        std::cerr << "day1::simd results differ from the standard algorithms\n";
+        return 1;
+    }
+    return 0;
+}
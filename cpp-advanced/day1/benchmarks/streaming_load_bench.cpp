@@ -0,0 +1,181 @@
+// day1/benchmarks/streaming_load_bench.cpp
+// Time to first use: whole-file loads vs streaming decoders
+//
+// Usage: streaming_load_bench [megabytes=64] [dir=/tmp]
+//
+// Two files of about the given size:
+//
+//   - sound: mono 16-bit samples at 44.1kHz, copied as they are; first use
+//     is the first second of audio
+//   - texture: RGB8 rows expanded to RGBA8; first use is the top 64 rows
+//
+// A whole-file load reads everything with pread() and then decodes it, so
+// its first use is its completion. The streaming loads (streaming_loader.hpp)
+// decode 256KB chunks on an I/O thread from an mmap or from pread(); the
+// caller waits for the first-use prefix, then for the rest.
+//
+// "page cache dropped" runs first ask the kernel to drop the file's cached
+// pages (posix_fadvise), so the bytes come from the disk. Systems without
+// POSIX_FADV_DONTNEED (macOS) keep the pages, and those runs read from
+// memory like the others. Times are the mean of 5 runs, from the start of
+// the load.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "load_scheduler.hpp"
+#include "streaming_loader.hpp"
+
+namespace {
+
+constexpr int kRuns = 5;
+constexpr std::size_t kSampleRate = 44100;
+constexpr std::size_t kTextureWidth = 4096;
+
+struct Rgba8 {
+    std::uint8_t r, g, b, a;
+};
+
+void expand_rgb(std::span<const std::byte> rgb, std::span<Rgba8> out) {
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        out[i] = {std::to_integer<std::uint8_t>(rgb[3 * i]),
+                  std::to_integer<std::uint8_t>(rgb[3 * i + 1]),
+                  std::to_integer<std::uint8_t>(rgb[3 * i + 2]), 255};
+    }
+}
+
+void copy_samples(std::span<const std::byte> in, std::span<std::int16_t> out) {
+    std::memcpy(out.data(), in.data(), in.size());
+}
+
+void write_file(const std::string &path, std::size_t bytes) {
+    std::vector<char> data(bytes);
+    for (std::size_t i = 0; i < bytes; ++i) {
+        data[i] = static_cast<char>(i * 131 >> 3);
+    }
+    std::ofstream(path, std::ios::binary).write(data.data(), static_cast<std::streamsize>(bytes));
+}
+
+void drop_page_cache(const std::string &file) {
+#ifdef POSIX_FADV_DONTNEED
+    const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#endif
+}
+
+struct Times {
+    double first_use = 0;
+    double complete = 0;
+};
+
+// Reads the whole file into memory, then decodes it
+template <typename T>
+Times whole_file(const std::string &path, std::size_t count, std::size_t encoded_size,
+                 void (*decode)(std::span<const std::byte>, std::span<T>)) {
+    const common::Stopwatch watch;
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    std::vector<std::byte> encoded(count * encoded_size);
+    for (std::size_t done = 0; done < encoded.size();) {
+        const ssize_t n = ::pread(fd, encoded.data() + done, encoded.size() - done,
+                                  static_cast<off_t>(done));
+        if (n <= 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    auto decoded = std::make_unique_for_overwrite<T[]>(count);
+    decode(encoded, std::span<T>(decoded.get(), count));
+    bench::do_not_optimize(decoded[0]);
+    const double ms = watch.elapsed_ms();
+    return {ms, ms};
+}
+
+template <typename T>
+Times streamed(const std::string &path, std::size_t count, std::size_t encoded_size,
+               void (*decode)(std::span<const std::byte>, std::span<T>), std::size_t first_use,
+               day1::StreamSource source) {
+    day1::LoadScheduler io(1, 0);
+    const common::Stopwatch watch;
+    auto buffer = day1::stream_file<T>(
+        io, path, {.offset = 0, .count = count, .encoded_size = encoded_size, .decode = decode},
+        {.source = source});
+    bench::do_not_optimize(buffer.wait(first_use)[0]);
+    Times t;
+    t.first_use = watch.elapsed_ms();
+    bench::do_not_optimize(buffer.wait_all()[count - 1]);
+    t.complete = watch.elapsed_ms();
+    return t;
+}
+
+template <typename Load>
+void measure(const std::string &name, const std::string &path, bool cold, Load load) {
+    Times sum;
+    for (int run = 0; run < kRuns; ++run) {
+        if (cold) {
+            drop_page_cache(path);
+        }
+        const Times t = load();
+        sum.first_use += t.first_use;
+        sum.complete += t.complete;
+    }
+    bench::report(name + ": first use", sum.first_use / kRuns, "ms");
+    bench::report(name + ": complete", sum.complete / kRuns, "ms");
+}
+
+template <typename T>
+void compare(const std::string &kind, const std::string &path, std::size_t count,
+             std::size_t encoded_size, void (*decode)(std::span<const std::byte>, std::span<T>),
+             std::size_t first_use) {
+    for (bool cold : {false, true}) {
+        const std::string cache = cold ? ", page cache dropped" : "";
+        measure(kind + " whole file" + cache, path, cold,
+                [&] { return whole_file<T>(path, count, encoded_size, decode); });
+        measure(kind + " stream mmap" + cache, path, cold, [&] {
+            return streamed<T>(path, count, encoded_size, decode, first_use,
+                               day1::StreamSource::mmap);
+        });
+        measure(kind + " stream pread" + cache, path, cold, [&] {
+            return streamed<T>(path, count, encoded_size, decode, first_use,
+                               day1::StreamSource::pread);
+        });
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t megabytes = bench::arg_count(argc, argv, 1, 64);
+    const std::filesystem::path dir = argc > 2 ? argv[2] : "/tmp";
+    const std::string sound_path = (dir / "day1_stream.snd").string();
+    const std::string texture_path = (dir / "day1_stream.tex").string();
+
+    const std::size_t samples = (megabytes << 20) / sizeof(std::int16_t);
+    const std::size_t rows = (megabytes << 20) / (kTextureWidth * 3);
+    write_file(sound_path, samples * sizeof(std::int16_t));
+    write_file(texture_path, rows * kTextureWidth * 3);
+
+    bench::print_header(std::to_string(megabytes) + "MB sound and texture files");
+    compare<std::int16_t>("sound", sound_path, samples, sizeof(std::int16_t), copy_samples,
+                          kSampleRate);
+    compare<Rgba8>("texture", texture_path, rows * kTextureWidth, 3, expand_rgb,
+                   64 * kTextureWidth);
+
+    std::filesystem::remove(sound_path);
+    std::filesystem::remove(texture_path);
+    return 0;
+}
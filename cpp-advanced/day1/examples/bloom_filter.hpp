@@ -0,0 +1,485 @@
+// day1/examples/bloom_filter.hpp
+// Split-block Bloom filters: short-circuit container lookups that miss
+//
+// A classic Bloom filter scatters k bits over the whole array, so one query
+// costs k cache misses. A blocked filter first picks one 32-byte block (half
+// a cache line, always within one line) from the hash, then sets one bit in
+// each of the block's eight 32-bit words. The eight bit positions come from
+// one multiply by eight odd salts, which is a single AVX2 instruction, and a
+// query is one load plus one test. The AVX2 path is chosen at run time from
+// cpu::active_level() (cpu_dispatch.hpp), so portable builds use it too:
+//
+//     day1::BlockedBloomFilter<std::string> seen(expected_words, 0.01);
+//     for (auto &w : words) seen.insert(w);
+//     if (seen.contains(sv) && words.contains(sv)) { ... }  // misses skip the set
+//
+// False positives happen (at about the configured rate), false negatives
+// never do. CountingBloomFilter keeps 4-bit counters instead of bits so keys
+// can be erased, at four times the memory.
+//
+// save()/load() write the raw blocks in native byte order; a filter must be
+// loaded with the same Hash (and, for std::hash, the same standard library)
+// it was built with.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cpu_dispatch.hpp"
+#include "flat_hash_map.hpp"
+
+#if DAY1_CPU_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace day1 {
+
+namespace bloom_detail {
+
+inline constexpr std::size_t kWordsPerBlock = 8;
+inline constexpr std::size_t kBitsPerBlock = kWordsPerBlock * 32;
+
+// Odd multipliers from the Parquet split-block Bloom filter spec
+alignas(32) inline constexpr std::uint32_t kSalts[kWordsPerBlock] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+struct alignas(32) Block {
+    std::uint32_t words[kWordsPerBlock];
+};
+
+#if DAY1_CPU_X86_DISPATCH
+DAY1_TARGET_V3 inline __m256i probe_bits_v3(std::uint32_t key) {
+    __m256i salts = _mm256_load_si256(reinterpret_cast<const __m256i *>(kSalts));
+    __m256i product = _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts);
+    return _mm256_srli_epi32(product, 27);
+}
+
+// One bit per word, shifted into place without leaving the register
+DAY1_TARGET_V3 inline __m256i make_mask_v3(std::uint32_t key) {
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), probe_bits_v3(key));
+}
+
+DAY1_TARGET_V3 inline void store_probe_bits_v3(std::uint32_t key,
+                                               std::uint32_t (&bits)[kWordsPerBlock]) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(bits), probe_bits_v3(key));
+}
+
+DAY1_TARGET_V3 inline void block_insert_v3(Block &block, std::uint32_t key) {
+    auto *p = reinterpret_cast<__m256i *>(block.words);
+    _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), make_mask_v3(key)));
+}
+
+// testc: true when every mask bit is also set in the block
+DAY1_TARGET_V3 inline bool block_contains_v3(const Block &block, std::uint32_t key) {
+    return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i *>(block.words)),
+                              make_mask_v3(key));
+}
+#endif
+
+// Bit index (0..31) probed in each word: top 5 bits of key * salt
+inline void probe_bits(std::uint32_t key, std::uint32_t (&bits)[kWordsPerBlock]) {
+#if DAY1_CPU_X86_DISPATCH
+    if (cpu::active_level() >= cpu::Level::v3) {
+        return store_probe_bits_v3(key, bits);
+    }
+#endif
+    for (std::size_t i = 0; i < kWordsPerBlock; ++i) {
+        bits[i] = (key * kSalts[i]) >> 27;
+    }
+}
+
+inline Block make_mask(std::uint32_t key) {
+    Block mask;
+    for (std::size_t i = 0; i < kWordsPerBlock; ++i) {
+        mask.words[i] = std::uint32_t{1} << ((key * kSalts[i]) >> 27);
+    }
+    return mask;
+}
+
+inline void block_insert(Block &block, std::uint32_t key) {
+#if DAY1_CPU_X86_DISPATCH
+    if (cpu::active_level() >= cpu::Level::v3) {
+        return block_insert_v3(block, key);
+    }
+#endif
+    Block mask = make_mask(key);
+    for (std::size_t i = 0; i < kWordsPerBlock; ++i) {
+        block.words[i] |= mask.words[i];
+    }
+}
+
+inline bool block_contains(const Block &block, std::uint32_t key) {
+#if DAY1_CPU_X86_DISPATCH
+    if (cpu::active_level() >= cpu::Level::v3) {
+        return block_contains_v3(block, key);
+    }
+#endif
+    Block mask = make_mask(key);
+    std::uint32_t missing = 0;
+    for (std::size_t i = 0; i < kWordsPerBlock; ++i) {
+        missing |= mask.words[i] & ~block.words[i];
+    }
+    return missing == 0;
+}
+
+// Expected false-positive rate at a given load: keys per block are Poisson
+// distributed, and a query hits when all eight of its word bits are set
+inline double false_positive_rate(double bits_per_key) {
+    if (bits_per_key <= 0) {
+        return 1.0;
+    }
+    const double lambda = static_cast<double>(kBitsPerBlock) / bits_per_key;
+    double rate = 0;
+    double poisson = std::exp(-lambda);  // P(j = 0)
+    const auto limit = static_cast<int>(lambda + 10 * std::sqrt(lambda) + 20);
+    for (int j = 0; j <= limit; ++j) {
+        if (j > 0) {
+            poisson *= lambda / j;
+        }
+        double word_hit = 1.0 - std::pow(31.0 / 32.0, j);
+        rate += poisson * std::pow(word_hit, static_cast<double>(kWordsPerBlock));
+    }
+    return std::min(1.0, rate);
+}
+
+// Smallest bits-per-key (to 1/16 bit) reaching the requested rate
+inline double bits_per_key_for(double target_rate) {
+    if (!(target_rate > 0 && target_rate < 1)) {
+        throw std::invalid_argument("Bloom filter false-positive rate must be in (0, 1)");
+    }
+    double lo = 1;
+    double hi = 2;
+    while (false_positive_rate(hi) > target_rate) {
+        lo = hi;
+        hi *= 2;
+    }
+    while (hi - lo > 1.0 / 16) {
+        double mid = (lo + hi) / 2;
+        (false_positive_rate(mid) > target_rate ? lo : hi) = mid;
+    }
+    return hi;
+}
+
+inline std::size_t blocks_for(std::size_t expected_keys, double target_rate) {
+    const double bits = static_cast<double>(std::max<std::size_t>(1, expected_keys)) *
+                        bits_per_key_for(target_rate);
+    return std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(bits / kBitsPerBlock)));
+}
+
+// Block index from the high hash bits (multiply-shift instead of modulo),
+// in-block probes from the low 32 bits
+inline std::size_t block_index(std::size_t hash, std::size_t blocks) {
+    return static_cast<std::size_t>((static_cast<hash_detail::uint128>(hash) * blocks) >> 64);
+}
+
+struct FileHeader {
+    char magic[8];
+    std::uint64_t blocks;
+    std::uint64_t inserted;
+};
+
+inline void write_header(std::ostream &out, const char (&magic)[9], std::uint64_t blocks,
+                         std::uint64_t inserted) {
+    FileHeader header{};
+    std::memcpy(header.magic, magic, sizeof header.magic);
+    header.blocks = blocks;
+    header.inserted = inserted;
+    out.write(reinterpret_cast<const char *>(&header), sizeof header);
+}
+
+inline FileHeader read_header(std::istream &in, const char (&magic)[9]) {
+    FileHeader header{};
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof header) ||
+        std::memcmp(header.magic, magic, sizeof header.magic) != 0 || header.blocks == 0) {
+        throw std::runtime_error("not a serialized Bloom filter of this kind");
+    }
+    return header;
+}
+
+inline constexpr char kBloomMagic[9] = "D1BLOOM1";
+inline constexpr char kCountingMagic[9] = "D1CBLOM1";
+
+}  // namespace bloom_detail
+
+// Hashable with Hash; transparent hashes (e.g. string_hash) accept their
+// heterogeneous argument types as well
+template <typename K, typename Hash>
+concept bloom_hashable = std::is_invocable_r_v<std::size_t, const Hash &, const K &>;
+
+template <typename Key, typename Hash = default_hash<Key>>
+class BlockedBloomFilter {
+   private:
+    std::vector<bloom_detail::Block> blocks_;
+    std::size_t inserted_ = 0;
+    Hash hash_;
+
+    template <typename K>
+    std::size_t hash_of(const K &key) const {
+        return hash_detail::mix(hash_(key));
+    }
+
+    struct blocks_tag {};
+    BlockedBloomFilter(blocks_tag, std::size_t blocks, const Hash &hash)
+        : blocks_(blocks, bloom_detail::Block{}), hash_(hash) {}
+
+    template <typename, typename>
+    friend class CountingBloomFilter;
+
+   public:
+    // Sized for expected_keys insertions at the target false-positive rate
+    explicit BlockedBloomFilter(std::size_t expected_keys, double false_positive_rate = 0.01,
+                                const Hash &hash = Hash())
+        : BlockedBloomFilter(blocks_tag{},
+                             bloom_detail::blocks_for(expected_keys, false_positive_rate), hash) {}
+
+    template <bloom_hashable<Hash> K>
+    void insert(const K &key) {
+        std::size_t h = hash_of(key);
+        bloom_detail::block_insert(blocks_[bloom_detail::block_index(h, blocks_.size())],
+                                   static_cast<std::uint32_t>(h));
+        ++inserted_;
+    }
+
+    template <bloom_hashable<Hash> K>
+    bool contains(const K &key) const {
+        std::size_t h = hash_of(key);
+        return bloom_detail::block_contains(blocks_[bloom_detail::block_index(h, blocks_.size())],
+                                            static_cast<std::uint32_t>(h));
+    }
+
+    // Union with a filter of the same geometry (e.g. one built per shard)
+    void merge(const BlockedBloomFilter &other) {
+        if (other.blocks_.size() != blocks_.size()) {
+            throw std::invalid_argument("Bloom filters differ in size");
+        }
+        for (std::size_t b = 0; b < blocks_.size(); ++b) {
+            for (std::size_t w = 0; w < bloom_detail::kWordsPerBlock; ++w) {
+                blocks_[b].words[w] |= other.blocks_[b].words[w];
+            }
+        }
+        inserted_ += other.inserted_;
+    }
+
+    void clear() {
+        std::fill(blocks_.begin(), blocks_.end(), bloom_detail::Block{});
+        inserted_ = 0;
+    }
+
+    // Insert calls so far (duplicates included)
+    std::size_t inserted() const {
+        return inserted_;
+    }
+
+    std::size_t block_count() const {
+        return blocks_.size();
+    }
+
+    std::size_t memory_bytes() const {
+        return blocks_.size() * sizeof(bloom_detail::Block);
+    }
+
+    // Predicted rate at the current load
+    double estimated_false_positive_rate() const {
+        if (inserted_ == 0) {
+            return 0.0;
+        }
+        return bloom_detail::false_positive_rate(static_cast<double>(blocks_.size()) *
+                                                 bloom_detail::kBitsPerBlock /
+                                                 static_cast<double>(inserted_));
+    }
+
+    void save(std::ostream &out) const {
+        bloom_detail::write_header(out, bloom_detail::kBloomMagic, blocks_.size(), inserted_);
+        out.write(reinterpret_cast<const char *>(blocks_.data()),
+                  static_cast<std::streamsize>(memory_bytes()));
+        if (!out) {
+            throw std::runtime_error("failed to write Bloom filter");
+        }
+    }
+
+    void save(const std::string &path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        save(out);
+    }
+
+    static BlockedBloomFilter load(std::istream &in, const Hash &hash = Hash()) {
+        auto header = bloom_detail::read_header(in, bloom_detail::kBloomMagic);
+        BlockedBloomFilter filter(blocks_tag{}, static_cast<std::size_t>(header.blocks), hash);
+        if (!in.read(reinterpret_cast<char *>(filter.blocks_.data()),
+                     static_cast<std::streamsize>(filter.memory_bytes()))) {
+            throw std::runtime_error("truncated Bloom filter");
+        }
+        filter.inserted_ = static_cast<std::size_t>(header.inserted);
+        return filter;
+    }
+
+    static BlockedBloomFilter load(const std::string &path, const Hash &hash = Hash()) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("cannot open Bloom filter file: " + path);
+        }
+        return load(in, hash);
+    }
+};
+
+// Same block geometry with a 4-bit counter per bit. Counters saturate at 15
+// and then stay put, so erase() never creates false negatives; only erase
+// keys that were actually inserted.
+template <typename Key, typename Hash = default_hash<Key>>
+class CountingBloomFilter {
+   private:
+    // 8 words x 32 counters x 4 bits: two uint64 per word
+    struct Block {
+        std::uint64_t counters[bloom_detail::kWordsPerBlock][2];
+    };
+    static constexpr std::uint64_t kSaturated = 15;
+
+    std::vector<Block> blocks_;
+    std::size_t inserted_ = 0;
+    Hash hash_;
+
+    template <typename K>
+    std::size_t hash_of(const K &key) const {
+        return hash_detail::mix(hash_(key));
+    }
+
+    static std::uint64_t counter(const Block &block, std::size_t word, std::uint32_t bit) {
+        return (block.counters[word][bit / 16] >> (bit % 16 * 4)) & 0xF;
+    }
+
+    // Adds delta (+1 / -1) unless the counter is saturated
+    static void bump(Block &block, std::size_t word, std::uint32_t bit, int delta) {
+        std::uint64_t value = counter(block, word, bit);
+        if (value == kSaturated || (delta < 0 && value == 0)) {
+            return;
+        }
+        std::uint64_t &slot = block.counters[word][bit / 16];
+        const unsigned shift = bit % 16 * 4;
+        slot = (slot & ~(std::uint64_t{0xF} << shift)) |
+               ((delta > 0 ? value + 1 : value - 1) << shift);
+    }
+
+    template <typename K>
+    void update(const K &key, int delta) {
+        std::size_t h = hash_of(key);
+        Block &block = blocks_[bloom_detail::block_index(h, blocks_.size())];
+        std::uint32_t bits[bloom_detail::kWordsPerBlock];
+        bloom_detail::probe_bits(static_cast<std::uint32_t>(h), bits);
+        for (std::size_t w = 0; w < bloom_detail::kWordsPerBlock; ++w) {
+            bump(block, w, bits[w], delta);
+        }
+    }
+
+    struct blocks_tag {};
+    CountingBloomFilter(blocks_tag, std::size_t blocks, const Hash &hash)
+        : blocks_(blocks, Block{}), hash_(hash) {}
+
+   public:
+    explicit CountingBloomFilter(std::size_t expected_keys, double false_positive_rate = 0.01,
+                                 const Hash &hash = Hash())
+        : CountingBloomFilter(blocks_tag{},
+                              bloom_detail::blocks_for(expected_keys, false_positive_rate), hash) {}
+
+    template <bloom_hashable<Hash> K>
+    void insert(const K &key) {
+        update(key, +1);
+        ++inserted_;
+    }
+
+    template <bloom_hashable<Hash> K>
+    void erase(const K &key) {
+        update(key, -1);
+        inserted_ -= inserted_ > 0;
+    }
+
+    template <bloom_hashable<Hash> K>
+    bool contains(const K &key) const {
+        std::size_t h = hash_of(key);
+        const Block &block = blocks_[bloom_detail::block_index(h, blocks_.size())];
+        std::uint32_t bits[bloom_detail::kWordsPerBlock];
+        bloom_detail::probe_bits(static_cast<std::uint32_t>(h), bits);
+        bool all = true;
+        for (std::size_t w = 0; w < bloom_detail::kWordsPerBlock; ++w) {
+            all &= counter(block, w, bits[w]) != 0;
+        }
+        return all;
+    }
+
+    // Plain filter with the same answers, for read-mostly consumers
+    BlockedBloomFilter<Key, Hash> to_bloom_filter() const {
+        BlockedBloomFilter<Key, Hash> filter(typename BlockedBloomFilter<Key, Hash>::blocks_tag{},
+                                             blocks_.size(), hash_);
+        for (std::size_t b = 0; b < blocks_.size(); ++b) {
+            for (std::size_t w = 0; w < bloom_detail::kWordsPerBlock; ++w) {
+                std::uint32_t word = 0;
+                for (std::uint32_t bit = 0; bit < 32; ++bit) {
+                    word |= static_cast<std::uint32_t>(counter(blocks_[b], w, bit) != 0) << bit;
+                }
+                filter.blocks_[b].words[w] = word;
+            }
+        }
+        filter.inserted_ = inserted_;
+        return filter;
+    }
+
+    std::size_t inserted() const {
+        return inserted_;
+    }
+
+    std::size_t block_count() const {
+        return blocks_.size();
+    }
+
+    std::size_t memory_bytes() const {
+        return blocks_.size() * sizeof(Block);
+    }
+
+    void save(std::ostream &out) const {
+        bloom_detail::write_header(out, bloom_detail::kCountingMagic, blocks_.size(), inserted_);
+        out.write(reinterpret_cast<const char *>(blocks_.data()),
+                  static_cast<std::streamsize>(memory_bytes()));
+        if (!out) {
+            throw std::runtime_error("failed to write counting Bloom filter");
+        }
+    }
+
+    void save(const std::string &path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        save(out);
+    }
+
+    static CountingBloomFilter load(std::istream &in, const Hash &hash = Hash()) {
+        auto header = bloom_detail::read_header(in, bloom_detail::kCountingMagic);
+        CountingBloomFilter filter(blocks_tag{}, static_cast<std::size_t>(header.blocks), hash);
+        if (!in.read(reinterpret_cast<char *>(filter.blocks_.data()),
+                     static_cast<std::streamsize>(filter.memory_bytes()))) {
+            throw std::runtime_error("truncated counting Bloom filter");
+        }
+        filter.inserted_ = static_cast<std::size_t>(header.inserted);
+        return filter;
+    }
+
+    static CountingBloomFilter load(const std::string &path, const Hash &hash = Hash()) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("cannot open counting Bloom filter file: " + path);
+        }
+        return load(in, hash);
+    }
+};
+
+}  // namespace day1
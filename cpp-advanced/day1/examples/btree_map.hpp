@@ -0,0 +1,1047 @@
+// day1/examples/btree_map.hpp
+// Cache-conscious B+tree ordered map
+//
+// std::map allocates one red-black node per element, so a lookup chases
+// ~log2(n) pointers to unrelated cache lines and a range scan misses on
+// nearly every element. A B+tree packs many keys per node instead:
+//
+//   - nodes are sized in bytes (NodeBytes, default 512 = 8 cache lines);
+//     keys and mapped values live in separate arrays, so searches touch
+//     only key lines
+//   - arithmetic keys under std::less are searched by comparing a whole
+//     vector of keys at once and counting the hits, with no branches; the
+//     vector width follows cpu::active_level() (cpu_dispatch.hpp)
+//   - all elements live in leaves linked in order, so iteration and range
+//     scans walk dense arrays
+//   - construction from sorted data (or unsorted data, sorted once) builds
+//     the tree bottom-up in O(n), using the fewest nodes per level and
+//     spreading elements evenly across them: leaves end up between half
+//     and completely full, and inner nodes may sit one key below the
+//     minimum that erase rebalances to
+//
+// Keys and mapped values must be default constructible and movable.
+// Inserts and erases invalidate all iterators.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cpu_dispatch.hpp"
+#include "flat_map.hpp"
+
+#if DAY1_CPU_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace day1 {
+
+namespace btree_detail {
+
+// Widest vector any dispatched kernel uses; node layouts are sized for it
+// so they do not depend on the CPU the program runs on
+inline constexpr std::size_t kSimdBytes = 64;
+
+template <typename K, std::size_t Bytes>
+struct simd_vec {
+    typedef K type __attribute__((vector_size(Bytes)));
+};
+
+template <typename K, typename Compare>
+inline constexpr bool kSimdSearch =
+    std::is_arithmetic_v<K> && !std::is_same_v<K, bool> && (sizeof(K) == 4 || sizeof(K) == 8) &&
+    (std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>);
+
+template <typename K>
+inline constexpr std::size_t kLanes = std::max<std::size_t>(1, kSimdBytes / sizeof(K));
+
+// Slot counts are whole vectors so SIMD loads never leave the node
+constexpr std::size_t node_slots(std::size_t node_bytes, std::size_t slot_bytes,
+                                 std::size_t lanes) {
+    std::size_t slots = std::max<std::size_t>(4, node_bytes / slot_bytes);
+    return (slots + lanes - 1) / lanes * lanes;
+}
+
+// How many of keys[0, count) are < key (OrEqual: <= key). Whole vectors are
+// compared and lanes at or past count masked off, so the cost depends only
+// on count / lanes, never on where the key falls. Always inlined, so each
+// caller below compiles it for its own target.
+template <std::size_t Bytes, bool OrEqual, typename K>
+[[gnu::always_inline]] inline std::size_t rank_kernel(const K *keys, std::size_t count, K key) {
+    using I = std::conditional_t<sizeof(K) == 8, std::int64_t, std::int32_t>;
+    using V = typename simd_vec<K, Bytes>::type;
+    using M = typename simd_vec<I, Bytes>::type;
+    constexpr std::size_t L = Bytes / sizeof(K);
+    const V needle = V{} + key;
+    M lane;
+    for (std::size_t l = 0; l < L; ++l) {
+        lane[l] = static_cast<I>(l);
+    }
+    M hits{};
+    for (std::size_t i = 0; i < count; i += L) {
+        V v;
+        std::memcpy(&v, keys + i, sizeof v);
+        M below;
+        if constexpr (OrEqual) {
+            below = v <= needle;
+        } else {
+            below = v < needle;
+        }
+        hits -= below & (lane < (M{} + static_cast<I>(count - i)));  // true lanes are -1
+    }
+    I rank = 0;
+    for (std::size_t l = 0; l < L; ++l) {
+        rank += hits[l];
+    }
+    return static_cast<std::size_t>(rank);
+}
+
+#if DAY1_CPU_X86_DISPATCH
+template <bool OrEqual, typename K>
+DAY1_TARGET_V3 std::size_t rank_v3(const K *keys, std::size_t count, K key) {
+    return rank_kernel<32, OrEqual>(keys, count, key);
+}
+
+// Written with mask compares: GCC lowers a 64-byte generic vector compare
+// of unsigned keys to scalar code
+template <bool OrEqual, typename K>
+DAY1_TARGET_V4 std::size_t rank_v4(const K *keys, std::size_t count, K key) {
+    constexpr std::size_t L = 64 / sizeof(K);
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i < count; i += L) {
+        const std::size_t left = count - i;
+        const auto valid = static_cast<std::uint16_t>(
+            left >= L ? (1u << L) - 1 : (1u << left) - 1);
+        unsigned below;
+        if constexpr (std::is_same_v<K, float>) {
+            below = _mm512_mask_cmp_ps_mask(valid, _mm512_loadu_ps(keys + i), _mm512_set1_ps(key),
+                                            OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ);
+        } else if constexpr (std::is_same_v<K, double>) {
+            below = _mm512_mask_cmp_pd_mask(static_cast<__mmask8>(valid),
+                                            _mm512_loadu_pd(keys + i), _mm512_set1_pd(key),
+                                            OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ);
+        } else {
+            constexpr int op = OrEqual ? _MM_CMPINT_LE : _MM_CMPINT_LT;
+            const __m512i v = _mm512_loadu_si512(keys + i);
+            if constexpr (sizeof(K) == 4 && std::is_signed_v<K>) {
+                below = _mm512_mask_cmp_epi32_mask(valid, v,
+                                                   _mm512_set1_epi32(static_cast<int>(key)), op);
+            } else if constexpr (sizeof(K) == 4) {
+                below = _mm512_mask_cmp_epu32_mask(valid, v,
+                                                   _mm512_set1_epi32(static_cast<int>(key)), op);
+            } else if constexpr (std::is_signed_v<K>) {
+                below = _mm512_mask_cmp_epi64_mask(static_cast<__mmask8>(valid), v,
+                                                   _mm512_set1_epi64(static_cast<long long>(key)),
+                                                   op);
+            } else {
+                below = _mm512_mask_cmp_epu64_mask(static_cast<__mmask8>(valid), v,
+                                                   _mm512_set1_epi64(static_cast<long long>(key)),
+                                                   op);
+            }
+        }
+        rank += static_cast<std::size_t>(std::popcount(below));
+    }
+    return rank;
+}
+#endif
+
+template <bool OrEqual, typename K>
+std::size_t simd_rank(const K *keys, std::size_t count, K key) {
+#if DAY1_CPU_X86_DISPATCH
+    switch (cpu::active_level()) {
+        case cpu::Level::v4:
+            return rank_v4<OrEqual>(keys, count, key);
+        case cpu::Level::v3:
+            return rank_v3<OrEqual>(keys, count, key);
+        default:
+            break;
+    }
+#endif
+    return rank_kernel<16, OrEqual>(keys, count, key);
+}
+
+// Split total items into the fewest groups of at most cap, as evenly as
+// possible; with two or more groups each holds at least cap / 2
+inline std::vector<std::size_t> even_groups(std::size_t total, std::size_t cap) {
+    const std::size_t groups = std::max<std::size_t>(1, (total + cap - 1) / cap);
+    std::vector<std::size_t> sizes(groups, total / groups);
+    for (std::size_t g = 0; g < total % groups; ++g) {
+        ++sizes[g];
+    }
+    return sizes;
+}
+
+}  // namespace btree_detail
+
+template <typename Key, typename T, typename Compare = std::less<Key>, std::size_t NodeBytes = 512>
+class btree_map {
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using reference = std::pair<const Key &, T &>;
+    using const_reference = std::pair<const Key &, const T &>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static constexpr std::size_t kLeafSlots =
+        btree_detail::node_slots(NodeBytes, sizeof(Key) + sizeof(T), btree_detail::kLanes<Key>);
+    static constexpr std::size_t kInnerSlots = btree_detail::node_slots(
+        NodeBytes, sizeof(Key) + sizeof(void *), btree_detail::kLanes<Key>);
+
+   private:
+    static constexpr std::size_t kMinLeaf = kLeafSlots / 2;
+    static constexpr std::size_t kMinInner = kInnerSlots / 2;
+    static constexpr std::size_t kMaxHeight = 64;
+    static constexpr bool kSimd = btree_detail::kSimdSearch<Key, Compare>;
+
+    struct alignas(64) LeafNode {
+        std::size_t count = 0;
+        LeafNode *prev = nullptr;
+        LeafNode *next = nullptr;
+        Key keys[kLeafSlots];
+        T values[kLeafSlots];
+    };
+
+    // children[i] holds the keys k with keys[i - 1] <= k < keys[i]; the
+    // children are LeafNode* on the lowest inner level, InnerNode* above
+    struct alignas(64) InnerNode {
+        std::size_t count = 0;  // keys; children = count + 1
+        Key keys[kInnerSlots];
+        void *children[kInnerSlots + 1];
+    };
+
+    struct PathEntry {
+        InnerNode *node;
+        std::size_t index;
+    };
+    using Path = std::array<PathEntry, kMaxHeight>;
+
+    void *root_ = nullptr;
+    std::size_t height_ = 0;  // inner levels above the leaves
+    std::size_t size_ = 0;
+    LeafNode *first_ = nullptr;
+    LeafNode *last_ = nullptr;
+    [[no_unique_address]] Compare comp_;
+
+    template <typename K>
+    static constexpr bool kTransparent =
+        flat_detail::is_transparent<Compare>::value || std::is_same_v<K, Key>;
+
+    // Bidirectional iterator over the leaf chain, yielding pair<const Key&, T&>
+    template <bool Const>
+    class Iterator {
+        friend class btree_map;
+        template <bool>
+        friend class Iterator;
+
+        const btree_map *tree_ = nullptr;
+        LeafNode *leaf_ = nullptr;  // nullptr: end()
+        std::size_t pos_ = 0;
+
+        Iterator(const btree_map *tree, LeafNode *leaf, std::size_t pos)
+            : tree_(tree), leaf_(leaf), pos_(pos) {}
+
+       public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using iterator_concept = std::bidirectional_iterator_tag;
+        using value_type = typename btree_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const_reference, typename btree_map::reference>;
+
+        struct pointer {
+            reference ref;
+            const reference *operator->() const {
+                return &ref;
+            }
+        };
+
+        Iterator() = default;
+
+        template <bool C = Const>
+            requires C
+        Iterator(const Iterator<false> &other)
+            : tree_(other.tree_), leaf_(other.leaf_), pos_(other.pos_) {}
+
+        reference operator*() const {
+            return {leaf_->keys[pos_], leaf_->values[pos_]};
+        }
+        pointer operator->() const {
+            return {**this};
+        }
+
+        Iterator &operator++() {
+            if (++pos_ == leaf_->count) {
+                leaf_ = leaf_->next;
+                pos_ = 0;
+            }
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        Iterator &operator--() {
+            if (leaf_ == nullptr) {
+                leaf_ = tree_->last_;
+                pos_ = leaf_->count - 1;
+            } else if (pos_ == 0) {
+                leaf_ = leaf_->prev;
+                pos_ = leaf_->count - 1;
+            } else {
+                --pos_;
+            }
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        friend bool operator==(const Iterator &a, const Iterator &b) {
+            return a.leaf_ == b.leaf_ && a.pos_ == b.pos_;
+        }
+    };
+
+   public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    btree_map() = default;
+
+    explicit btree_map(const Compare &comp) : comp_(comp) {}
+
+    // Unsorted input: sorted once, first occurrence of a duplicate key wins
+    template <std::input_iterator It>
+    btree_map(It first, It last, const Compare &comp = Compare()) : comp_(comp) {
+        std::vector<value_type> items(first, last);
+        std::stable_sort(items.begin(), items.end(), [this](const auto &a, const auto &b) {
+            return comp_(a.first, b.first);
+        });
+        auto unique_end =
+            std::unique(items.begin(), items.end(), [this](const auto &a, const auto &b) {
+                return !comp_(a.first, b.first) && !comp_(b.first, a.first);
+            });
+        items.erase(unique_end, items.end());
+        bulk_load(std::make_move_iterator(items.begin()), items.size());
+    }
+
+    // Input already sorted by key without duplicates: O(n)
+    template <std::forward_iterator It>
+    btree_map(sorted_unique_t, It first, It last, const Compare &comp = Compare()) : comp_(comp) {
+        bulk_load(first, static_cast<std::size_t>(std::distance(first, last)));
+    }
+
+    btree_map(std::initializer_list<value_type> init, const Compare &comp = Compare())
+        : btree_map(init.begin(), init.end(), comp) {}
+
+    btree_map(const btree_map &other) : comp_(other.comp_) {
+        bulk_load(other.begin(), other.size());
+    }
+
+    btree_map(btree_map &&other) noexcept
+        : root_(std::exchange(other.root_, nullptr)),
+          height_(std::exchange(other.height_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          first_(std::exchange(other.first_, nullptr)),
+          last_(std::exchange(other.last_, nullptr)),
+          comp_(std::move(other.comp_)) {}
+
+    btree_map &operator=(btree_map other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~btree_map() {
+        clear();
+    }
+
+    void swap(btree_map &other) noexcept {
+        std::swap(root_, other.root_);
+        std::swap(height_, other.height_);
+        std::swap(size_, other.size_);
+        std::swap(first_, other.first_);
+        std::swap(last_, other.last_);
+        std::swap(comp_, other.comp_);
+    }
+
+    // --- Iterators -----------------------------------------------------------
+
+    iterator begin() {
+        return {this, first_, 0};
+    }
+    const_iterator begin() const {
+        return {this, first_, 0};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    iterator end() {
+        return {this, nullptr, 0};
+    }
+    const_iterator end() const {
+        return {this, nullptr, 0};
+    }
+    const_iterator cend() const {
+        return end();
+    }
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    // --- Capacity ------------------------------------------------------------
+
+    bool empty() const {
+        return size_ == 0;
+    }
+    size_type size() const {
+        return size_;
+    }
+    // Levels from root to leaf, counting the leaf level; 0 when empty
+    std::size_t height() const {
+        return root_ ? height_ + 1 : 0;
+    }
+
+    void clear() {
+        if (root_) {
+            destroy(root_, height_);
+        }
+        root_ = nullptr;
+        height_ = 0;
+        size_ = 0;
+        first_ = last_ = nullptr;
+    }
+
+    // --- Lookup --------------------------------------------------------------
+
+    template <typename K>
+        requires kTransparent<K>
+    iterator lower_bound(const K &key) {
+        return bound<false>(key);
+    }
+    template <typename K>
+        requires kTransparent<K>
+    const_iterator lower_bound(const K &key) const {
+        return const_cast<btree_map *>(this)->template bound<false>(key);
+    }
+    iterator lower_bound(const Key &key) {
+        return bound<false>(key);
+    }
+    const_iterator lower_bound(const Key &key) const {
+        return const_cast<btree_map *>(this)->template bound<false>(key);
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    iterator upper_bound(const K &key) {
+        return bound<true>(key);
+    }
+    template <typename K>
+        requires kTransparent<K>
+    const_iterator upper_bound(const K &key) const {
+        return const_cast<btree_map *>(this)->template bound<true>(key);
+    }
+    iterator upper_bound(const Key &key) {
+        return bound<true>(key);
+    }
+    const_iterator upper_bound(const Key &key) const {
+        return const_cast<btree_map *>(this)->template bound<true>(key);
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    iterator find(const K &key) {
+        return iterator_at(find_slot(key));
+    }
+    template <typename K>
+        requires kTransparent<K>
+    const_iterator find(const K &key) const {
+        return const_cast<btree_map *>(this)->iterator_at(find_slot(key));
+    }
+    iterator find(const Key &key) {
+        return iterator_at(find_slot(key));
+    }
+    const_iterator find(const Key &key) const {
+        return const_cast<btree_map *>(this)->iterator_at(find_slot(key));
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    bool contains(const K &key) const {
+        return find_slot(key).first != nullptr;
+    }
+    bool contains(const Key &key) const {
+        return find_slot(key).first != nullptr;
+    }
+
+    size_type count(const Key &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    T &at(const Key &key) {
+        auto [leaf, pos] = find_slot(key);
+        if (!leaf) {
+            throw std::out_of_range("btree_map::at: key not found");
+        }
+        return leaf->values[pos];
+    }
+    const T &at(const Key &key) const {
+        return const_cast<btree_map *>(this)->at(key);
+    }
+
+    // Calls f(key, value) for every key in [lo, hi), walking the leaf chain
+    template <typename F>
+    void for_each_in_range(const Key &lo, const Key &hi, F &&f) const {
+        if (!root_) {
+            return;
+        }
+        LeafNode *leaf = find_leaf(lo);
+        std::size_t pos = leaf_lower(leaf, lo);
+        for (; leaf; leaf = leaf->next, pos = 0) {
+            for (; pos < leaf->count; ++pos) {
+                if (!comp_(leaf->keys[pos], hi)) {
+                    return;
+                }
+                f(std::as_const(leaf->keys[pos]), std::as_const(leaf->values[pos]));
+            }
+        }
+    }
+
+    // --- Modifiers -----------------------------------------------------------
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+        return emplace_unique(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+        return emplace_unique(std::move(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return try_emplace(value.first, value.second);
+    }
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, V &&value) {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result.second) {
+            (*result.first).second = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    T &operator[](const Key &key) {
+        return (*try_emplace(key).first).second;
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    size_type erase(const K &key) {
+        return erase_key(key);
+    }
+    size_type erase(const Key &key) {
+        return erase_key(key);
+    }
+
+    // Returns the element after the erased one (found again by key, since
+    // rebalancing may move it)
+    iterator erase(const_iterator it) {
+        const_iterator next = std::next(it);
+        if (next == end()) {
+            erase(it.leaf_->keys[it.pos_]);
+            return end();
+        }
+        Key next_key = next.leaf_->keys[next.pos_];
+        erase(it.leaf_->keys[it.pos_]);
+        return lower_bound(next_key);
+    }
+    iterator erase(iterator it) {
+        return erase(const_iterator(it));
+    }
+
+    template <typename Pred>
+    size_type erase_if(Pred pred) {
+        // Rebuilding once beats rebalancing per erase when many go. Find
+        // the first match before moving anything out of the leaves, so a
+        // predicate that matches nothing leaves the tree untouched.
+        LeafNode *hit = first_;
+        std::size_t hit_pos = 0;
+        for (; hit; hit = hit->next, hit_pos = 0) {
+            while (hit_pos < hit->count &&
+                   !pred(const_reference{hit->keys[hit_pos], hit->values[hit_pos]})) {
+                ++hit_pos;
+            }
+            if (hit_pos < hit->count) {
+                break;
+            }
+        }
+        if (!hit) {
+            return 0;
+        }
+
+        std::vector<value_type> kept;
+        kept.reserve(size_);
+        for (LeafNode *leaf = first_; leaf != hit; leaf = leaf->next) {
+            for (std::size_t i = 0; i < leaf->count; ++i) {
+                kept.emplace_back(std::move(leaf->keys[i]), std::move(leaf->values[i]));
+            }
+        }
+        for (std::size_t i = 0; i < hit_pos; ++i) {
+            kept.emplace_back(std::move(hit->keys[i]), std::move(hit->values[i]));
+        }
+        size_type removed = 1;
+        std::size_t i = hit_pos + 1;
+        for (LeafNode *leaf = hit; leaf; leaf = leaf->next, i = 0) {
+            for (; i < leaf->count; ++i) {
+                if (pred(const_reference{leaf->keys[i], leaf->values[i]})) {
+                    ++removed;
+                } else {
+                    kept.emplace_back(std::move(leaf->keys[i]), std::move(leaf->values[i]));
+                }
+            }
+        }
+        clear();
+        bulk_load(std::make_move_iterator(kept.begin()), kept.size());
+        return removed;
+    }
+
+   private:
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace_unique(K &&key, Args &&...args) {
+        if (!root_) {
+            auto *leaf = new LeafNode();
+            root_ = first_ = last_ = leaf;
+        }
+        Path path;
+        LeafNode *leaf = find_leaf(key, &path);
+        std::size_t pos = leaf_lower(leaf, key);
+        if (pos < leaf->count && !comp_(key, leaf->keys[pos])) {
+            return {iterator(this, leaf, pos), false};
+        }
+        ++size_;
+        if (leaf->count < kLeafSlots) {
+            leaf_insert_at(leaf, pos, std::forward<K>(key), T(std::forward<Args>(args)...));
+            return {iterator(this, leaf, pos), true};
+        }
+        return {split_leaf_and_insert(path, leaf, pos, std::forward<K>(key),
+                                      T(std::forward<Args>(args)...)),
+                true};
+    }
+
+    template <typename K>
+    size_type erase_key(const K &key) {
+        if (!root_) {
+            return 0;
+        }
+        Path path;
+        LeafNode *leaf = find_leaf(key, &path);
+        std::size_t pos = leaf_lower(leaf, key);
+        if (pos == leaf->count || comp_(key, leaf->keys[pos])) {
+            return 0;
+        }
+        erase_at(path, leaf, pos);
+        return 1;
+    }
+
+    iterator iterator_at(std::pair<LeafNode *, std::size_t> slot) {
+        return slot.first ? iterator(this, slot.first, slot.second) : end();
+    }
+
+    // --- Search ----------------------------------------------------------------
+
+    template <typename K>
+    std::size_t leaf_lower(const LeafNode *leaf, const K &key) const {
+        if constexpr (kSimd && std::is_same_v<K, Key>) {
+            return btree_detail::simd_rank<false>(leaf->keys, leaf->count, key);
+        } else {
+            return static_cast<std::size_t>(
+                std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, comp_) - leaf->keys);
+        }
+    }
+
+    template <typename K>
+    std::size_t leaf_upper(const LeafNode *leaf, const K &key) const {
+        if constexpr (kSimd && std::is_same_v<K, Key>) {
+            return btree_detail::simd_rank<true>(leaf->keys, leaf->count, key);
+        } else {
+            return static_cast<std::size_t>(
+                std::upper_bound(leaf->keys, leaf->keys + leaf->count, key, comp_) - leaf->keys);
+        }
+    }
+
+    // Child to descend into: the number of separators <= key
+    template <typename K>
+    std::size_t child_index(const InnerNode *inner, const K &key) const {
+        if constexpr (kSimd && std::is_same_v<K, Key>) {
+            return btree_detail::simd_rank<true>(inner->keys, inner->count, key);
+        } else {
+            return static_cast<std::size_t>(
+                std::upper_bound(inner->keys, inner->keys + inner->count, key, comp_) -
+                inner->keys);
+        }
+    }
+
+    // Leaf that would hold key; records the inner nodes passed on the way
+    template <typename K>
+    LeafNode *find_leaf(const K &key, Path *path = nullptr) const {
+        void *node = root_;
+        for (std::size_t level = 0; level < height_; ++level) {
+            auto *inner = static_cast<InnerNode *>(node);
+            std::size_t index = child_index(inner, key);
+            if (path) {
+                (*path)[level] = {inner, index};
+            }
+            node = inner->children[index];
+        }
+        return static_cast<LeafNode *>(node);
+    }
+
+    template <typename K>
+    std::pair<LeafNode *, std::size_t> find_slot(const K &key) const {
+        if (!root_) {
+            return {nullptr, 0};
+        }
+        LeafNode *leaf = find_leaf(key);
+        std::size_t pos = leaf_lower(leaf, key);
+        if (pos < leaf->count && !comp_(key, leaf->keys[pos])) {
+            return {leaf, pos};
+        }
+        return {nullptr, 0};
+    }
+
+    template <bool Upper, typename K>
+    iterator bound(const K &key) {
+        if (!root_) {
+            return end();
+        }
+        LeafNode *leaf = find_leaf(key);
+        std::size_t pos = Upper ? leaf_upper(leaf, key) : leaf_lower(leaf, key);
+        if (pos == leaf->count) {
+            return {this, leaf->next, 0};
+        }
+        return {this, leaf, pos};
+    }
+
+    // --- Insert ----------------------------------------------------------------
+
+    static void leaf_insert_at(LeafNode *leaf, std::size_t pos, Key key, T value) {
+        std::move_backward(leaf->keys + pos, leaf->keys + leaf->count,
+                           leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + pos, leaf->values + leaf->count,
+                           leaf->values + leaf->count + 1);
+        leaf->keys[pos] = std::move(key);
+        leaf->values[pos] = std::move(value);
+        ++leaf->count;
+    }
+
+    iterator split_leaf_and_insert(Path &path, LeafNode *leaf, std::size_t pos, Key key, T value) {
+        auto *right = new LeafNode();
+        // After the insert the left leaf holds `keep` elements
+        const std::size_t keep = (kLeafSlots + 1) / 2;
+        const std::size_t from = pos < keep ? keep - 1 : keep;
+        std::move(leaf->keys + from, leaf->keys + leaf->count, right->keys);
+        std::move(leaf->values + from, leaf->values + leaf->count, right->values);
+        right->count = leaf->count - from;
+        leaf->count = from;
+
+        right->next = leaf->next;
+        right->prev = leaf;
+        (leaf->next ? leaf->next->prev : last_) = right;
+        leaf->next = right;
+
+        iterator result;
+        if (pos < keep) {
+            leaf_insert_at(leaf, pos, std::move(key), std::move(value));
+            result = iterator(this, leaf, pos);
+        } else {
+            leaf_insert_at(right, pos - keep, std::move(key), std::move(value));
+            result = iterator(this, right, pos - keep);
+        }
+        insert_into_parent(path, height_, leaf, right->keys[0], right);
+        return result;
+    }
+
+    // Register `right` (split off `left`, with smallest key `separator`)
+    // with the parent at path[level - 1], splitting upwards as needed
+    void insert_into_parent(Path &path, std::size_t level, void *left, const Key &separator,
+                            void *right) {
+        if (level == 0) {
+            auto *root = new InnerNode();
+            root->count = 1;
+            root->keys[0] = separator;
+            root->children[0] = left;
+            root->children[1] = right;
+            root_ = root;
+            ++height_;
+            return;
+        }
+        auto [parent, index] = path[level - 1];
+        if (parent->count < kInnerSlots) {
+            inner_insert_at(parent, index, separator, right);
+            return;
+        }
+
+        // Full: lay out the kInnerSlots + 1 keys in order, push the middle
+        // one up and give the upper half to a new sibling
+        std::array<Key, kInnerSlots + 1> keys;
+        std::array<void *, kInnerSlots + 2> children;
+        std::move(parent->keys, parent->keys + index, keys.begin());
+        keys[index] = separator;
+        std::move(parent->keys + index, parent->keys + kInnerSlots, keys.begin() + index + 1);
+        std::copy(parent->children, parent->children + index + 1, children.begin());
+        children[index + 1] = right;
+        std::copy(parent->children + index + 1, parent->children + kInnerSlots + 1,
+                  children.begin() + index + 2);
+
+        const std::size_t mid = (kInnerSlots + 1) / 2;
+        auto *sibling = new InnerNode();
+        parent->count = mid;
+        std::move(keys.begin(), keys.begin() + mid, parent->keys);
+        std::copy(children.begin(), children.begin() + mid + 1, parent->children);
+        sibling->count = kInnerSlots - mid;
+        std::move(keys.begin() + mid + 1, keys.end(), sibling->keys);
+        std::copy(children.begin() + mid + 1, children.end(), sibling->children);
+        insert_into_parent(path, level - 1, parent, keys[mid], sibling);
+    }
+
+    static void inner_insert_at(InnerNode *inner, std::size_t index, const Key &separator,
+                                void *right) {
+        std::move_backward(inner->keys + index, inner->keys + inner->count,
+                           inner->keys + inner->count + 1);
+        std::copy_backward(inner->children + index + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->keys[index] = separator;
+        inner->children[index + 1] = right;
+        ++inner->count;
+    }
+
+    // --- Erase -----------------------------------------------------------------
+
+    void erase_at(Path &path, LeafNode *leaf, std::size_t pos) {
+        std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+        std::move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+        --leaf->count;
+        --size_;
+        if (height_ == 0) {
+            if (leaf->count == 0) {
+                clear();
+            }
+            return;
+        }
+        if (leaf->count < kMinLeaf) {
+            rebalance_leaf(path, leaf);
+        }
+    }
+
+    // Borrow one element from a sibling that can spare it, else merge with
+    // a sibling; separators in the parent are fixed up either way
+    void rebalance_leaf(Path &path, LeafNode *leaf) {
+        auto [parent, index] = path[height_ - 1];
+        auto *left = index > 0 ? static_cast<LeafNode *>(parent->children[index - 1]) : nullptr;
+        auto *right =
+            index < parent->count ? static_cast<LeafNode *>(parent->children[index + 1]) : nullptr;
+
+        if (left && left->count > kMinLeaf) {
+            leaf_insert_at(leaf, 0, std::move(left->keys[left->count - 1]),
+                           std::move(left->values[left->count - 1]));
+            --left->count;
+            parent->keys[index - 1] = leaf->keys[0];
+            return;
+        }
+        if (right && right->count > kMinLeaf) {
+            leaf->keys[leaf->count] = std::move(right->keys[0]);
+            leaf->values[leaf->count] = std::move(right->values[0]);
+            ++leaf->count;
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::move(right->values + 1, right->values + right->count, right->values);
+            --right->count;
+            parent->keys[index] = right->keys[0];
+            return;
+        }
+        if (left) {
+            merge_leaves(left, leaf);
+            inner_remove_at(parent, index - 1);
+        } else {
+            merge_leaves(leaf, right);
+            inner_remove_at(parent, index);
+        }
+        rebalance_inner(path, height_ - 1);
+    }
+
+    // Append right's elements to left and free right
+    void merge_leaves(LeafNode *left, LeafNode *right) {
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        std::move(right->values, right->values + right->count, left->values + left->count);
+        left->count += right->count;
+        left->next = right->next;
+        (right->next ? right->next->prev : last_) = left;
+        delete right;
+    }
+
+    // Remove keys[index] and children[index + 1]
+    static void inner_remove_at(InnerNode *inner, std::size_t index) {
+        std::move(inner->keys + index + 1, inner->keys + inner->count, inner->keys + index);
+        std::copy(inner->children + index + 2, inner->children + inner->count + 1,
+                  inner->children + index + 1);
+        --inner->count;
+    }
+
+    void rebalance_inner(Path &path, std::size_t level) {
+        InnerNode *node = path[level].node;
+        if (level == 0) {
+            if (node->count == 0) {  // root with a single child: drop a level
+                root_ = node->children[0];
+                --height_;
+                delete node;
+            }
+            return;
+        }
+        if (node->count >= kMinInner) {
+            return;
+        }
+        auto [parent, index] = path[level - 1];
+        auto *left = index > 0 ? static_cast<InnerNode *>(parent->children[index - 1]) : nullptr;
+        auto *right =
+            index < parent->count ? static_cast<InnerNode *>(parent->children[index + 1]) : nullptr;
+
+        if (left && left->count > kMinInner) {
+            // Rotate right: separator comes down, left's last key goes up
+            std::move_backward(node->keys, node->keys + node->count,
+                               node->keys + node->count + 1);
+            std::copy_backward(node->children, node->children + node->count + 1,
+                               node->children + node->count + 2);
+            node->keys[0] = std::move(parent->keys[index - 1]);
+            node->children[0] = left->children[left->count];
+            ++node->count;
+            parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+            --left->count;
+            return;
+        }
+        if (right && right->count > kMinInner) {
+            node->keys[node->count] = std::move(parent->keys[index]);
+            node->children[node->count + 1] = right->children[0];
+            ++node->count;
+            parent->keys[index] = std::move(right->keys[0]);
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::copy(right->children + 1, right->children + right->count + 1, right->children);
+            --right->count;
+            return;
+        }
+        if (left) {
+            merge_inner(left, std::move(parent->keys[index - 1]), node);
+            inner_remove_at(parent, index - 1);
+        } else {
+            merge_inner(node, std::move(parent->keys[index]), right);
+            inner_remove_at(parent, index);
+        }
+        rebalance_inner(path, level - 1);
+    }
+
+    static void merge_inner(InnerNode *left, Key separator, InnerNode *right) {
+        left->keys[left->count] = std::move(separator);
+        std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1,
+                  left->children + left->count + 1);
+        left->count += right->count + 1;
+        delete right;
+    }
+
+    // --- Bulk load / teardown --------------------------------------------------
+
+    // Build from n sorted, unique elements: fill leaves left to right, then
+    // each inner level from the one below
+    template <typename It>
+    void bulk_load(It first, std::size_t n) {
+        if (n == 0) {
+            return;
+        }
+        std::vector<void *> level;
+        std::vector<Key> low_keys;  // smallest key under each node of `level`
+        LeafNode *prev = nullptr;
+        for (std::size_t group : btree_detail::even_groups(n, kLeafSlots)) {
+            auto *leaf = new LeafNode();
+            for (std::size_t i = 0; i < group; ++i, ++first) {
+                auto &&item = *first;
+                leaf->keys[i] = std::forward<decltype(item)>(item).first;
+                leaf->values[i] = std::forward<decltype(item)>(item).second;
+            }
+            leaf->count = group;
+            leaf->prev = prev;
+            (prev ? prev->next : first_) = leaf;
+            prev = leaf;
+            level.push_back(leaf);
+            low_keys.push_back(leaf->keys[0]);
+        }
+        last_ = prev;
+        size_ = n;
+
+        height_ = 0;
+        while (level.size() > 1) {
+            std::vector<void *> parents;
+            std::vector<Key> parent_low_keys;
+            std::size_t child = 0;
+            for (std::size_t group : btree_detail::even_groups(level.size(), kInnerSlots + 1)) {
+                auto *inner = new InnerNode();
+                inner->count = group - 1;
+                for (std::size_t i = 0; i < group; ++i, ++child) {
+                    inner->children[i] = level[child];
+                    if (i > 0) {
+                        inner->keys[i - 1] = low_keys[child];
+                    }
+                }
+                parents.push_back(inner);
+                parent_low_keys.push_back(low_keys[child - group]);
+            }
+            level = std::move(parents);
+            low_keys = std::move(parent_low_keys);
+            ++height_;
+        }
+        root_ = level.front();
+    }
+
+    static void destroy(void *node, std::size_t height) {
+        if (height == 0) {
+            delete static_cast<LeafNode *>(node);
+            return;
+        }
+        auto *inner = static_cast<InnerNode *>(node);
+        for (std::size_t i = 0; i <= inner->count; ++i) {
+            destroy(inner->children[i], height - 1);
+        }
+        delete inner;
+    }
+};
+
+}  // namespace day1
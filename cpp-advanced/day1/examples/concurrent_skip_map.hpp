@@ -0,0 +1,620 @@
+// day1/examples/concurrent_skip_map.hpp
+// Lock-free ordered map (skip list) with snapshot range iteration
+//
+// A std::map shared between threads needs a lock around every operation,
+// and a range scan holds it for the whole scan. concurrent_skip_map lets any
+// number of threads insert, erase, look up and scan at once without locks:
+//
+//   - nodes are linked into a skip list with compare-and-swap; a node is
+//     removed by first marking its next pointers, so no thread can link
+//     behind a node that is going away (Harris / Fraser)
+//   - unlinked nodes are freed through epoch-based reclamation
+//     (epoch_reclamation.hpp), never while a reader can still see them
+//   - every insert and erase is stamped from a global version clock, so a
+//     snapshot sees exactly the elements present at its version while
+//     writers carry on; erased nodes stay linked until no snapshot needs
+//     them; a stamp still being assigned is waited out, never guessed
+//
+//     day1::concurrent_skip_map<std::uint64_t, Order> book;
+//     book.try_emplace(id, order);                       // from any thread
+//     auto snap = book.make_snapshot();
+//     for (auto [id, order] : snap) { ... }              // consistent view
+//
+// Mapped values are immutable once inserted (erase and insert again to
+// replace one), so lookups return copies. A snapshot pins memory: keep it
+// short-lived and use it on the thread that created it. Up to
+// kSnapshotSlots snapshots can be open at once; opening one more waits
+// for a slot.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "epoch_reclamation.hpp"
+
+namespace day1 {
+
+namespace skiplist_detail {
+
+inline constexpr std::size_t kMaxLevel = 24;
+
+// Version stamps: a live node's erase version is kLive; kPending marks a
+// stamp that is being assigned. The writer holding it only takes a clock
+// tick before storing the real version, so readers wait rather than guess
+// which side of their version it will land on.
+inline constexpr std::uint64_t kLive = ~std::uint64_t{0};
+inline constexpr std::uint64_t kPending = kLive - 1;
+
+// Open snapshots register their bound in one of these; kLive marks a free
+// slot. Erasers scan them all, so the table stays a few cache lines.
+inline constexpr std::size_t kSnapshotSlots = 64;
+
+// Erased nodes kept for snapshots are swept once this many pile up
+inline constexpr std::size_t kSweepMinimum = 1024;
+
+// Bit 0 of a next pointer marks the node that owns it as being removed
+inline bool is_marked(std::uintptr_t word) {
+    return word & 1;
+}
+inline std::uintptr_t with_mark(std::uintptr_t word) {
+    return word | 1;
+}
+
+// The stamp once it is no longer kPending
+inline std::uint64_t resolved(const std::atomic<std::uint64_t> &stamp) {
+    std::uint64_t value = stamp.load();
+    for (unsigned spins = 0; value == kPending; value = stamp.load()) {
+        if (++spins % 64 == 0) {
+            std::this_thread::yield();  // the writer was preempted mid-stamp
+        }
+    }
+    return value;
+}
+
+// Geometric with p = 1/4: fewer pointers per node than p = 1/2, same
+// expected search cost within a constant
+inline std::size_t random_level() {
+    thread_local std::uint64_t state =
+        0x9e3779b97f4a7c15ull * (reinterpret_cast<std::uintptr_t>(&state) | 1);
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return 1 + std::min<std::size_t>(std::countr_zero(state | (1ull << 62)) / 2, kMaxLevel - 1);
+}
+
+template <typename Key, typename T>
+struct Node {
+    Key key;
+    T value;
+    std::atomic<std::uint64_t> insert_version{kPending};
+    std::atomic<std::uint64_t> erase_version{kLive};
+    // The list and the inserter still linking the upper levels; whichever
+    // lets go last retires the node, so a late upper-level link can never
+    // make a retired node reachable again
+    std::atomic<std::uint32_t> owners{2};
+    std::size_t height;
+
+    template <typename... Args>
+    Node(std::size_t h, const Key &k, Args &&...args)
+        : key(k), value(std::forward<Args>(args)...), height(h) {}
+
+    // The next pointers follow the node in the same allocation
+    std::atomic<std::uintptr_t> *next() {
+        return reinterpret_cast<std::atomic<std::uintptr_t> *>(this + 1);
+    }
+
+    template <typename... Args>
+    static Node *create(std::size_t height, const Key &key, Args &&...args) {
+        void *mem = ::operator new(sizeof(Node) + height * sizeof(std::atomic<std::uintptr_t>),
+                                   std::align_val_t{alignof(Node)});
+        Node *node;
+        try {
+            node = ::new (mem) Node(height, key, std::forward<Args>(args)...);
+        } catch (...) {
+            ::operator delete(mem, std::align_val_t{alignof(Node)});
+            throw;
+        }
+        for (std::size_t i = 0; i < height; ++i) {
+            ::new (node->next() + i) std::atomic<std::uintptr_t>(0);
+        }
+        return node;
+    }
+
+    static void destroy(Node *node) {
+        node->~Node();
+        ::operator delete(node, std::align_val_t{alignof(Node)});
+    }
+
+    struct Deleter {
+        void operator()(Node *node) const {
+            destroy(node);
+        }
+    };
+};
+
+}  // namespace skiplist_detail
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class concurrent_skip_map {
+    using Node = skiplist_detail::Node<Key, T>;
+    using Word = std::uintptr_t;
+
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using const_reference = std::pair<const Key &, const T &>;
+
+    class snapshot;
+
+    explicit concurrent_skip_map(const Compare &comp = Compare()) : comp_(comp) {
+        for (auto &slot : snapshot_slots_) {
+            slot.store(skiplist_detail::kLive, std::memory_order_relaxed);
+        }
+    }
+
+    concurrent_skip_map(const concurrent_skip_map &) = delete;
+    concurrent_skip_map &operator=(const concurrent_skip_map &) = delete;
+
+    // Requires that no other thread is still using the map
+    ~concurrent_skip_map() {
+        Node *node = as_node(head_[0].load());
+        while (node) {
+            Node *next = as_node(node->next()[0].load());
+            Node::destroy(node);
+            node = next;
+        }
+    }
+
+    // Approximate while writers are running
+    size_type size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // --- Modifiers -------------------------------------------------------------
+
+    // Inserts key -> T(args...) unless key is present; true if inserted
+    template <typename... Args>
+    bool try_emplace(const Key &key, Args &&...args) {
+        ebr::Guard guard;
+        Node *preds[kMaxLevel];
+        Node *succs[kMaxLevel];
+        Node *node = nullptr;
+        for (;;) {
+            find_position(key, preds, succs, false);
+            Node *front = succs[0];
+            if (front && !comp_(key, front->key) &&
+                front->erase_version.load() == skiplist_detail::kPending) {
+                // Linking before an erase still being stamped could give the
+                // new node an older version than the erase, and a snapshot
+                // between the two would see the key twice
+                skiplist_detail::resolved(front->erase_version);
+                continue;
+            }
+            if (front && !comp_(key, front->key) &&
+                front->erase_version.load() == skiplist_detail::kLive) {
+                if (node) {
+                    Node::destroy(node);
+                }
+                return false;
+            }
+            if (!node) {
+                node = Node::create(skiplist_detail::random_level(), key,
+                                    std::forward<Args>(args)...);
+            }
+            for (std::size_t level = 0; level < node->height; ++level) {
+                node->next()[level].store(as_word(succs[level]), std::memory_order_relaxed);
+            }
+            // Linking at level 0 is the insert; upper levels only speed up search
+            Word expected = as_word(front);
+            if (slot(preds[0], 0).compare_exchange_strong(expected, as_word(node))) {
+                break;
+            }
+        }
+        node->insert_version.store(clock_.fetch_add(1) + 1);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        link_upper_levels(node, preds, succs);
+        release(node);
+        return true;
+    }
+
+    bool insert(const std::pair<Key, T> &value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    // True if key was present
+    bool erase(const Key &key) {
+        ebr::Guard guard;
+        Node *preds[kMaxLevel];
+        Node *succs[kMaxLevel];
+        find_position(key, preds, succs, false);
+        // Only the first node of a run of equal keys can be live
+        Node *front = succs[0];
+        if (!front || comp_(key, front->key)) {
+            return false;
+        }
+        // Stamp the erase after the insert it undoes
+        skiplist_detail::resolved(front->insert_version);
+        std::uint64_t expected = skiplist_detail::kLive;
+        if (!front->erase_version.compare_exchange_strong(expected, skiplist_detail::kPending)) {
+            return false;
+        }
+        const std::uint64_t version = clock_.fetch_add(1) + 1;
+        front->erase_version.store(version);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        if (version <= oldest_snapshot()) {
+            remove_node(front);
+        } else {
+            deferred_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // --- Lookup ----------------------------------------------------------------
+
+    bool contains(const Key &key) const {
+        ebr::Guard guard;
+        return live_node(key) != nullptr;
+    }
+
+    std::optional<T> get(const Key &key) const {
+        ebr::Guard guard;
+        if (Node *node = live_node(key)) {
+            return node->value;
+        }
+        return std::nullopt;
+    }
+
+    // Consistent view of the whole map as of now
+    snapshot make_snapshot() const {
+        return snapshot(this);
+    }
+
+    // f(key, value) for keys in [lo, hi), all from one snapshot
+    template <typename F>
+    void for_each_in_range(const Key &lo, const Key &hi, F &&f) const {
+        snapshot snap(this);
+        snap.for_each_in_range(lo, hi, std::forward<F>(f));
+    }
+
+    key_compare key_comp() const {
+        return comp_;
+    }
+
+   private:
+    static constexpr std::size_t kMaxLevel = skiplist_detail::kMaxLevel;
+
+    static Node *as_node(Word word) {
+        return reinterpret_cast<Node *>(word & ~Word{1});
+    }
+    static Word as_word(Node *node) {
+        return reinterpret_cast<Word>(node);
+    }
+
+    // The level-th next pointer of pred; nullptr is the head
+    std::atomic<Word> &slot(Node *pred, std::size_t level) const {
+        return pred ? pred->next()[level] : head_[level];
+    }
+
+    // Fills preds[l] with the last node ordered before key at level l
+    // (nullptr for the head) and succs[l] with the node after it, unlinking
+    // marked nodes on the way. With sweep_equal it also unlinks marked
+    // nodes inside the run of keys equal to key, which is how a remover
+    // makes sure its node is gone from every level.
+    void find_position(const Key &key, Node **preds, Node **succs, bool sweep_equal) const {
+    retry:
+        Node *pred = nullptr;
+        for (std::size_t level = kMaxLevel; level-- > 0;) {
+            Node *curr = as_node(slot(pred, level).load());
+            while (curr) {
+                Word succ = curr->next()[level].load();
+                if (skiplist_detail::is_marked(succ)) {
+                    Word expected = as_word(curr);
+                    if (!slot(pred, level).compare_exchange_strong(expected, succ & ~Word{1})) {
+                        goto retry;
+                    }
+                    curr = as_node(succ);
+                } else if (comp_(curr->key, key)) {
+                    pred = curr;
+                    curr = as_node(succ);
+                } else {
+                    break;
+                }
+            }
+            if (sweep_equal) {
+                Node *run_pred = pred;
+                Node *run = curr;
+                while (run && !comp_(key, run->key)) {
+                    Word succ = run->next()[level].load();
+                    if (skiplist_detail::is_marked(succ)) {
+                        Word expected = as_word(run);
+                        if (!slot(run_pred, level)
+                                 .compare_exchange_strong(expected, succ & ~Word{1})) {
+                            goto retry;
+                        }
+                    } else {
+                        run_pred = run;
+                    }
+                    run = as_node(succ);
+                }
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+    }
+
+    Node *live_node(const Key &key) const {
+        Node *preds[kMaxLevel];
+        Node *succs[kMaxLevel];
+        find_position(key, preds, succs, false);
+        Node *front = succs[0];
+        if (front && !comp_(key, front->key) &&
+            front->erase_version.load() == skiplist_detail::kLive) {
+            return front;
+        }
+        return nullptr;
+    }
+
+    // Called while the inserter still owns node, so a remover racing with
+    // these links cannot retire it until release() after the last one
+    void link_upper_levels(Node *node, Node **preds, Node **succs) {
+        for (std::size_t level = 1; level < node->height; ++level) {
+            for (;;) {
+                Word mine = node->next()[level].load();
+                if (skiplist_detail::is_marked(mine)) {
+                    return;  // already being removed; nothing left to link
+                }
+                Node *succ = succs[level];
+                if (as_node(mine) != succ &&
+                    !node->next()[level].compare_exchange_strong(mine, as_word(succ))) {
+                    return;
+                }
+                Word expected = as_word(succ);
+                if (slot(preds[level], level).compare_exchange_strong(expected, as_word(node))) {
+                    // A remover of node or succ that finished unlinking before
+                    // this link would leave it reachable; unlink it again
+                    if (skiplist_detail::is_marked(node->next()[level].load())) {
+                        find_position(node->key, preds, succs, true);
+                        return;
+                    }
+                    if (succ && skiplist_detail::is_marked(succ->next()[level].load())) {
+                        Node *p[kMaxLevel];
+                        Node *s[kMaxLevel];
+                        find_position(succ->key, p, s, true);
+                    }
+                    break;
+                }
+                find_position(node->key, preds, succs, false);
+            }
+        }
+    }
+
+    // Drops one owner of a linked node; the last one retires it
+    static void release(Node *node) {
+        if (node->owners.fetch_sub(1) == 1) {
+            ebr::retire(node, typename Node::Deleter{});
+        }
+    }
+
+    // Marks node's pointers top-down and unlinks it. Only the thread that
+    // marks level 0 releases the list's hold on the node; returns whether
+    // that was this one.
+    bool remove_node(Node *node) const {
+        for (std::size_t level = node->height; level-- > 1;) {
+            Word succ = node->next()[level].load();
+            while (!skiplist_detail::is_marked(succ) &&
+                   !node->next()[level].compare_exchange_weak(succ,
+                                                              skiplist_detail::with_mark(succ))) {
+            }
+        }
+        Word succ = node->next()[0].load();
+        for (;;) {
+            if (skiplist_detail::is_marked(succ)) {
+                return false;
+            }
+            if (node->next()[0].compare_exchange_weak(succ, skiplist_detail::with_mark(succ))) {
+                break;
+            }
+        }
+        Node *preds[kMaxLevel];
+        Node *succs[kMaxLevel];
+        find_position(node->key, preds, succs, true);
+        release(node);
+        return true;
+    }
+
+    // --- Snapshot bookkeeping ----------------------------------------------------
+
+    // Registers a snapshot; returns {slot, snapshot version}. The bound is
+    // published before the version is read, so an eraser whose scan missed
+    // the slot took its clock tick earlier and the snapshot cannot see the
+    // erased node; one whose scan found it keeps the node if it is newer.
+    std::pair<std::size_t, std::uint64_t> open_snapshot() const {
+        thread_local const std::size_t start =
+            std::hash<std::thread::id>{}(std::this_thread::get_id());
+        const std::uint64_t bound = clock_.load();
+        for (std::size_t i = start;; ++i) {
+            auto &slot = snapshot_slots_[i % skiplist_detail::kSnapshotSlots];
+            std::uint64_t expected = skiplist_detail::kLive;
+            if (slot.load(std::memory_order_relaxed) == expected &&
+                slot.compare_exchange_strong(expected, bound)) {
+                return {i % skiplist_detail::kSnapshotSlots, clock_.load()};
+            }
+            if ((i - start) % skiplist_detail::kSnapshotSlots ==
+                skiplist_detail::kSnapshotSlots - 1) {
+                std::this_thread::yield();  // every slot taken
+            }
+        }
+    }
+
+    void close_snapshot(std::size_t slot) const {
+        snapshot_slots_[slot].store(skiplist_detail::kLive);
+        if (deferred_.load(std::memory_order_relaxed) >=
+            std::max(skiplist_detail::kSweepMinimum, size() / 16)) {
+            sweep();
+        }
+    }
+
+    // Bound of the oldest open snapshot, kLive if none
+    std::uint64_t oldest_snapshot() const {
+        std::uint64_t oldest = skiplist_detail::kLive;
+        for (const auto &slot : snapshot_slots_) {
+            oldest = std::min(oldest, slot.load());
+        }
+        return oldest;
+    }
+
+    // Removes erased nodes that no open snapshot can see any more
+    void sweep() const {
+        ebr::Guard guard;
+        const std::uint64_t oldest = oldest_snapshot();
+        Node *node = as_node(head_[0].load());
+        while (node) {
+            const std::uint64_t erased = node->erase_version.load();
+            if (erased < skiplist_detail::kPending && erased <= oldest &&
+                remove_node(node)) {
+                deferred_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            node = as_node(node->next()[0].load());
+        }
+    }
+
+    Compare comp_;
+    mutable std::array<std::atomic<Word>, kMaxLevel> head_{};
+    mutable std::atomic<std::uint64_t> clock_{0};
+    std::atomic<size_type> size_{0};
+    mutable std::atomic<size_type> deferred_{0};
+
+    mutable std::array<std::atomic<std::uint64_t>, skiplist_detail::kSnapshotSlots>
+        snapshot_slots_;
+
+   public:
+    // The elements present at one version of the map. Iterators are forward
+    // and stay valid while the snapshot lives; writers are never blocked.
+    class snapshot {
+       public:
+        class iterator {
+           public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<Key, T>;
+            using difference_type = std::ptrdiff_t;
+            using reference = const_reference;
+
+            struct pointer {
+                const_reference ref;
+                const const_reference *operator->() const {
+                    return &ref;
+                }
+            };
+
+            iterator() = default;
+
+            reference operator*() const {
+                return {node_->key, node_->value};
+            }
+            pointer operator->() const {
+                return {**this};
+            }
+
+            iterator &operator++() {
+                node_ = next_visible(as_node(node_->next()[0].load()), version_);
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            friend bool operator==(const iterator &a, const iterator &b) {
+                return a.node_ == b.node_;
+            }
+
+           private:
+            friend class snapshot;
+            iterator(Node *node, std::uint64_t version) : node_(node), version_(version) {}
+
+            Node *node_ = nullptr;
+            std::uint64_t version_ = 0;
+        };
+
+        snapshot(const snapshot &) = delete;
+        snapshot &operator=(const snapshot &) = delete;
+        ~snapshot() {
+            map_->close_snapshot(slot_);
+        }
+
+        std::uint64_t version() const noexcept {
+            return version_;
+        }
+
+        iterator begin() const {
+            return {next_visible(as_node(map_->head_[0].load()), version_), version_};
+        }
+        iterator end() const {
+            return {};
+        }
+
+        // First element not ordered before key
+        iterator lower_bound(const Key &key) const {
+            Node *preds[kMaxLevel];
+            Node *succs[kMaxLevel];
+            map_->find_position(key, preds, succs, false);
+            return {next_visible(succs[0], version_), version_};
+        }
+
+        iterator find(const Key &key) const {
+            iterator it = lower_bound(key);
+            return it != end() && !map_->comp_(key, (*it).first) ? it : end();
+        }
+
+        template <typename F>
+        void for_each_in_range(const Key &lo, const Key &hi, F &&f) const {
+            for (auto it = lower_bound(lo); it != end() && map_->comp_((*it).first, hi); ++it) {
+                f((*it).first, (*it).second);
+            }
+        }
+
+       private:
+        friend class concurrent_skip_map;
+
+        explicit snapshot(const concurrent_skip_map *map) : map_(map) {
+            std::tie(slot_, version_) = map_->open_snapshot();
+        }
+
+        static bool visible(Node *node, std::uint64_t version) {
+            return skiplist_detail::resolved(node->insert_version) <= version &&
+                   skiplist_detail::resolved(node->erase_version) > version;
+        }
+
+        static Node *next_visible(Node *node, std::uint64_t version) {
+            while (node && !visible(node, version)) {
+                node = as_node(node->next()[0].load());
+            }
+            return node;
+        }
+
+        ebr::Guard guard_;
+        const concurrent_skip_map *map_;
+        std::size_t slot_ = 0;
+        std::uint64_t version_ = 0;
+    };
+};
+
+}  // namespace day1
@@ -0,0 +1,141 @@
+// day1/examples/cpu_dispatch.hpp
+// Runtime selection between x86-64 microarchitecture levels
+//
+// Release builds target a portable baseline (CPU_BASELINE in CMakeLists.txt,
+// x86-64-v2 unless overridden), so one binary runs on every production CPU.
+// Hot kernels carry extra copies compiled for higher levels with
+// DAY1_TARGET_V3 / DAY1_TARGET_V4 and branch on active_level(), which is the
+// widest level this CPU supports:
+//
+//   v2  SSE4.2, SSSE3, POPCNT          Nehalem, Bulldozer and later
+//   v3  AVX2, FMA, BMI1/2              Haswell, Zen
+//   v4  AVX-512 F, BW, CD, DQ, VL      Skylake-SP, Ice Lake, Zen 4
+//
+//     switch (day1::cpu::active_level()) {
+//         case day1::cpu::Level::v4: return kernel_v4(data, n);
+//         case day1::cpu::Level::v3: return kernel_v3(data, n);
+//         default: return kernel_portable(data, n);
+//     }
+//
+// DAY1_CPU_LEVEL=baseline|v2|v3|v4 in the environment caps the level at
+// startup (to reproduce an older host, or to rule a kernel out); force_level()
+// does the same at run time. Neither can raise the level above the CPU's.
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define DAY1_CPU_X86_DISPATCH 1
+#define DAY1_TARGET_V3 __attribute__((target("arch=x86-64-v3")))
+#define DAY1_TARGET_V4 __attribute__((target("arch=x86-64-v4")))
+#else
+#define DAY1_CPU_X86_DISPATCH 0
+#define DAY1_TARGET_V3
+#define DAY1_TARGET_V4
+#endif
+
+namespace day1::cpu {
+
+// baseline is plain x86-64 (SSE2), or any CPU on other architectures
+enum class Level { baseline, v2, v3, v4 };
+
+inline const char *level_name(Level level) {
+    switch (level) {
+        case Level::v4:
+            return "x86-64-v4";
+        case Level::v3:
+            return "x86-64-v3";
+        case Level::v2:
+            return "x86-64-v2";
+        default:
+            return "baseline";
+    }
+}
+
+// Accepts "v3" as well as "x86-64-v3"
+inline std::optional<Level> parse_level(std::string_view text) {
+    if (text.starts_with("x86-64-")) {
+        text.remove_prefix(7);
+    }
+    if (text == "baseline" || text == "x86-64" || text == "v1") {
+        return Level::baseline;
+    }
+    if (text == "v2") {
+        return Level::v2;
+    }
+    if (text == "v3") {
+        return Level::v3;
+    }
+    if (text == "v4") {
+        return Level::v4;
+    }
+    return std::nullopt;
+}
+
+// Highest level the CPU and OS support; libgcc's checks include the XSAVE
+// state the OS enables, so AVX on a kernel without AVX support reads as v2
+inline Level detect_level() {
+#if DAY1_CPU_X86_DISPATCH
+    __builtin_cpu_init();
+    const bool v2 = __builtin_cpu_supports("sse3") && __builtin_cpu_supports("ssse3") &&
+                    __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("sse4.2") &&
+                    __builtin_cpu_supports("popcnt");
+    const bool v3 = v2 && __builtin_cpu_supports("avx") && __builtin_cpu_supports("avx2") &&
+                    __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2") &&
+                    __builtin_cpu_supports("fma");
+    const bool v4 = v3 && __builtin_cpu_supports("avx512f") &&
+                    __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512cd") &&
+                    __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+    if (v4) {
+        return Level::v4;
+    }
+    if (v3) {
+        return Level::v3;
+    }
+    if (v2) {
+        return Level::v2;
+    }
+#endif
+    return Level::baseline;
+}
+
+namespace cpu_detail {
+
+// An unparsable DAY1_CPU_LEVEL is ignored rather than fatal: a typo in a
+// deployment script should not take the service down
+inline Level startup_level() {
+    Level level = detect_level();
+    if (const char *cap = std::getenv("DAY1_CPU_LEVEL")) {
+        if (auto parsed = parse_level(cap); parsed && *parsed < level) {
+            level = *parsed;
+        }
+    }
+    return level;
+}
+
+inline std::atomic<Level> &active_level_slot() {
+    static std::atomic<Level> level{startup_level()};
+    return level;
+}
+
+}  // namespace cpu_detail
+
+inline Level active_level() {
+    return cpu_detail::active_level_slot().load(std::memory_order_relaxed);
+}
+
+// Switch every dispatched kernel to a level (e.g. to benchmark each tier);
+// requests above what the CPU supports are clamped. Returns the level used.
+inline Level force_level(Level level) {
+    if (level > detect_level()) {
+        level = detect_level();
+    }
+    cpu_detail::active_level_slot().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+}  // namespace day1::cpu
@@ -0,0 +1,215 @@
+// day1/examples/epoch_reclamation.hpp
+// Epoch-based memory reclamation for lock-free containers
+//
+// A lock-free reader may still hold a pointer to a node that another thread
+// has just unlinked, so the node cannot be freed on the spot. Epoch-based
+// reclamation defers the free instead:
+//
+//   - a reader enters a critical section with an ebr::Guard, announcing the
+//     global epoch it saw
+//   - a writer that unlinks a node retires it, tagged with the current epoch
+//   - the global epoch only advances once every thread inside a critical
+//     section has announced the current one, so after two advances no
+//     reader can still see a node retired before them, and it is freed
+//
+//     {
+//         day1::ebr::Guard guard;
+//         Node *n = head.load();       // safe to dereference until the
+//         ...                          // guard goes out of scope
+//     }
+//     day1::ebr::retire(unlinked);     // freed once no guard can see it
+//
+// Guards nest and are cheap (one store and one fence on entry), but a
+// thread that stays inside one holds back reclamation for everybody.
+// Guards are per thread: create and destroy them on the same thread.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "common/cache_line.hpp"
+
+namespace day1::ebr {
+
+namespace ebr_detail {
+
+struct Retired {
+    void *ptr;
+    void (*deleter)(void *);
+    std::uint64_t epoch;
+};
+
+// Per-thread state. Records are never freed: a thread that exits returns its
+// record to the domain and the next new thread reuses it.
+struct alignas(common::kCacheLine) Record {
+    // (epoch << 1) | 1 while inside a critical section, 0 outside
+    std::atomic<std::uint64_t> state{0};
+    std::atomic<bool> claimed{true};
+    Record *next = nullptr;
+    unsigned nesting = 0;
+    std::vector<Retired> retired;
+};
+
+inline constexpr std::size_t kScanEvery = 64;
+
+class Domain {
+   public:
+    Record *acquire() {
+        for (Record *r = head_.load(); r; r = r->next) {
+            bool expected = false;
+            if (!r->claimed.load(std::memory_order_relaxed) &&
+                r->claimed.compare_exchange_strong(expected, true)) {
+                return r;
+            }
+        }
+        auto *r = new Record;
+        r->next = head_.load();
+        while (!head_.compare_exchange_weak(r->next, r)) {
+        }
+        return r;
+    }
+
+    // Nodes the exiting thread could not free yet go to the orphan list
+    void release(Record *r) {
+        if (!r->retired.empty()) {
+            std::lock_guard lock(orphans_mutex_);
+            orphans_.insert(orphans_.end(), r->retired.begin(), r->retired.end());
+            r->retired.clear();
+        }
+        r->claimed.store(false);
+    }
+
+    void enter(Record *r) {
+        if (r->nesting++ == 0) {
+            r->state.store((epoch_.load() << 1) | 1);
+            // The announcement must be visible before any shared pointer is read
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void exit(Record *r) {
+        if (--r->nesting == 0) {
+            r->state.store(0, std::memory_order_release);
+        }
+    }
+
+    void retire(Record *r, void *ptr, void (*deleter)(void *)) {
+        r->retired.push_back({ptr, deleter, epoch_.load()});
+        if (r->retired.size() % kScanEvery == 0) {
+            collect(r);
+        }
+    }
+
+    // Advance the epoch if possible and free what no reader can still see
+    void collect(Record *r) {
+        const std::uint64_t epoch = try_advance();
+        free_before(r->retired, epoch);
+        std::unique_lock lock(orphans_mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            free_before(orphans_, epoch);
+        }
+    }
+
+    std::uint64_t epoch() const {
+        return epoch_.load();
+    }
+
+   private:
+    std::uint64_t try_advance() {
+        std::uint64_t epoch = epoch_.load();
+        for (Record *r = head_.load(); r; r = r->next) {
+            std::uint64_t state = r->state.load();
+            if ((state & 1) && (state >> 1) != epoch) {
+                return epoch;  // a reader is still in an older epoch
+            }
+        }
+        epoch_.compare_exchange_strong(epoch, epoch + 1);
+        return epoch_.load();
+    }
+
+    // Nodes retired in epoch e are unreachable to every reader once the
+    // global epoch reaches e + 2
+    static void free_before(std::vector<Retired> &retired, std::uint64_t epoch) {
+        auto keep = retired.begin();
+        for (auto &item : retired) {
+            if (item.epoch + 2 <= epoch) {
+                item.deleter(item.ptr);
+            } else {
+                *keep++ = item;
+            }
+        }
+        retired.erase(keep, retired.end());
+    }
+
+    std::atomic<std::uint64_t> epoch_{2};
+    std::atomic<Record *> head_{nullptr};
+    std::mutex orphans_mutex_;
+    std::vector<Retired> orphans_;
+};
+
+// Deliberately leaked so it outlives every thread_local handle
+inline Domain &domain() {
+    static Domain *instance = new Domain;
+    return *instance;
+}
+
+struct ThreadHandle {
+    Record *record = domain().acquire();
+    ThreadHandle() = default;
+    ThreadHandle(const ThreadHandle &) = delete;
+    ThreadHandle &operator=(const ThreadHandle &) = delete;
+    ~ThreadHandle() {
+        domain().release(record);
+    }
+};
+
+inline Record *this_thread_record() {
+    thread_local ThreadHandle handle;
+    return handle.record;
+}
+
+}  // namespace ebr_detail
+
+// Scoped critical section; pointers read from lock-free structures stay
+// valid until it ends
+class Guard {
+   public:
+    Guard() : record_(ebr_detail::this_thread_record()) {
+        ebr_detail::domain().enter(record_);
+    }
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+    ~Guard() {
+        ebr_detail::domain().exit(record_);
+    }
+
+   private:
+    ebr_detail::Record *record_;
+};
+
+// Free p with deleter once no current guard can still reach it. p must
+// already be unreachable for new readers.
+template <typename T, typename Deleter>
+void retire(T *p, Deleter) {
+    static_assert(std::is_empty_v<Deleter>, "deleter must be stateless");
+    ebr_detail::domain().retire(ebr_detail::this_thread_record(), p,
+                                [](void *q) { Deleter{}(static_cast<T *>(q)); });
+}
+
+template <typename T>
+void retire(T *p) {
+    retire(p, std::default_delete<T>{});
+}
+
+// Try to advance the epoch and free this thread's eligible nodes now
+inline void collect() {
+    ebr_detail::domain().collect(ebr_detail::this_thread_record());
+}
+
+}  // namespace day1::ebr
@@ -0,0 +1,907 @@
+// day1/examples/flat_hash_map.hpp
+// Swiss-table style open-addressing hash map and set
+//
+// Elements live inline in one slot array; a parallel array of one-byte
+// control words records whether each slot is empty, deleted, or full (and
+// then holds 7 bits of the hash). Lookups compare 16 control bytes at once
+// with SSE2 and only touch slots whose hash fragment matches.
+//
+// Lookups are heterogeneous when both the hasher and key_equal are
+// transparent; day1::string_hash makes `map.find(std::string_view{...})`
+// work on std::string keys without building a temporary string.
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace day1 {
+
+// Transparent hasher for string-like keys
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view text) const noexcept {
+        return std::hash<std::string_view>{}(text);
+    }
+};
+
+template <typename Key>
+struct default_hash : std::hash<Key> {};
+
+template <>
+struct default_hash<std::string> : string_hash {};
+
+namespace hash_detail {
+
+using ctrl_t = std::int8_t;
+
+inline constexpr ctrl_t kEmpty = -128;   // 0b10000000
+inline constexpr ctrl_t kDeleted = -2;   // 0b11111110
+inline constexpr std::size_t kGroupWidth = 16;
+
+// std::hash is the identity for integers; spread the bits so both the
+// probe start (high bits) and the 7-bit fragment (low bits) are usable
+__extension__ using uint128 = unsigned __int128;
+
+inline std::size_t mix(std::size_t hash) {
+    auto product = static_cast<uint128>(hash) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(product) ^ static_cast<std::size_t>(product >> 64);
+}
+
+inline std::size_t h1(std::size_t hash) {
+    return hash >> 7;
+}
+
+inline ctrl_t h2(std::size_t hash) {
+    return static_cast<ctrl_t>(hash & 0x7F);
+}
+
+// Bitmask over the 16 control bytes of a group; iterate set bits in order
+class BitMask {
+   private:
+    std::uint32_t mask_;
+
+   public:
+    explicit BitMask(std::uint32_t mask) : mask_(mask) {}
+
+    explicit operator bool() const {
+        return mask_ != 0;
+    }
+    int lowest() const {
+        return std::countr_zero(mask_);
+    }
+    int trailing_zeros() const {
+        return std::countr_zero(mask_);
+    }
+    int leading_zeros() const {
+        return std::countl_zero(static_cast<std::uint16_t>(mask_));
+    }
+
+    // Range-for support: `for (int i : group.match(h))`
+    BitMask &operator++() {
+        mask_ &= mask_ - 1;
+        return *this;
+    }
+    int operator*() const {
+        return lowest();
+    }
+    BitMask begin() const {
+        return *this;
+    }
+    BitMask end() const {
+        return BitMask(0);
+    }
+    bool operator!=(const BitMask &other) const {
+        return mask_ != other.mask_;
+    }
+};
+
+#if defined(__SSE2__)
+
+struct Group {
+    __m128i ctrl;
+
+    explicit Group(const ctrl_t *pos)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+    BitMask match(ctrl_t hash) const {
+        return BitMask(static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), ctrl))));
+    }
+    BitMask match_empty() const {
+        return match(kEmpty);
+    }
+    // Empty and deleted are the only control values with the sign bit set
+    BitMask match_empty_or_deleted() const {
+        return BitMask(static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl)));
+    }
+};
+
+#else
+
+struct Group {
+    ctrl_t ctrl[kGroupWidth];
+
+    explicit Group(const ctrl_t *pos) {
+        std::memcpy(ctrl, pos, kGroupWidth);
+    }
+
+    BitMask match(ctrl_t hash) const {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < kGroupWidth; ++i) {
+            mask |= static_cast<std::uint32_t>(ctrl[i] == hash) << i;
+        }
+        return BitMask(mask);
+    }
+    BitMask match_empty() const {
+        return match(kEmpty);
+    }
+    BitMask match_empty_or_deleted() const {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < kGroupWidth; ++i) {
+            mask |= static_cast<std::uint32_t>(ctrl[i] < 0) << i;
+        }
+        return BitMask(mask);
+    }
+};
+
+#endif
+
+// Triangular probing over group-sized steps visits every group exactly
+// once when the capacity is a power of two
+class ProbeSeq {
+   private:
+    std::size_t mask_;
+    std::size_t offset_;
+    std::size_t index_ = 0;
+
+   public:
+    ProbeSeq(std::size_t hash, std::size_t mask) : mask_(mask), offset_(hash & mask) {}
+
+    std::size_t offset() const {
+        return offset_;
+    }
+    std::size_t offset(int i) const {
+        return (offset_ + static_cast<std::size_t>(i)) & mask_;
+    }
+    void next() {
+        index_ += kGroupWidth;
+        offset_ = (offset_ + index_) & mask_;
+    }
+};
+
+template <typename T>
+struct is_transparent : std::false_type {};
+
+template <typename T>
+    requires requires { typename T::is_transparent; }
+struct is_transparent<T> : std::true_type {};
+
+// key_arg<K> is K for transparent functors and key_type otherwise, so the
+// heterogeneous overloads simply disappear for plain hashers
+template <bool Transparent>
+struct KeyArg {
+    template <typename K, typename KeyType>
+    using type = K;
+};
+
+template <>
+struct KeyArg<false> {
+    template <typename K, typename KeyType>
+    using type = KeyType;
+};
+
+// Common table; Policy supplies value_type and key extraction
+template <typename Policy, typename Hash, typename Eq, typename Alloc>
+class raw_hash_set {
+   public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+   protected:
+    template <typename K>
+    using key_arg = typename KeyArg<is_transparent<Hash>::value &&
+                                    is_transparent<Eq>::value>::template type<K, key_type>;
+
+   private:
+    union Slot {
+        value_type value;
+        Slot() {}
+        ~Slot() {}
+    };
+
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using CtrlAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<ctrl_t>;
+
+    ctrl_t *ctrl_ = nullptr;
+    Slot *slots_ = nullptr;
+    std::size_t capacity_ = 0;  // 0 or a power of two >= kGroupWidth
+    std::size_t size_ = 0;
+    std::size_t growth_left_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Eq eq_;
+    [[no_unique_address]] Alloc alloc_;
+
+    template <bool Const>
+    class Iterator {
+        friend class raw_hash_set;
+        template <bool>
+        friend class Iterator;
+
+       private:
+        const ctrl_t *ctrl_ = nullptr;
+        Slot *slot_ = nullptr;
+        const ctrl_t *end_ = nullptr;
+
+        Iterator(const ctrl_t *ctrl, Slot *slot, const ctrl_t *end)
+            : ctrl_(ctrl), slot_(slot), end_(end) {}
+
+        void skip_empty() {
+            while (ctrl_ != end_ && *ctrl_ < 0) {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename raw_hash_set::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+
+        Iterator() = default;
+
+        template <bool C = Const>
+            requires C
+        Iterator(const Iterator<false> &other)
+            : ctrl_(other.ctrl_), slot_(other.slot_), end_(other.end_) {}
+
+        reference operator*() const {
+            return slot_->value;
+        }
+        pointer operator->() const {
+            return &slot_->value;
+        }
+        Iterator &operator++() {
+            ++ctrl_;
+            ++slot_;
+            skip_empty();
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        friend bool operator==(const Iterator &a, const Iterator &b) {
+            return a.ctrl_ == b.ctrl_;
+        }
+    };
+
+   public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    raw_hash_set() = default;
+
+    explicit raw_hash_set(std::size_t bucket_count, const Hash &hash = Hash(),
+                          const Eq &eq = Eq(), const Alloc &alloc = Alloc())
+        : hash_(hash), eq_(eq), alloc_(alloc) {
+        reserve(bucket_count);
+    }
+
+    template <std::input_iterator InputIt>
+    raw_hash_set(InputIt first, InputIt last, std::size_t bucket_count = 0,
+                 const Hash &hash = Hash(), const Eq &eq = Eq(), const Alloc &alloc = Alloc())
+        : raw_hash_set(bucket_count, hash, eq, alloc) {
+        insert(first, last);
+    }
+
+    raw_hash_set(std::initializer_list<value_type> init) {
+        reserve(init.size());
+        for (const auto &value : init) {
+            insert(value);
+        }
+    }
+
+    raw_hash_set(const raw_hash_set &other)
+        : hash_(other.hash_), eq_(other.eq_),
+          alloc_(std::allocator_traits<Alloc>::select_on_container_copy_construction(
+              other.alloc_)) {
+        reserve(other.size_);
+        for (const auto &value : other) {
+            insert_unique_unchecked(value);
+        }
+    }
+
+    raw_hash_set(raw_hash_set &&other) noexcept
+        : ctrl_(std::exchange(other.ctrl_, nullptr)),
+          slots_(std::exchange(other.slots_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          growth_left_(std::exchange(other.growth_left_, 0)),
+          hash_(std::move(other.hash_)),
+          eq_(std::move(other.eq_)),
+          alloc_(std::move(other.alloc_)) {}
+
+    raw_hash_set &operator=(const raw_hash_set &other) {
+        if (this != &other) {
+            raw_hash_set copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    raw_hash_set &operator=(raw_hash_set &&other) noexcept {
+        if (this != &other) {
+            destroy_and_deallocate();
+            ctrl_ = std::exchange(other.ctrl_, nullptr);
+            slots_ = std::exchange(other.slots_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            size_ = std::exchange(other.size_, 0);
+            growth_left_ = std::exchange(other.growth_left_, 0);
+            hash_ = std::move(other.hash_);
+            eq_ = std::move(other.eq_);
+            alloc_ = std::move(other.alloc_);
+        }
+        return *this;
+    }
+
+    ~raw_hash_set() {
+        destroy_and_deallocate();
+    }
+
+    void swap(raw_hash_set &other) noexcept {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+        swap(alloc_, other.alloc_);
+    }
+
+    // --- Iteration -----------------------------------------------------------
+
+    iterator begin() {
+        iterator it(ctrl_, slots_, ctrl_ + capacity_);
+        it.skip_empty();
+        return it;
+    }
+    iterator end() {
+        return iterator(ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_);
+    }
+    const_iterator begin() const {
+        return const_cast<raw_hash_set *>(this)->begin();
+    }
+    const_iterator end() const {
+        return const_cast<raw_hash_set *>(this)->end();
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    // --- Capacity ------------------------------------------------------------
+
+    bool empty() const {
+        return size_ == 0;
+    }
+    std::size_t size() const {
+        return size_;
+    }
+    std::size_t capacity() const {
+        return capacity_;
+    }
+    float load_factor() const {
+        return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+    }
+
+    // Make room for `count` elements without further rehashing
+    void reserve(std::size_t count) {
+        if (count > size_ + growth_left_) {
+            resize(capacity_for(count));
+        }
+    }
+
+    void rehash(std::size_t count) {
+        resize(capacity_for(count > size_ ? count : size_));
+    }
+
+    // --- Lookup --------------------------------------------------------------
+
+    template <typename K = key_type>
+    iterator find(const key_arg<K> &key) {
+        return find_impl(key, hash_of(key));
+    }
+
+    template <typename K = key_type>
+    const_iterator find(const key_arg<K> &key) const {
+        return const_cast<raw_hash_set *>(this)->find(key);
+    }
+
+    template <typename K = key_type>
+    bool contains(const key_arg<K> &key) const {
+        return find(key) != end();
+    }
+
+    template <typename K = key_type>
+    std::size_t count(const key_arg<K> &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    // --- Modifiers -----------------------------------------------------------
+
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return emplace_key(Policy::key(value), value);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return emplace_key(Policy::key(value), std::move(value));
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> init) {
+        insert(init.begin(), init.end());
+    }
+
+    // Builds the element first (its key is needed to probe); prefer
+    // try_emplace on maps to avoid that when the key is already present
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        value_type value(std::forward<Args>(args)...);
+        return emplace_key(Policy::key(value), std::move(value));
+    }
+
+    template <typename K = key_type>
+    std::size_t erase(const key_arg<K> &key) {
+        auto it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        erase_slot(static_cast<std::size_t>(it.ctrl_ - ctrl_));
+        return 1;
+    }
+
+    // Returns void: computing the next element is wasted work for the
+    // common erase-by-iterator-and-forget use
+    void erase(const_iterator pos) {
+        erase_slot(static_cast<std::size_t>(pos.ctrl_ - ctrl_));
+    }
+
+    // Exact-match overload so a transparent erase(key) never captures iterators
+    void erase(iterator pos) {
+        erase_slot(static_cast<std::size_t>(pos.ctrl_ - ctrl_));
+    }
+
+    template <typename Pred>
+    std::size_t erase_if(Pred pred) {
+        std::size_t erased = 0;
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] >= 0 && pred(slots_[i].value)) {
+                erase_slot(i);
+                ++erased;
+            }
+        }
+        return erased;
+    }
+
+    void clear() {
+        if (capacity_ == 0) {
+            return;
+        }
+        destroy_elements();
+        reset_ctrl();
+        size_ = 0;
+        growth_left_ = max_load(capacity_);
+    }
+
+    hasher hash_function() const {
+        return hash_;
+    }
+    key_equal key_eq() const {
+        return eq_;
+    }
+    allocator_type get_allocator() const {
+        return alloc_;
+    }
+
+   protected:
+    template <typename K>
+    std::size_t hash_of(const K &key) const {
+        return mix(hash_(key));
+    }
+
+    template <typename K>
+    iterator find_impl(const K &key, std::size_t hash) {
+        if (capacity_ == 0) {
+            return end();
+        }
+        ProbeSeq seq(h1(hash), capacity_ - 1);
+        while (true) {
+            Group group(ctrl_ + seq.offset());
+            for (int i : group.match(h2(hash))) {
+                std::size_t index = seq.offset(i);
+                if (eq_(Policy::key(slots_[index].value), key)) [[likely]] {
+                    return iterator_at(index);
+                }
+            }
+            if (group.match_empty()) [[likely]] {
+                return end();
+            }
+            seq.next();
+        }
+    }
+
+    // Find `key`, or claim a slot for it; the caller constructs the element
+    // when the second member is true
+    template <typename K>
+    std::pair<std::size_t, bool> find_or_prepare_insert(const K &key) {
+        const std::size_t hash = hash_of(key);
+        if (capacity_ != 0) {
+            ProbeSeq seq(h1(hash), capacity_ - 1);
+            while (true) {
+                Group group(ctrl_ + seq.offset());
+                for (int i : group.match(h2(hash))) {
+                    std::size_t index = seq.offset(i);
+                    if (eq_(Policy::key(slots_[index].value), key)) [[likely]] {
+                        return {index, false};
+                    }
+                }
+                if (group.match_empty()) [[likely]] {
+                    break;
+                }
+                seq.next();
+            }
+        }
+        return {prepare_insert(hash), true};
+    }
+
+    template <typename... Args>
+    void construct_at_slot(std::size_t index, Args &&...args) {
+        std::allocator_traits<Alloc>::construct(alloc_, &slots_[index].value,
+                                                std::forward<Args>(args)...);
+    }
+
+    // Undo a prepare_insert whose element constructor threw
+    void abandon_slot(std::size_t index) {
+        --size_;
+        set_ctrl(index, kDeleted);
+    }
+
+    iterator iterator_at(std::size_t index) {
+        return iterator(ctrl_ + index, slots_ + index, ctrl_ + capacity_);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace_key(const K &key, Args &&...args) {
+        auto [index, inserted] = find_or_prepare_insert(key);
+        if (inserted) {
+            try {
+                construct_at_slot(index, std::forward<Args>(args)...);
+            } catch (...) {
+                abandon_slot(index);
+                throw;
+            }
+        }
+        return {iterator_at(index), inserted};
+    }
+
+   private:
+    static std::size_t max_load(std::size_t capacity) {
+        return capacity - capacity / 8;  // 7/8
+    }
+
+    static std::size_t capacity_for(std::size_t count) {
+        if (count == 0) {
+            return 0;
+        }
+        std::size_t needed = count + (count + 6) / 7;  // count / (7/8), rounded up
+        return std::bit_ceil(needed < kGroupWidth ? kGroupWidth : needed);
+    }
+
+    // Keep the first kGroupWidth - 1 control bytes mirrored after the end so
+    // an unaligned group load never needs to wrap
+    void set_ctrl(std::size_t index, ctrl_t value) {
+        ctrl_[index] = value;
+        ctrl_[((index - (kGroupWidth - 1)) & (capacity_ - 1)) + (kGroupWidth - 1)] = value;
+    }
+
+    void reset_ctrl() {
+        std::memset(ctrl_, static_cast<unsigned char>(kEmpty), capacity_ + kGroupWidth - 1);
+    }
+
+    std::size_t find_first_non_full(std::size_t hash) const {
+        ProbeSeq seq(h1(hash), capacity_ - 1);
+        while (true) {
+            BitMask mask = Group(ctrl_ + seq.offset()).match_empty_or_deleted();
+            if (mask) {
+                return seq.offset(mask.lowest());
+            }
+            seq.next();
+        }
+    }
+
+    std::size_t prepare_insert(std::size_t hash) {
+        std::size_t target = capacity_ == 0 ? 0 : find_first_non_full(hash);
+        if (growth_left_ == 0 && (capacity_ == 0 || ctrl_[target] != kDeleted)) [[unlikely]] {
+            rehash_and_grow();
+            target = find_first_non_full(hash);
+        }
+        ++size_;
+        growth_left_ -= ctrl_[target] == kEmpty ? 1 : 0;
+        set_ctrl(target, h2(hash));
+        return target;
+    }
+
+    void rehash_and_grow() {
+        // Mostly tombstones: rebuild at the same size instead of doubling
+        if (capacity_ != 0 && size_ <= max_load(capacity_) / 2) {
+            resize(capacity_);
+        } else {
+            resize(capacity_ == 0 ? kGroupWidth : capacity_ * 2);
+        }
+    }
+
+    void insert_unique_unchecked(const value_type &value) {
+        const std::size_t hash = hash_of(Policy::key(value));
+        std::size_t index = find_first_non_full(hash);
+        set_ctrl(index, h2(hash));
+        construct_at_slot(index, value);
+        ++size_;
+        --growth_left_;
+    }
+
+    void resize(std::size_t new_capacity) {
+        ctrl_t *old_ctrl = ctrl_;
+        Slot *old_slots = slots_;
+        const std::size_t old_capacity = capacity_;
+
+        if (new_capacity == 0) {
+            destroy_and_deallocate();
+            return;
+        }
+
+        SlotAlloc slot_alloc(alloc_);
+        CtrlAlloc ctrl_alloc(alloc_);
+        slots_ = std::allocator_traits<SlotAlloc>::allocate(slot_alloc, new_capacity);
+        try {
+            ctrl_ = std::allocator_traits<CtrlAlloc>::allocate(ctrl_alloc,
+                                                               new_capacity + kGroupWidth - 1);
+        } catch (...) {
+            std::allocator_traits<SlotAlloc>::deallocate(slot_alloc, slots_, new_capacity);
+            slots_ = old_slots;
+            throw;
+        }
+        capacity_ = new_capacity;
+        reset_ctrl();
+        growth_left_ = max_load(capacity_) - size_;
+
+        for (std::size_t i = 0; i < old_capacity; ++i) {
+            if (old_ctrl[i] >= 0) {
+                value_type &old = old_slots[i].value;
+                const std::size_t hash = hash_of(Policy::key(old));
+                std::size_t index = find_first_non_full(hash);
+                set_ctrl(index, h2(hash));
+                Policy::transfer(alloc_, &slots_[index].value, &old);
+            }
+        }
+
+        if (old_capacity != 0) {
+            std::allocator_traits<SlotAlloc>::deallocate(slot_alloc, old_slots, old_capacity);
+            std::allocator_traits<CtrlAlloc>::deallocate(ctrl_alloc, old_ctrl,
+                                                         old_capacity + kGroupWidth - 1);
+        }
+    }
+
+    void erase_slot(std::size_t index) {
+        std::allocator_traits<Alloc>::destroy(alloc_, &slots_[index].value);
+        --size_;
+
+        // If no group window covering this slot was ever full, no probe
+        // sequence can have skipped past it and it can go straight to empty
+        const std::size_t before_index = (index - kGroupWidth) & (capacity_ - 1);
+        BitMask empty_after = Group(ctrl_ + index).match_empty();
+        BitMask empty_before = Group(ctrl_ + before_index).match_empty();
+        const bool was_never_full =
+            empty_before && empty_after &&
+            static_cast<std::size_t>(empty_after.trailing_zeros() + empty_before.leading_zeros()) <
+                kGroupWidth;
+
+        set_ctrl(index, was_never_full ? kEmpty : kDeleted);
+        growth_left_ += was_never_full ? 1 : 0;
+    }
+
+    void destroy_elements() {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (std::size_t i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] >= 0) {
+                    std::allocator_traits<Alloc>::destroy(alloc_, &slots_[i].value);
+                }
+            }
+        }
+    }
+
+    void destroy_and_deallocate() {
+        if (capacity_ == 0) {
+            return;
+        }
+        destroy_elements();
+        SlotAlloc slot_alloc(alloc_);
+        CtrlAlloc ctrl_alloc(alloc_);
+        std::allocator_traits<SlotAlloc>::deallocate(slot_alloc, slots_, capacity_);
+        std::allocator_traits<CtrlAlloc>::deallocate(ctrl_alloc, ctrl_,
+                                                     capacity_ + kGroupWidth - 1);
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = size_ = growth_left_ = 0;
+    }
+};
+
+template <typename Key>
+struct SetPolicy {
+    using key_type = Key;
+    using value_type = Key;
+
+    static const Key &key(const value_type &value) {
+        return value;
+    }
+
+    template <typename Alloc>
+    static void transfer(Alloc &alloc, value_type *dst, value_type *src) {
+        std::allocator_traits<Alloc>::construct(alloc, dst, std::move(*src));
+        std::allocator_traits<Alloc>::destroy(alloc, src);
+    }
+};
+
+template <typename Key, typename Value>
+struct MapPolicy {
+    using key_type = Key;
+    using value_type = std::pair<const Key, Value>;
+
+    static const Key &key(const value_type &value) {
+        return value.first;
+    }
+
+    // Relocation during rehash moves the key too; the source slot is
+    // destroyed immediately after, so nothing observes the moved-from key
+    template <typename Alloc>
+    static void transfer(Alloc &alloc, value_type *dst, value_type *src) {
+        std::allocator_traits<Alloc>::construct(alloc, dst,
+                                                std::move(const_cast<Key &>(src->first)),
+                                                std::move(src->second));
+        std::allocator_traits<Alloc>::destroy(alloc, src);
+    }
+};
+
+}  // namespace hash_detail
+
+template <typename Key, typename Hash = default_hash<Key>, typename Eq = std::equal_to<>,
+          typename Alloc = std::allocator<Key>>
+class flat_hash_set
+    : public hash_detail::raw_hash_set<hash_detail::SetPolicy<Key>, Hash, Eq, Alloc> {
+    using Base = hash_detail::raw_hash_set<hash_detail::SetPolicy<Key>, Hash, Eq, Alloc>;
+
+   public:
+    using Base::Base;
+    using Base::insert;
+
+    // Heterogeneous insert: only builds a Key when the lookup misses
+    template <typename K = Key>
+        requires(!std::is_same_v<std::remove_cvref_t<K>, Key>)
+    std::pair<typename Base::iterator, bool> insert(const typename Base::template key_arg<K> &key) {
+        return this->emplace_key(key, key);
+    }
+};
+
+template <typename Key, typename Value, typename Hash = default_hash<Key>,
+          typename Eq = std::equal_to<>,
+          typename Alloc = std::allocator<std::pair<const Key, Value>>>
+class flat_hash_map
+    : public hash_detail::raw_hash_set<hash_detail::MapPolicy<Key, Value>, Hash, Eq, Alloc> {
+    using Base = hash_detail::raw_hash_set<hash_detail::MapPolicy<Key, Value>, Hash, Eq, Alloc>;
+
+    template <typename K>
+    using key_arg = typename Base::template key_arg<K>;
+
+   public:
+    using mapped_type = Value;
+    using typename Base::iterator;
+
+    using Base::Base;
+
+    // Constructs the mapped value only if `key` is absent
+    template <typename K = Key, typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_arg<K> &key, Args &&...args) {
+        return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                 std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+        return this->emplace_key(key, std::piecewise_construct,
+                                 std::forward_as_tuple(std::move(key)),
+                                 std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <typename K = Key, typename V>
+    std::pair<iterator, bool> insert_or_assign(const key_arg<K> &key, V &&value) {
+        auto result = try_emplace<K>(key, std::forward<V>(value));
+        if (!result.second) {
+            result.first->second = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(Key &&key, V &&value) {
+        auto result = try_emplace(std::move(key), std::forward<V>(value));
+        if (!result.second) {
+            result.first->second = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    template <typename K = Key>
+    Value &operator[](const key_arg<K> &key) {
+        return try_emplace<K>(key).first->second;
+    }
+
+    Value &operator[](Key &&key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    template <typename K = Key>
+    Value &at(const key_arg<K> &key) {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("flat_hash_map::at: key not found");
+        }
+        return it->second;
+    }
+
+    template <typename K = Key>
+    const Value &at(const key_arg<K> &key) const {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("flat_hash_map::at: key not found");
+        }
+        return it->second;
+    }
+};
+
+}  // namespace day1
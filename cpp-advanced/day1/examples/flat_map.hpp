@@ -0,0 +1,848 @@
+// day1/examples/flat_map.hpp
+// Sorted-vector flat_map / flat_set
+//
+// Keys and mapped values are kept in two separate sorted arrays (the C++23
+// std::flat_map layout), so key searches touch only the dense key array and
+// range scans are linear walks over contiguous memory.
+//
+// Bulk operations are the point of the design:
+//   - construction from unsorted input sorts once: O(n log n)
+//   - insert(first, last) sorts the batch and merges it in: O(n + m log m)
+//   - extract_range()/merge() move whole runs of elements between maps,
+//     the flat equivalent of std::map node extract/insert
+// Single-element insert/erase shift the tail and are O(n).
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace day1 {
+
+// Tag for constructors whose input is already sorted and duplicate-free
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+namespace flat_detail {
+
+template <typename Compare, typename = void>
+struct is_transparent : std::false_type {};
+
+template <typename Compare>
+struct is_transparent<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+
+// Indices of the first occurrence of each distinct key, in key order
+template <typename KeyContainer, typename Compare>
+std::vector<std::size_t> sorted_unique_permutation(const KeyContainer &keys, const Compare &comp) {
+    std::vector<std::size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return comp(keys[a], keys[b]); });
+    auto last = std::unique(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return !comp(keys[a], keys[b]) && !comp(keys[b], keys[a]);
+    });
+    order.erase(last, order.end());
+    return order;
+}
+
+template <typename Container>
+Container apply_permutation(Container &source, const std::vector<std::size_t> &order) {
+    Container result;
+    result.reserve(order.size());
+    for (std::size_t index : order) {
+        result.push_back(std::move(source[index]));
+    }
+    return result;
+}
+
+}  // namespace flat_detail
+
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename KeyContainer = std::vector<Key>, typename MappedContainer = std::vector<T>>
+class flat_map {
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using reference = std::pair<const Key &, T &>;
+    using const_reference = std::pair<const Key &, const T &>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_container_type = KeyContainer;
+    using mapped_container_type = MappedContainer;
+
+    struct containers {
+        KeyContainer keys;
+        MappedContainer values;
+    };
+
+   private:
+    containers c_;
+    [[no_unique_address]] Compare comp_;
+
+    template <typename K>
+    static constexpr bool kTransparent =
+        flat_detail::is_transparent<Compare>::value || std::is_same_v<K, Key>;
+
+    // Random-access iterator yielding pair<const Key&, T&> proxies
+    template <bool Const>
+    class Iterator {
+        friend class flat_map;
+        template <bool>
+        friend class Iterator;
+
+        using KeyIt = typename KeyContainer::const_iterator;
+        using ValueIt = std::conditional_t<Const, typename MappedContainer::const_iterator,
+                                           typename MappedContainer::iterator>;
+
+        KeyIt key_;
+        ValueIt value_;
+
+        Iterator(KeyIt key, ValueIt value) : key_(key), value_(value) {}
+
+       public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = typename flat_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const_reference, typename flat_map::reference>;
+
+        struct pointer {
+            reference ref;
+            const reference *operator->() const {
+                return &ref;
+            }
+        };
+
+        Iterator() = default;
+
+        template <bool C = Const>
+            requires C
+        Iterator(const Iterator<false> &other) : key_(other.key_), value_(other.value_) {}
+
+        reference operator*() const {
+            return {*key_, *value_};
+        }
+        pointer operator->() const {
+            return {**this};
+        }
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        Iterator &operator++() {
+            ++key_;
+            ++value_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        Iterator &operator--() {
+            --key_;
+            --value_;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+        Iterator &operator+=(difference_type n) {
+            key_ += n;
+            value_ += n;
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) {
+            return *this += -n;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &a, const Iterator &b) {
+            return a.key_ - b.key_;
+        }
+        friend bool operator==(const Iterator &a, const Iterator &b) {
+            return a.key_ == b.key_;
+        }
+        friend auto operator<=>(const Iterator &a, const Iterator &b) {
+            return a.key_ <=> b.key_;
+        }
+    };
+
+   public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    flat_map() = default;
+
+    explicit flat_map(const Compare &comp) : comp_(comp) {}
+
+    // Bulk build from unsorted parallel containers; for duplicate keys the
+    // first occurrence wins
+    flat_map(KeyContainer keys, MappedContainer values, const Compare &comp = Compare())
+        : comp_(comp) {
+        if (keys.size() != values.size()) {
+            throw std::invalid_argument("flat_map: key and value containers differ in size");
+        }
+        auto order = flat_detail::sorted_unique_permutation(keys, comp_);
+        c_.keys = flat_detail::apply_permutation(keys, order);
+        c_.values = flat_detail::apply_permutation(values, order);
+    }
+
+    // Adopt containers that are already sorted and unique: O(1)
+    flat_map(sorted_unique_t, KeyContainer keys, MappedContainer values,
+             const Compare &comp = Compare())
+        : c_{std::move(keys), std::move(values)}, comp_(comp) {}
+
+    template <std::input_iterator InputIt>
+    flat_map(InputIt first, InputIt last, const Compare &comp = Compare()) : comp_(comp) {
+        KeyContainer keys;
+        MappedContainer values;
+        for (; first != last; ++first) {
+            keys.push_back(first->first);
+            values.push_back(first->second);
+        }
+        *this = flat_map(std::move(keys), std::move(values), comp);
+    }
+
+    flat_map(std::initializer_list<value_type> init, const Compare &comp = Compare())
+        : flat_map(init.begin(), init.end(), comp) {}
+
+    // --- Iteration -----------------------------------------------------------
+
+    iterator begin() {
+        return {c_.keys.cbegin(), c_.values.begin()};
+    }
+    iterator end() {
+        return {c_.keys.cend(), c_.values.end()};
+    }
+    const_iterator begin() const {
+        return {c_.keys.cbegin(), c_.values.cbegin()};
+    }
+    const_iterator end() const {
+        return {c_.keys.cend(), c_.values.cend()};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    // Direct access to the underlying sorted arrays
+    const KeyContainer &keys() const noexcept {
+        return c_.keys;
+    }
+    const MappedContainer &values() const noexcept {
+        return c_.values;
+    }
+
+    // --- Capacity ------------------------------------------------------------
+
+    bool empty() const noexcept {
+        return c_.keys.empty();
+    }
+    size_type size() const noexcept {
+        return c_.keys.size();
+    }
+    void reserve(size_type count) {
+        c_.keys.reserve(count);
+        c_.values.reserve(count);
+    }
+    void shrink_to_fit() {
+        c_.keys.shrink_to_fit();
+        c_.values.shrink_to_fit();
+    }
+
+    // --- Lookup --------------------------------------------------------------
+
+    template <typename K>
+        requires kTransparent<K>
+    iterator lower_bound(const K &key) {
+        return iterator_at(key_lower_bound(key));
+    }
+    template <typename K>
+        requires kTransparent<K>
+    const_iterator lower_bound(const K &key) const {
+        return const_iterator_at(key_lower_bound(key));
+    }
+    iterator lower_bound(const Key &key) {
+        return iterator_at(key_lower_bound(key));
+    }
+    const_iterator lower_bound(const Key &key) const {
+        return const_iterator_at(key_lower_bound(key));
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    iterator upper_bound(const K &key) {
+        return iterator_at(key_upper_bound(key));
+    }
+    template <typename K>
+        requires kTransparent<K>
+    const_iterator upper_bound(const K &key) const {
+        return const_iterator_at(key_upper_bound(key));
+    }
+    iterator upper_bound(const Key &key) {
+        return iterator_at(key_upper_bound(key));
+    }
+    const_iterator upper_bound(const Key &key) const {
+        return const_iterator_at(key_upper_bound(key));
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    iterator find(const K &key) {
+        return iterator_at(find_index(key));
+    }
+    template <typename K>
+        requires kTransparent<K>
+    const_iterator find(const K &key) const {
+        return const_iterator_at(find_index(key));
+    }
+    iterator find(const Key &key) {
+        return iterator_at(find_index(key));
+    }
+    const_iterator find(const Key &key) const {
+        return const_iterator_at(find_index(key));
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    bool contains(const K &key) const {
+        return find_index(key) != size();
+    }
+    bool contains(const Key &key) const {
+        return find_index(key) != size();
+    }
+
+    size_type count(const Key &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    T &at(const Key &key) {
+        std::size_t index = find_index(key);
+        if (index == size()) {
+            throw std::out_of_range("flat_map::at: key not found");
+        }
+        return c_.values[index];
+    }
+    const T &at(const Key &key) const {
+        return const_cast<flat_map *>(this)->at(key);
+    }
+
+    // Visit every element with lo <= key < hi in key order
+    template <typename F>
+    void for_each_in_range(const Key &lo, const Key &hi, F &&f) const {
+        std::size_t first = key_lower_bound(lo);
+        std::size_t last = key_lower_bound(hi);
+        for (std::size_t i = first; i < last; ++i) {
+            f(c_.keys[i], c_.values[i]);
+        }
+    }
+
+    // --- Single-element modifiers (O(n) shifts) ------------------------------
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+        std::size_t index = key_lower_bound(key);
+        if (index != size() && !comp_(key, c_.keys[index])) {
+            return {iterator_at(index), false};
+        }
+        return {emplace_at(index, key, std::forward<Args>(args)...), true};
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+        std::size_t index = key_lower_bound(key);
+        if (index != size() && !comp_(key, c_.keys[index])) {
+            return {iterator_at(index), false};
+        }
+        return {emplace_at(index, std::move(key), std::forward<Args>(args)...), true};
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, V &&value) {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result.second) {
+            c_.values[index_of(result.first)] = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return try_emplace(value.first, value.second);
+    }
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        value_type value(std::forward<Args>(args)...);
+        return insert(std::move(value));
+    }
+
+    T &operator[](const Key &key) {
+        return c_.values[index_of(try_emplace(key).first)];
+    }
+    T &operator[](Key &&key) {
+        return c_.values[index_of(try_emplace(std::move(key)).first)];
+    }
+
+    size_type erase(const Key &key) {
+        std::size_t index = find_index(key);
+        if (index == size()) {
+            return 0;
+        }
+        erase_indices(index, index + 1);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        std::size_t index = index_of(pos);
+        erase_indices(index, index + 1);
+        return iterator_at(index);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        std::size_t index = index_of(first);
+        erase_indices(index, index_of(last));
+        return iterator_at(index);
+    }
+
+    template <typename Pred>
+    size_type erase_if(Pred pred) {
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < size(); ++i) {
+            if (!pred(const_reference{c_.keys[i], c_.values[i]})) {
+                if (out != i) {
+                    c_.keys[out] = std::move(c_.keys[i]);
+                    c_.values[out] = std::move(c_.values[i]);
+                }
+                ++out;
+            }
+        }
+        std::size_t erased = size() - out;
+        erase_indices(out, size());
+        return erased;
+    }
+
+    void clear() noexcept {
+        c_.keys.clear();
+        c_.values.clear();
+    }
+
+    void swap(flat_map &other) noexcept {
+        using std::swap;
+        swap(c_.keys, other.c_.keys);
+        swap(c_.values, other.c_.values);
+        swap(comp_, other.comp_);
+    }
+
+    // --- Bulk modifiers ------------------------------------------------------
+
+    // Batch insert: sort the new elements once, drop keys already present,
+    // then merge in one pass so existing elements move once
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last) {
+        KeyContainer keys;
+        MappedContainer values;
+        for (; first != last; ++first) {
+            keys.push_back(first->first);
+            values.push_back(first->second);
+        }
+        auto order = flat_detail::sorted_unique_permutation(keys, comp_);
+        merge_sorted(flat_detail::apply_permutation(keys, order),
+                     flat_detail::apply_permutation(values, order));
+    }
+
+    void insert(std::initializer_list<value_type> init) {
+        insert(init.begin(), init.end());
+    }
+
+    // Batch insert of input that is already sorted and unique
+    void insert(sorted_unique_t, KeyContainer keys, MappedContainer values) {
+        merge_sorted(std::move(keys), std::move(values));
+    }
+
+    // Move every element of `source` whose key is absent here; elements
+    // with duplicate keys stay in `source` (same contract as std::map::merge)
+    void merge(flat_map &source) {
+        if (&source == this || source.empty()) {
+            return;
+        }
+        containers kept;
+        containers moved;
+        for (std::size_t i = 0, j = 0; i < source.size(); ++i) {
+            while (j < size() && comp_(c_.keys[j], source.c_.keys[i])) {
+                ++j;
+            }
+            containers &target =
+                (j < size() && !comp_(source.c_.keys[i], c_.keys[j])) ? kept : moved;
+            target.keys.push_back(std::move(source.c_.keys[i]));
+            target.values.push_back(std::move(source.c_.values[i]));
+        }
+        source.c_ = std::move(kept);
+        merge_sorted(std::move(moved.keys), std::move(moved.values));
+    }
+
+    void merge(flat_map &&source) {
+        merge(source);
+    }
+
+    // Remove every element with lo <= key < hi and return them as a new map;
+    // the flat counterpart of extracting a run of std::map nodes
+    flat_map extract_range(const Key &lo, const Key &hi) {
+        std::size_t first = key_lower_bound(lo);
+        std::size_t last = std::max(first, key_lower_bound(hi));
+        KeyContainer keys(std::make_move_iterator(c_.keys.begin() + first),
+                          std::make_move_iterator(c_.keys.begin() + last));
+        MappedContainer values(std::make_move_iterator(c_.values.begin() + first),
+                               std::make_move_iterator(c_.values.begin() + last));
+        erase_indices(first, last);
+        return flat_map(sorted_unique, std::move(keys), std::move(values), comp_);
+    }
+
+    // Hand over the underlying containers, leaving the map empty
+    containers extract() && {
+        containers result = std::move(c_);
+        clear();
+        return result;
+    }
+
+    // Adopt new sorted-unique containers
+    void replace(KeyContainer &&keys, MappedContainer &&values) {
+        c_.keys = std::move(keys);
+        c_.values = std::move(values);
+    }
+
+    key_compare key_comp() const {
+        return comp_;
+    }
+
+    friend bool operator==(const flat_map &a, const flat_map &b) {
+        return a.c_.keys == b.c_.keys && a.c_.values == b.c_.values;
+    }
+
+   private:
+    template <typename K>
+    std::size_t key_lower_bound(const K &key) const {
+        return static_cast<std::size_t>(
+            std::lower_bound(c_.keys.begin(), c_.keys.end(), key, comp_) - c_.keys.begin());
+    }
+
+    template <typename K>
+    std::size_t key_upper_bound(const K &key) const {
+        return static_cast<std::size_t>(
+            std::upper_bound(c_.keys.begin(), c_.keys.end(), key, comp_) - c_.keys.begin());
+    }
+
+    template <typename K>
+    std::size_t find_index(const K &key) const {
+        std::size_t index = key_lower_bound(key);
+        return (index != size() && !comp_(key, c_.keys[index])) ? index : size();
+    }
+
+    iterator iterator_at(std::size_t index) {
+        return {c_.keys.cbegin() + static_cast<difference_type>(index),
+                c_.values.begin() + static_cast<difference_type>(index)};
+    }
+
+    const_iterator const_iterator_at(std::size_t index) const {
+        return {c_.keys.cbegin() + static_cast<difference_type>(index),
+                c_.values.cbegin() + static_cast<difference_type>(index)};
+    }
+
+    template <bool Const>
+    std::size_t index_of(const Iterator<Const> &it) const {
+        return static_cast<std::size_t>(it.key_ - c_.keys.cbegin());
+    }
+
+    template <typename K, typename... Args>
+    iterator emplace_at(std::size_t index, K &&key, Args &&...args) {
+        const auto offset = static_cast<difference_type>(index);
+        c_.keys.insert(c_.keys.begin() + offset, std::forward<K>(key));
+        try {
+            c_.values.emplace(c_.values.begin() + offset, std::forward<Args>(args)...);
+        } catch (...) {
+            c_.keys.erase(c_.keys.begin() + offset);
+            throw;
+        }
+        return iterator_at(index);
+    }
+
+    void erase_indices(std::size_t first, std::size_t last) {
+        c_.keys.erase(c_.keys.begin() + static_cast<difference_type>(first),
+                      c_.keys.begin() + static_cast<difference_type>(last));
+        c_.values.erase(c_.values.begin() + static_cast<difference_type>(first),
+                        c_.values.begin() + static_cast<difference_type>(last));
+    }
+
+    // Merge sorted-unique containers into this map, keeping existing values
+    // on key collisions. The result is allocated once and filled front to
+    // back by moves, so T need not be default constructible.
+    void merge_sorted(KeyContainer keys, MappedContainer values) {
+        // Drop incoming keys that already exist (linear walk over both)
+        std::size_t out = 0;
+        for (std::size_t i = 0, j = 0; i < keys.size(); ++i) {
+            while (j < size() && comp_(c_.keys[j], keys[i])) {
+                ++j;
+            }
+            if (j < size() && !comp_(keys[i], c_.keys[j])) {
+                continue;
+            }
+            if (out != i) {
+                keys[out] = std::move(keys[i]);
+                values[out] = std::move(values[i]);
+            }
+            ++out;
+        }
+        if (out == 0) {
+            return;
+        }
+
+        const std::size_t old_size = size();
+        containers merged;
+        merged.keys.reserve(old_size + out);
+        merged.values.reserve(old_size + out);
+        std::size_t a = 0;  // next existing element
+        std::size_t b = 0;  // next incoming element
+        while (a < old_size || b < out) {
+            if (b == out || (a < old_size && comp_(c_.keys[a], keys[b]))) {
+                merged.keys.emplace_back(std::move(c_.keys[a]));
+                merged.values.emplace_back(std::move(c_.values[a]));
+                ++a;
+            } else {
+                merged.keys.emplace_back(std::move(keys[b]));
+                merged.values.emplace_back(std::move(values[b]));
+                ++b;
+            }
+        }
+        c_ = std::move(merged);
+    }
+};
+
+template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>>
+class flat_set {
+   public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using container_type = KeyContainer;
+    using iterator = typename KeyContainer::const_iterator;
+    using const_iterator = typename KeyContainer::const_iterator;
+
+   private:
+    KeyContainer keys_;
+    [[no_unique_address]] Compare comp_;
+
+    template <typename K>
+    static constexpr bool kTransparent =
+        flat_detail::is_transparent<Compare>::value || std::is_same_v<K, Key>;
+
+    bool equivalent(const Key &a, const Key &b) const {
+        return !comp_(a, b) && !comp_(b, a);
+    }
+
+    void sort_unique(KeyContainer &keys) const {
+        std::stable_sort(keys.begin(), keys.end(), comp_);
+        keys.erase(std::unique(keys.begin(), keys.end(),
+                               [this](const Key &a, const Key &b) { return equivalent(a, b); }),
+                   keys.end());
+    }
+
+   public:
+    flat_set() = default;
+
+    explicit flat_set(KeyContainer keys, const Compare &comp = Compare())
+        : keys_(std::move(keys)), comp_(comp) {
+        sort_unique(keys_);
+    }
+
+    flat_set(sorted_unique_t, KeyContainer keys, const Compare &comp = Compare())
+        : keys_(std::move(keys)), comp_(comp) {}
+
+    template <std::input_iterator InputIt>
+    flat_set(InputIt first, InputIt last, const Compare &comp = Compare())
+        : flat_set(KeyContainer(first, last), comp) {}
+
+    flat_set(std::initializer_list<Key> init, const Compare &comp = Compare())
+        : flat_set(KeyContainer(init), comp) {}
+
+    iterator begin() const {
+        return keys_.cbegin();
+    }
+    iterator end() const {
+        return keys_.cend();
+    }
+    bool empty() const noexcept {
+        return keys_.empty();
+    }
+    size_type size() const noexcept {
+        return keys_.size();
+    }
+    void reserve(size_type count) {
+        keys_.reserve(count);
+    }
+    const KeyContainer &keys() const noexcept {
+        return keys_;
+    }
+
+    template <typename K>
+        requires kTransparent<K>
+    iterator lower_bound(const K &key) const {
+        return std::lower_bound(keys_.begin(), keys_.end(), key, comp_);
+    }
+    template <typename K>
+        requires kTransparent<K>
+    iterator upper_bound(const K &key) const {
+        return std::upper_bound(keys_.begin(), keys_.end(), key, comp_);
+    }
+    template <typename K>
+        requires kTransparent<K>
+    iterator find(const K &key) const {
+        auto it = lower_bound(key);
+        return (it != end() && !comp_(key, *it)) ? it : end();
+    }
+    template <typename K>
+        requires kTransparent<K>
+    bool contains(const K &key) const {
+        return find(key) != end();
+    }
+
+    std::pair<iterator, bool> insert(Key key) {
+        auto it = lower_bound(key);
+        if (it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        return {keys_.insert(it, std::move(key)), true};
+    }
+
+    // Batch insert: sort the batch, then merge it in one pass
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last) {
+        KeyContainer batch(first, last);
+        sort_unique(batch);
+        merge_sorted(std::move(batch));
+    }
+
+    void insert(sorted_unique_t, KeyContainer keys) {
+        merge_sorted(std::move(keys));
+    }
+
+    size_type erase(const Key &key) {
+        auto it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        keys_.erase(it);
+        return 1;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return keys_.erase(first, last);
+    }
+
+    void clear() noexcept {
+        keys_.clear();
+    }
+
+    void merge(flat_set &source) {
+        if (&source == this) {
+            return;
+        }
+        KeyContainer kept;
+        KeyContainer moved;
+        for (auto &key : source.keys_) {
+            (contains(key) ? kept : moved).push_back(std::move(key));
+        }
+        source.keys_ = std::move(kept);
+        merge_sorted(std::move(moved));
+    }
+
+    // Remove every key in [lo, hi) and return them as a new set
+    flat_set extract_range(const Key &lo, const Key &hi) {
+        auto first = lower_bound(lo);
+        auto last = std::max(first, lower_bound(hi));
+        KeyContainer moved(std::make_move_iterator(keys_.begin() + (first - keys_.cbegin())),
+                           std::make_move_iterator(keys_.begin() + (last - keys_.cbegin())));
+        keys_.erase(first, last);
+        return flat_set(sorted_unique, std::move(moved), comp_);
+    }
+
+    KeyContainer extract() && {
+        KeyContainer result = std::move(keys_);
+        keys_.clear();
+        return result;
+    }
+
+    void replace(KeyContainer &&keys) {
+        keys_ = std::move(keys);
+    }
+
+    friend bool operator==(const flat_set &a, const flat_set &b) {
+        return a.keys_ == b.keys_;
+    }
+
+   private:
+    void merge_sorted(KeyContainer incoming) {
+        auto last = std::remove_if(incoming.begin(), incoming.end(),
+                                   [this](const Key &key) { return contains(key); });
+        incoming.erase(last, incoming.end());
+        if (incoming.empty()) {
+            return;
+        }
+        KeyContainer merged;
+        merged.reserve(keys_.size() + incoming.size());
+        std::size_t a = 0;
+        std::size_t b = 0;
+        while (a < keys_.size() || b < incoming.size()) {
+            if (b == incoming.size() || (a < keys_.size() && comp_(keys_[a], incoming[b]))) {
+                merged.emplace_back(std::move(keys_[a++]));
+            } else {
+                merged.emplace_back(std::move(incoming[b++]));
+            }
+        }
+        keys_ = std::move(merged);
+    }
+};
+
+}  // namespace day1
@@ -0,0 +1,446 @@
+// day1/examples/fused_pipeline.hpp
+// Fused filter -> transform -> reduce pipelines over contiguous data
+//
+// `v | views::filter(p) | views::transform(f)` pulls one element at a time
+// through nested iterators with a data-dependent branch per element, which
+// compilers almost never vectorize. A fused pipeline instead pushes blocks of
+// kBlock elements through every stage:
+//
+//   transform: one tight loop per block into a stack buffer
+//   filter:    one loop computing an all-ones/all-zeros mask per element
+//              (consecutive filters AND into the same mask), then a
+//              branch-free compaction of the survivors (AVX-512 compress or
+//              an AVX2 permute table for 4-byte values, picked at run
+//              time from cpu_dispatch.hpp)
+//   terminal:  reduce / count / for_each / to_vector on the surviving block
+//
+//     auto squares = day1::fused::from(numbers)
+//                  | day1::fused::filter([](int n) { return n % 2 == 0; })
+//                  | day1::fused::transform([](int n) { return long(n) * n; });
+//     long total = squares.reduce(day1::execution::par, 0L);
+//
+// A pipeline only points at its source; the source must outlive it. With
+// the `par` policy blocks are spread over the work-stealing pool, and
+// reduce/to_vector still combine results in source order.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cpu_dispatch.hpp"
+#include "parallel_algorithms.hpp"
+
+#if DAY1_CPU_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace day1::fused {
+
+template <typename F>
+struct filter_stage {
+    F pred;
+};
+
+template <typename F>
+struct transform_stage {
+    F fn;
+};
+
+template <typename F>
+filter_stage<std::decay_t<F>> filter(F &&pred) {
+    return {std::forward<F>(pred)};
+}
+
+template <typename F>
+transform_stage<std::decay_t<F>> transform(F &&fn) {
+    return {std::forward<F>(fn)};
+}
+
+namespace fused_detail {
+
+inline constexpr std::size_t kBlock = 1024;
+
+template <typename S>
+inline constexpr bool is_filter_v = false;
+template <typename F>
+inline constexpr bool is_filter_v<filter_stage<F>> = true;
+
+// Element type after running V through the given stages
+template <typename V, typename... Stages>
+struct output {
+    using type = V;
+};
+template <typename V, typename F, typename... Rest>
+struct output<V, filter_stage<F>, Rest...> : output<V, Rest...> {};
+template <typename V, typename F, typename... Rest>
+struct output<V, transform_stage<F>, Rest...>
+    : output<std::remove_cvref_t<std::invoke_result_t<const F &, const V &>>, Rest...> {};
+
+// Mask lanes match the value width so the SIMD paths can test them directly
+template <typename V>
+inline constexpr bool kSimdWidth =
+    std::is_trivially_copyable_v<V> && (sizeof(V) == 4 || sizeof(V) == 8);
+
+template <typename V>
+using mask_t = std::conditional_t<
+    kSimdWidth<V>, std::conditional_t<sizeof(V) == 4, std::uint32_t, std::uint64_t>,
+    std::uint8_t>;
+
+// Copy in[i] for every set mask[i] in [i, n) to out + kept; returns the
+// new kept count
+template <typename V, typename M>
+std::size_t compact_tail(const V *in, const M *mask, std::size_t i, std::size_t n, V *out,
+                         std::size_t kept) {
+    for (; i < n; ++i) {
+        out[kept] = in[i];
+        kept += mask[i] & 1;
+    }
+    return kept;
+}
+
+#if DAY1_CPU_X86_DISPATCH
+// For each 8-bit keep mask, the source lane of every output lane packed as
+// 4-bit nibbles (lane 0 in the low nibble)
+inline constexpr auto kCompactLanes = [] {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t keep = 0; keep < 256; ++keep) {
+        std::uint32_t packed = 0;
+        int out = 0;
+        for (std::uint32_t lane = 0; lane < 8; ++lane) {
+            if (keep & (1u << lane)) {
+                packed |= lane << (4 * out++);
+            }
+        }
+        table[keep] = packed;
+    }
+    return table;
+}();
+
+DAY1_TARGET_V3 inline __m256i compact_permutation(unsigned keep) {
+    const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    __m256i packed = _mm256_set1_epi32(static_cast<int>(kCompactLanes[keep]));
+    return _mm256_and_si256(_mm256_srlv_epi32(packed, shifts), _mm256_set1_epi32(7));
+}
+
+// AVX2 has no compress, so 4-byte lanes go through the permute table and
+// 8-byte lanes stay scalar
+template <typename V, typename M>
+DAY1_TARGET_V3 std::size_t compact_v3(const V *in, const M *mask, std::size_t n, V *out) {
+    std::size_t i = 0;
+    std::size_t kept = 0;
+    if constexpr (sizeof(V) == 4) {
+        for (; i + 8 <= n; i += 8) {
+            __m256 m = _mm256_castsi256_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + i)));
+            auto keep = static_cast<unsigned>(_mm256_movemask_ps(m));
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + kept),
+                                _mm256_permutevar8x32_epi32(values, compact_permutation(keep)));
+            kept += static_cast<std::size_t>(std::popcount(keep));
+        }
+    }
+    return compact_tail(in, mask, i, n, out, kept);
+}
+
+template <typename V, typename M>
+DAY1_TARGET_V4 std::size_t compact_v4(const V *in, const M *mask, std::size_t n, V *out) {
+    std::size_t i = 0;
+    std::size_t kept = 0;
+    if constexpr (sizeof(V) == 4) {
+        for (; i + 16 <= n; i += 16) {
+            __m512i m = _mm512_loadu_si512(mask + i);
+            __mmask16 keep = _mm512_test_epi32_mask(m, m);
+            __m512i packed = _mm512_maskz_compress_epi32(keep, _mm512_loadu_si512(in + i));
+            _mm512_storeu_si512(out + kept, packed);
+            kept += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(keep)));
+        }
+    } else {
+        for (; i + 8 <= n; i += 8) {
+            __m512i m = _mm512_loadu_si512(mask + i);
+            __mmask8 keep = _mm512_test_epi64_mask(m, m);
+            __m512i packed = _mm512_maskz_compress_epi64(keep, _mm512_loadu_si512(in + i));
+            _mm512_storeu_si512(out + kept, packed);
+            kept += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(keep)));
+        }
+    }
+    return compact_tail(in, mask, i, n, out, kept);
+}
+#endif
+
+// Copy in[i] for every set mask[i] to the front of out; returns how many.
+// out must hold n elements: the vector paths store full registers at the
+// write cursor, which never runs ahead of the read cursor. The vector path
+// is picked per block from cpu::active_level(), so a portable build still
+// compresses with AVX-512 where the CPU has it.
+template <typename V, typename M>
+std::size_t compact(const V *in, const M *mask, std::size_t n, V *out) {
+#if DAY1_CPU_X86_DISPATCH
+    if constexpr (kSimdWidth<V>) {
+        switch (cpu::active_level()) {
+            case cpu::Level::v4:
+                return compact_v4(in, mask, n, out);
+            case cpu::Level::v3:
+                return compact_v3(in, mask, n, out);
+            default:
+                break;
+        }
+    }
+#endif
+    return compact_tail(in, mask, 0, n, out, 0);
+}
+
+}  // namespace fused_detail
+
+template <typename T, typename... Stages>
+class pipeline {
+   private:
+    template <typename, typename...>
+    friend class pipeline;
+
+    using stage_tuple = std::tuple<Stages...>;
+    static constexpr std::size_t kStages = sizeof...(Stages);
+
+    const T *data_;
+    std::size_t size_;
+    stage_tuple stages_;
+
+   public:
+    using source_type = T;
+    using value_type = typename fused_detail::output<T, Stages...>::type;
+
+    pipeline(const T *data, std::size_t size, stage_tuple stages = {})
+        : data_(data), size_(size), stages_(std::move(stages)) {}
+
+    template <typename F>
+    friend pipeline<T, Stages..., filter_stage<F>> operator|(pipeline p, filter_stage<F> stage) {
+        return {p.data_, p.size_,
+                std::tuple_cat(std::move(p.stages_), std::tuple(std::move(stage)))};
+    }
+
+    template <typename F>
+    friend pipeline<T, Stages..., transform_stage<F>> operator|(pipeline p,
+                                                                transform_stage<F> stage) {
+        return {p.data_, p.size_,
+                std::tuple_cat(std::move(p.stages_), std::tuple(std::move(stage)))};
+    }
+
+    std::size_t source_size() const {
+        return size_;
+    }
+
+    // --- terminals -------------------------------------------------------------
+
+    template <typename U, typename Op = std::plus<>>
+    U reduce(execution::sequenced_policy, U init, Op op = Op()) const {
+        run(0, size_, [&](const value_type *block, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                init = op(std::move(init), block[i]);
+            }
+        });
+        return init;
+    }
+
+    // op must be associative; chunk results are combined in source order
+    template <typename U, typename Op = std::plus<>>
+    U reduce(const execution::parallel_policy &policy, U init, Op op = Op()) const {
+        std::vector<std::optional<U>> partial(chunks(policy));
+        for_each_chunk(policy, partial.size(),
+                       [&](std::size_t c, std::size_t begin, std::size_t end) {
+                           std::optional<U> acc;
+                           run(begin, end, [&](const value_type *block, std::size_t n) {
+                               U sum = static_cast<U>(block[0]);
+                               for (std::size_t i = 1; i < n; ++i) {
+                                   sum = op(std::move(sum), block[i]);
+                               }
+                               acc = acc ? op(std::move(*acc), std::move(sum)) : std::move(sum);
+                           });
+                           partial[c] = std::move(acc);
+                       });
+        for (auto &p : partial) {
+            if (p) {
+                init = op(std::move(init), std::move(*p));
+            }
+        }
+        return init;
+    }
+
+    std::size_t count(execution::sequenced_policy) const {
+        std::size_t total = 0;
+        run(0, size_, [&](const value_type *, std::size_t n) { total += n; });
+        return total;
+    }
+
+    std::size_t count(const execution::parallel_policy &policy) const {
+        return count_parallel(policy);
+    }
+
+    // Visits surviving values in source order (any order under par)
+    template <typename F>
+    void for_each(execution::sequenced_policy, F f) const {
+        run(0, size_, [&](const value_type *block, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                f(block[i]);
+            }
+        });
+    }
+
+    template <typename F>
+    void for_each(const execution::parallel_policy &policy, F f) const {
+        parallel_detail::parallel_for(policy, size_, [&](std::size_t begin, std::size_t end) {
+            run(begin, end, [&](const value_type *block, std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    f(block[i]);
+                }
+            });
+        });
+    }
+
+    std::vector<value_type> to_vector(execution::sequenced_policy) const {
+        std::vector<value_type> out;
+        run(0, size_, [&](const value_type *block, std::size_t n) {
+            out.insert(out.end(), block, block + n);
+        });
+        return out;
+    }
+
+    // Chunks collect locally, then copy into place at their prefix offsets
+    std::vector<value_type> to_vector(const execution::parallel_policy &policy) const {
+        std::vector<std::vector<value_type>> parts(chunks(policy));
+        for_each_chunk(policy, parts.size(),
+                       [&](std::size_t c, std::size_t begin, std::size_t end) {
+                           run(begin, end, [&](const value_type *block, std::size_t n) {
+                               parts[c].insert(parts[c].end(), block, block + n);
+                           });
+                       });
+        std::vector<std::size_t> offsets(parts.size() + 1, 0);
+        for (std::size_t c = 0; c < parts.size(); ++c) {
+            offsets[c + 1] = offsets[c] + parts[c].size();
+        }
+        std::vector<value_type> out(offsets.back());
+        for_each_chunk(policy, parts.size(), [&](std::size_t c, std::size_t, std::size_t) {
+            std::copy(parts[c].begin(), parts[c].end(),
+                      out.begin() + static_cast<std::ptrdiff_t>(offsets[c]));
+        });
+        return out;
+    }
+
+   private:
+    std::size_t count_parallel(const execution::parallel_policy &policy) const {
+        std::vector<std::size_t> partial(chunks(policy), 0);
+        for_each_chunk(policy, partial.size(),
+                       [&](std::size_t c, std::size_t begin, std::size_t end) {
+                           run(begin, end,
+                               [&](const value_type *, std::size_t n) { partial[c] += n; });
+                       });
+        return std::reduce(partial.begin(), partial.end(), std::size_t{0});
+    }
+
+    // Chunks are whole multiples of kBlock so block boundaries do not depend
+    // on the policy
+    std::size_t chunks(const execution::parallel_policy &policy) const {
+        return parallel_detail::chunk_count(policy, size_);
+    }
+
+    std::size_t per_chunk(std::size_t chunks) const {
+        std::size_t per = (size_ + chunks - 1) / chunks;
+        return (per + fused_detail::kBlock - 1) / fused_detail::kBlock * fused_detail::kBlock;
+    }
+
+    template <typename Body>
+    void for_each_chunk(const execution::parallel_policy &policy, std::size_t chunks,
+                        const Body &body) const {
+        const std::size_t per = per_chunk(chunks);
+        TaskGroup group(policy.resolve_pool());
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const std::size_t begin = std::min(size_, c * per);
+            const std::size_t end = std::min(size_, begin + per);
+            group.run([&body, c, begin, end] { body(c, begin, end); });
+        }
+        group.wait();
+    }
+
+    // Feed source [begin, end) through all stages one block at a time
+    template <typename Sink>
+    void run(std::size_t begin, std::size_t end, const Sink &sink) const {
+        for (std::size_t b = begin; b < end; b += fused_detail::kBlock) {
+            run_block<0>(data_ + b, std::min(fused_detail::kBlock, end - b), sink);
+        }
+    }
+
+    template <std::size_t I>
+    static constexpr bool stage_is_filter() {
+        if constexpr (I < kStages) {
+            return fused_detail::is_filter_v<std::tuple_element_t<I, stage_tuple>>;
+        } else {
+            return false;
+        }
+    }
+
+    // AND the masks of the consecutive filters starting at I
+    template <std::size_t I, typename V, typename M>
+    void and_masks(const V *in, std::size_t n, M *mask) const {
+        if constexpr (stage_is_filter<I>()) {
+            const auto &pred = std::get<I>(stages_).pred;
+            for (std::size_t i = 0; i < n; ++i) {
+                mask[i] &= static_cast<M>(M{0} - static_cast<M>(static_cast<bool>(pred(in[i]))));
+            }
+            and_masks<I + 1>(in, n, mask);
+        }
+    }
+
+    template <std::size_t I>
+    static constexpr std::size_t after_filters() {
+        if constexpr (stage_is_filter<I>()) {
+            return after_filters<I + 1>();
+        } else {
+            return I;
+        }
+    }
+
+    template <std::size_t I, typename V, typename Sink>
+    void run_block(const V *in, std::size_t n, const Sink &sink) const {
+        if constexpr (I == kStages) {
+            if (n != 0) {
+                sink(in, n);
+            }
+        } else if constexpr (stage_is_filter<I>()) {
+            using M = fused_detail::mask_t<V>;
+            alignas(64) M mask[fused_detail::kBlock];
+            std::fill_n(mask, n, static_cast<M>(~M{0}));
+            and_masks<I>(in, n, mask);
+            alignas(64) V kept[fused_detail::kBlock];
+            std::size_t survivors = fused_detail::compact(in, mask, n, kept);
+            run_block<after_filters<I>()>(kept, survivors, sink);
+        } else {
+            using U = std::remove_cvref_t<
+                std::invoke_result_t<const decltype(std::get<I>(stages_).fn) &, const V &>>;
+            const auto &fn = std::get<I>(stages_).fn;
+            alignas(64) U out[fused_detail::kBlock];
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = fn(in[i]);
+            }
+            run_block<I + 1>(out, n, sink);
+        }
+    }
+};
+
+// Start a pipeline over a contiguous range (vector, array, span, ...)
+template <std::ranges::contiguous_range R>
+    requires std::ranges::sized_range<R>
+pipeline<std::ranges::range_value_t<R>> from(const R &range) {
+    return {std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range))};
+}
+
+}  // namespace day1::fused
@@ -0,0 +1,346 @@
+// day1/examples/parallel_algorithms.hpp
+// Parallel STL-style algorithms on day1::WorkStealingPool
+//
+// libstdc++ only parallelizes std::execution::par when TBB is linked, and
+// silently runs serially otherwise. These overloads take a day1 execution
+// policy and always run on the in-project pool:
+//
+//     day1::reduce(day1::execution::par, v.begin(), v.end(), 0.0);
+//     day1::sort(day1::execution::par.with_grain(1 << 16), v.begin(), v.end());
+//
+// Parallel overloads require random-access iterators; the `seq` policy
+// forwards to the standard serial algorithm.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "work_stealing_pool.hpp"
+
+namespace day1 {
+
+namespace execution {
+
+struct sequenced_policy {};
+
+struct parallel_policy {
+    WorkStealingPool *pool = nullptr;  // nullptr: WorkStealingPool::global()
+    std::size_t grain = 0;             // elements per leaf task; 0 = automatic
+
+    parallel_policy on(WorkStealingPool &p) const {
+        return {&p, grain};
+    }
+    parallel_policy with_grain(std::size_t g) const {
+        return {pool, g};
+    }
+    WorkStealingPool &resolve_pool() const {
+        return pool ? *pool : WorkStealingPool::global();
+    }
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+}  // namespace execution
+
+namespace parallel_detail {
+
+inline constexpr std::size_t kMinGrain = 4096;
+
+// Enough leaves for stealing to balance uneven work (~8 per thread), but
+// never so small that task overhead dominates
+inline std::size_t grain_for(const execution::parallel_policy &policy, std::size_t n) {
+    if (policy.grain != 0) {
+        return policy.grain;
+    }
+    const std::size_t threads = policy.resolve_pool().size();
+    return std::max(kMinGrain, n / (threads * 8) + 1);
+}
+
+// Recursive binary splitting: keep the left half, spawn the right half
+template <typename Body>
+void split_range(TaskGroup &group, std::size_t begin, std::size_t end, std::size_t grain,
+                 const Body &body) {
+    while (end - begin > grain) {
+        std::size_t mid = begin + (end - begin) / 2;
+        group.run([&group, mid, end, grain, &body] { split_range(group, mid, end, grain, body); });
+        end = mid;
+    }
+    body(begin, end);
+}
+
+// Run body(begin, end) over [0, n) in parallel leaves and wait
+template <typename Body>
+void parallel_for(const execution::parallel_policy &policy, std::size_t n, const Body &body) {
+    const std::size_t grain = grain_for(policy, n);
+    if (n <= grain) {
+        body(0, n);
+        return;
+    }
+    TaskGroup group(policy.resolve_pool());
+    split_range(group, 0, n, grain, body);
+    group.wait();
+}
+
+// Fixed chunking for algorithms that need per-chunk results in order
+inline std::size_t chunk_count(const execution::parallel_policy &policy, std::size_t n) {
+    const std::size_t grain = grain_for(policy, n);
+    return std::max<std::size_t>(1, (n + grain - 1) / grain);
+}
+
+// Merge two sorted ranges into out, splitting the larger input at its
+// midpoint and the other at the matching lower bound
+template <typename It, typename Out, typename Compare>
+void parallel_merge(TaskGroup &group, It a_first, It a_last, It b_first, It b_last, Out out,
+                    Compare comp, std::size_t grain) {
+    while (true) {
+        auto a_len = static_cast<std::size_t>(a_last - a_first);
+        auto b_len = static_cast<std::size_t>(b_last - b_first);
+        if (a_len + b_len <= grain) {
+            std::merge(std::make_move_iterator(a_first), std::make_move_iterator(a_last),
+                       std::make_move_iterator(b_first), std::make_move_iterator(b_last), out,
+                       comp);
+            return;
+        }
+        if (a_len < b_len) {
+            std::swap(a_first, b_first);
+            std::swap(a_last, b_last);
+            std::swap(a_len, b_len);
+        }
+        It a_mid = a_first + static_cast<std::ptrdiff_t>(a_len / 2);
+        It b_mid = std::lower_bound(b_first, b_last, *a_mid, comp);
+        Out out_mid = out + (a_mid - a_first) + (b_mid - b_first);
+        group.run([&group, a_mid, a_last, b_mid, b_last, out_mid, comp, grain] {
+            parallel_merge(group, a_mid, a_last, b_mid, b_last, out_mid, comp, grain);
+        });
+        a_last = a_mid;
+        b_last = b_mid;
+    }
+}
+
+}  // namespace parallel_detail
+
+// --- for_each ----------------------------------------------------------------
+
+template <typename It, typename F>
+void for_each(execution::sequenced_policy, It first, It last, F f) {
+    std::for_each(first, last, f);
+}
+
+template <std::random_access_iterator It, typename F>
+void for_each(const execution::parallel_policy &policy, It first, It last, F f) {
+    parallel_detail::parallel_for(policy, static_cast<std::size_t>(last - first),
+                                  [first, &f](std::size_t begin, std::size_t end) {
+                                      std::for_each(first + begin, first + end, f);
+                                  });
+}
+
+// --- transform ---------------------------------------------------------------
+
+template <typename It, typename Out, typename F>
+Out transform(execution::sequenced_policy, It first, It last, Out out, F f) {
+    return std::transform(first, last, out, f);
+}
+
+template <std::random_access_iterator It, std::random_access_iterator Out, typename F>
+Out transform(const execution::parallel_policy &policy, It first, It last, Out out, F f) {
+    const auto n = static_cast<std::size_t>(last - first);
+    parallel_detail::parallel_for(policy, n, [first, out, &f](std::size_t begin, std::size_t end) {
+        std::transform(first + begin, first + end, out + begin, f);
+    });
+    return out + static_cast<std::ptrdiff_t>(n);
+}
+
+// --- reduce ------------------------------------------------------------------
+
+template <typename It, typename T, typename Op = std::plus<>>
+T reduce(execution::sequenced_policy, It first, It last, T init, Op op = Op()) {
+    return std::reduce(first, last, std::move(init), op);
+}
+
+// op must be associative; partial sums are combined in chunk order, so the
+// result is deterministic for a given grain
+template <std::random_access_iterator It, typename T, typename Op = std::plus<>>
+T reduce(const execution::parallel_policy &policy, It first, It last, T init, Op op = Op()) {
+    const auto n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = parallel_detail::chunk_count(policy, n);
+    if (chunks == 1) {
+        return std::reduce(first, last, std::move(init), op);
+    }
+    const std::size_t per_chunk = (n + chunks - 1) / chunks;
+    std::vector<T> partial(chunks);
+    std::vector<bool> used(chunks, false);
+    {
+        TaskGroup group(policy.resolve_pool());
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const std::size_t begin = c * per_chunk;
+            const std::size_t end = std::min(n, begin + per_chunk);
+            if (begin >= end) {
+                continue;
+            }
+            used[c] = true;
+            group.run([&partial, &op, first, begin, end, c] {
+                auto it = first + static_cast<std::ptrdiff_t>(begin);
+                T acc = *it;
+                for (++it; it != first + static_cast<std::ptrdiff_t>(end); ++it) {
+                    acc = op(std::move(acc), *it);
+                }
+                partial[c] = std::move(acc);
+            });
+        }
+        group.wait();
+    }
+    T result = std::move(init);
+    for (std::size_t c = 0; c < chunks; ++c) {
+        if (used[c]) {
+            result = op(std::move(result), std::move(partial[c]));
+        }
+    }
+    return result;
+}
+
+// --- sort ----------------------------------------------------------------------
+
+template <typename It, typename Compare = std::less<>>
+void sort(execution::sequenced_policy, It first, It last, Compare comp = Compare()) {
+    std::sort(first, last, comp);
+}
+
+// Parallel merge sort: sort leaves with std::sort, then merge pairs of runs
+// (each merge itself split in parallel), ping-ponging through one buffer
+template <std::random_access_iterator It, typename Compare = std::less<>>
+void sort(const execution::parallel_policy &policy, It first, It last, Compare comp = Compare()) {
+    using T = typename std::iterator_traits<It>::value_type;
+    const auto n = static_cast<std::size_t>(last - first);
+    const std::size_t grain = parallel_detail::grain_for(policy, n);
+    if (n <= grain) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::size_t runs = (n + grain - 1) / grain;
+    const std::size_t run_len = (n + runs - 1) / runs;
+    runs = (n + run_len - 1) / run_len;
+
+    WorkStealingPool &pool = policy.resolve_pool();
+    {
+        TaskGroup group(pool);
+        for (std::size_t r = 0; r < runs; ++r) {
+            group.run([=] {
+                const std::size_t begin = r * run_len;
+                const std::size_t end = std::min(n, begin + run_len);
+                std::sort(first + static_cast<std::ptrdiff_t>(begin),
+                          first + static_cast<std::ptrdiff_t>(end), comp);
+            });
+        }
+        group.wait();
+    }
+
+    std::vector<T> buffer(n);
+    bool in_buffer = false;  // where the current runs live
+    for (std::size_t width = run_len; width < n; width *= 2) {
+        TaskGroup group(pool);
+        auto merge_pass = [&](auto src, auto dst) {
+            for (std::size_t begin = 0; begin < n; begin += 2 * width) {
+                const std::size_t mid = std::min(n, begin + width);
+                const std::size_t end = std::min(n, begin + 2 * width);
+                auto s = src + static_cast<std::ptrdiff_t>(begin);
+                auto m = src + static_cast<std::ptrdiff_t>(mid);
+                auto e = src + static_cast<std::ptrdiff_t>(end);
+                auto d = dst + static_cast<std::ptrdiff_t>(begin);
+                group.run([&group, s, m, e, d, comp, grain] {
+                    parallel_detail::parallel_merge(group, s, m, m, e, d, comp, grain);
+                });
+            }
+        };
+        if (in_buffer) {
+            merge_pass(buffer.begin(), first);
+        } else {
+            merge_pass(first, buffer.begin());
+        }
+        group.wait();
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer) {
+        parallel_detail::parallel_for(policy, n, [&](std::size_t begin, std::size_t end) {
+            std::move(buffer.begin() + static_cast<std::ptrdiff_t>(begin),
+                      buffer.begin() + static_cast<std::ptrdiff_t>(end),
+                      first + static_cast<std::ptrdiff_t>(begin));
+        });
+    }
+}
+
+// --- inclusive_scan ------------------------------------------------------------
+
+template <typename It, typename Out, typename Op = std::plus<>>
+Out inclusive_scan(execution::sequenced_policy, It first, It last, Out out, Op op = Op()) {
+    return std::inclusive_scan(first, last, out, op);
+}
+
+// Three phases: reduce each chunk, scan the chunk totals serially, then
+// rescan each chunk seeded with the total of everything before it
+template <std::random_access_iterator It, std::random_access_iterator Out,
+          typename Op = std::plus<>>
+Out inclusive_scan(const execution::parallel_policy &policy, It first, It last, Out out,
+                   Op op = Op()) {
+    using T = typename std::iterator_traits<It>::value_type;
+    const auto n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = parallel_detail::chunk_count(policy, n);
+    if (chunks == 1) {
+        return std::inclusive_scan(first, last, out, op);
+    }
+    const std::size_t per_chunk = (n + chunks - 1) / chunks;
+    auto bounds = [&](std::size_t c) {
+        const std::size_t begin = std::min(n, c * per_chunk);
+        return std::pair{begin, std::min(n, begin + per_chunk)};
+    };
+
+    std::vector<T> totals(chunks);
+    {
+        TaskGroup group(policy.resolve_pool());
+        for (std::size_t c = 0; c + 1 < chunks; ++c) {  // the last total is never needed
+            group.run([&, c] {
+                auto [begin, end] = bounds(c);
+                auto it = first + static_cast<std::ptrdiff_t>(begin);
+                T acc = *it;
+                for (++it; it != first + static_cast<std::ptrdiff_t>(end); ++it) {
+                    acc = op(std::move(acc), *it);
+                }
+                totals[c] = std::move(acc);
+            });
+        }
+        group.wait();
+    }
+    for (std::size_t c = 1; c + 1 < chunks; ++c) {
+        totals[c] = op(totals[c - 1], totals[c]);
+    }
+    {
+        TaskGroup group(policy.resolve_pool());
+        for (std::size_t c = 0; c < chunks; ++c) {
+            group.run([&, c] {
+                auto [begin, end] = bounds(c);
+                if (begin >= end) {
+                    return;
+                }
+                auto src = first + static_cast<std::ptrdiff_t>(begin);
+                auto dst = out + static_cast<std::ptrdiff_t>(begin);
+                if (c == 0) {
+                    std::inclusive_scan(src, first + static_cast<std::ptrdiff_t>(end), dst, op);
+                } else {
+                    std::inclusive_scan(src, first + static_cast<std::ptrdiff_t>(end), dst, op,
+                                        totals[c - 1]);
+                }
+            });
+        }
+        group.wait();
+    }
+    return out + static_cast<std::ptrdiff_t>(n);
+}
+
+}  // namespace day1
@@ -0,0 +1,480 @@
+// day1/examples/pool_allocator.hpp
+// Fixed-size-block pool allocator with per-thread caches
+//
+// Small requests (<= 512 bytes) are rounded up to one of 16 size classes.
+// Each size class owns a central pool of 64KB chunks carved into equal
+// blocks. Threads allocate from a private cache and only touch the central
+// pool (under a mutex) to refill or flush a whole batch of blocks. A chunk
+// whose blocks have all come back is released to the system, keeping at
+// most one empty chunk per size class as hysteresis.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "common/cache_line.hpp"
+
+namespace day1 {
+
+namespace pool_detail {
+
+inline constexpr std::size_t kChunkSize = 64 * 1024;
+inline constexpr std::size_t kMaxBlockSize = 512;
+inline constexpr std::size_t kBlockAlign = alignof(std::max_align_t);
+inline constexpr std::size_t kNumSizeClasses = 16;
+inline constexpr std::size_t kRetainedEmptyChunks = 1;
+
+inline constexpr std::array<std::size_t, kNumSizeClasses> kClassSizes{
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512};
+
+// Map a request size (1..kMaxBlockSize) to its size class index
+constexpr std::size_t size_class_of(std::size_t bytes) {
+    if (bytes <= 128) {
+        return bytes == 0 ? 0 : (bytes - 1) / 16;
+    }
+    if (bytes <= 256) {
+        return 8 + (bytes - 129) / 32;
+    }
+    return 12 + (bytes - 257) / 64;
+}
+
+// Blocks per refill/flush: big enough to amortize the lock, small enough
+// not to strand much memory in an idle thread's cache
+constexpr std::size_t batch_size_of(std::size_t size_class) {
+    std::size_t batch = 8192 / kClassSizes[size_class];
+    return batch < 16 ? 16 : (batch > 128 ? 128 : batch);
+}
+
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+struct ChunkHeader {
+    ChunkHeader *prev = nullptr;  // links in the pool's partial list
+    ChunkHeader *next = nullptr;
+    FreeBlock *free_list = nullptr;
+    std::size_t carved = 0;  // blocks handed out at least once (lazy carving)
+    std::size_t used = 0;    // blocks currently outside the chunk
+    std::size_t capacity = 0;
+    bool in_partial_list = false;
+};
+
+inline constexpr std::size_t kHeaderSize = (sizeof(ChunkHeader) + 63) & ~std::size_t{63};
+
+inline ChunkHeader *chunk_of(const void *block) {
+    auto address = reinterpret_cast<std::uintptr_t>(block);
+    return reinterpret_cast<ChunkHeader *>(address & ~(kChunkSize - 1));
+}
+
+}  // namespace pool_detail
+
+// Snapshot of one size class
+struct PoolStats {
+    std::size_t block_size = 0;
+    std::size_t chunks_live = 0;
+    std::size_t chunks_empty = 0;
+    std::size_t chunks_allocated = 0;  // lifetime total
+    std::size_t chunks_released = 0;   // lifetime total
+    std::size_t blocks_outstanding = 0;  // held by thread caches or callers
+    std::size_t refills = 0;
+    std::size_t flushes = 0;
+
+    std::size_t bytes_reserved() const {
+        return chunks_live * pool_detail::kChunkSize;
+    }
+};
+
+struct PoolAllocatorStats {
+    std::array<PoolStats, pool_detail::kNumSizeClasses> classes{};
+    std::size_t large_allocations = 0;  // requests served by ::operator new
+
+    std::size_t bytes_reserved() const {
+        std::size_t total = 0;
+        for (const auto &c : classes) {
+            total += c.bytes_reserved();
+        }
+        return total;
+    }
+
+    std::size_t chunks_live() const {
+        std::size_t total = 0;
+        for (const auto &c : classes) {
+            total += c.chunks_live;
+        }
+        return total;
+    }
+
+    std::size_t chunks_released() const {
+        std::size_t total = 0;
+        for (const auto &c : classes) {
+            total += c.chunks_released;
+        }
+        return total;
+    }
+};
+
+namespace pool_detail {
+
+// Shared pool for one size class; every member is guarded by mutex_
+class alignas(common::kCacheLine) CentralPool {
+   private:
+    mutable std::mutex mutex_;
+    ChunkHeader *partial_head_ = nullptr;
+    ChunkHeader *partial_tail_ = nullptr;
+    std::size_t block_size_ = 0;
+    PoolStats stats_{};
+
+   public:
+    void init(std::size_t block_size) {
+        block_size_ = block_size;
+        stats_.block_size = block_size;
+    }
+
+    // Hand out up to `want` blocks as a linked list; returns how many
+    std::size_t refill(FreeBlock *&head, std::size_t want) {
+        std::lock_guard lock(mutex_);
+        std::size_t got = 0;
+        FreeBlock *list = nullptr;
+
+        while (got < want) {
+            ChunkHeader *chunk = partial_head_ ? partial_head_ : new_chunk();
+            if (chunk == nullptr) {
+                if (got == 0) {
+                    throw std::bad_alloc();
+                }
+                break;
+            }
+            if (chunk->used == 0) {
+                --stats_.chunks_empty;
+            }
+            while (got < want && chunk->used < chunk->capacity) {
+                FreeBlock *block;
+                if (chunk->free_list != nullptr) {
+                    block = chunk->free_list;
+                    chunk->free_list = block->next;
+                } else {
+                    block = block_at(chunk, chunk->carved++);
+                }
+                block->next = list;
+                list = block;
+                ++chunk->used;
+                ++got;
+            }
+            if (chunk->used == chunk->capacity) {
+                unlink(chunk);
+            }
+        }
+
+        stats_.blocks_outstanding += got;
+        ++stats_.refills;
+        head = list;
+        return got;
+    }
+
+    // Return a linked list of `count` blocks; idle chunks are released
+    void release(FreeBlock *list, std::size_t count) {
+        std::lock_guard lock(mutex_);
+        while (list != nullptr) {
+            FreeBlock *block = list;
+            list = list->next;
+
+            ChunkHeader *chunk = chunk_of(block);
+            block->next = chunk->free_list;
+            chunk->free_list = block;
+            if (!chunk->in_partial_list) {
+                link_back(chunk);
+            }
+            if (--chunk->used == 0) {
+                if (stats_.chunks_empty >= kRetainedEmptyChunks) {
+                    unlink(chunk);
+                    free_chunk(chunk);
+                } else {
+                    ++stats_.chunks_empty;
+                }
+            }
+        }
+        stats_.blocks_outstanding -= count;
+        ++stats_.flushes;
+    }
+
+    // Release every empty chunk, including the retained one
+    void trim() {
+        std::lock_guard lock(mutex_);
+        ChunkHeader *chunk = partial_head_;
+        while (chunk != nullptr) {
+            ChunkHeader *next = chunk->next;
+            if (chunk->used == 0) {
+                unlink(chunk);
+                free_chunk(chunk);
+            }
+            chunk = next;
+        }
+        stats_.chunks_empty = 0;
+    }
+
+    PoolStats stats() const {
+        std::lock_guard lock(mutex_);
+        return stats_;
+    }
+
+   private:
+    FreeBlock *block_at(ChunkHeader *chunk, std::size_t index) const {
+        auto *base = reinterpret_cast<std::byte *>(chunk) + kHeaderSize;
+        return reinterpret_cast<FreeBlock *>(base + index * block_size_);
+    }
+
+    ChunkHeader *new_chunk() {
+        void *memory = std::aligned_alloc(kChunkSize, kChunkSize);
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        auto *chunk = new (memory) ChunkHeader{};
+        chunk->capacity = (kChunkSize - kHeaderSize) / block_size_;
+        link_back(chunk);
+        ++stats_.chunks_live;
+        ++stats_.chunks_empty;
+        ++stats_.chunks_allocated;
+        return chunk;
+    }
+
+    void free_chunk(ChunkHeader *chunk) {
+        chunk->~ChunkHeader();
+        std::free(chunk);
+        --stats_.chunks_live;
+        ++stats_.chunks_released;
+    }
+
+    void link_back(ChunkHeader *chunk) {
+        chunk->prev = partial_tail_;
+        chunk->next = nullptr;
+        if (partial_tail_ != nullptr) {
+            partial_tail_->next = chunk;
+        } else {
+            partial_head_ = chunk;
+        }
+        partial_tail_ = chunk;
+        chunk->in_partial_list = true;
+    }
+
+    void unlink(ChunkHeader *chunk) {
+        (chunk->prev ? chunk->prev->next : partial_head_) = chunk->next;
+        (chunk->next ? chunk->next->prev : partial_tail_) = chunk->prev;
+        chunk->prev = chunk->next = nullptr;
+        chunk->in_partial_list = false;
+    }
+};
+
+class SmallObjectPool {
+   private:
+    std::array<CentralPool, kNumSizeClasses> pools_;
+    std::atomic<std::size_t> large_allocations_{0};
+
+    SmallObjectPool() {
+        for (std::size_t i = 0; i < kNumSizeClasses; ++i) {
+            pools_[i].init(kClassSizes[i]);
+        }
+    }
+
+   public:
+    // Intentionally never destroyed: containers with static storage may
+    // still hand blocks back after static destructors have started
+    static SmallObjectPool &instance() {
+        static SmallObjectPool *const pool = new SmallObjectPool();
+        return *pool;
+    }
+
+    CentralPool &central(std::size_t size_class) {
+        return pools_[size_class];
+    }
+
+    void count_large_allocation() {
+        large_allocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void trim() {
+        for (auto &pool : pools_) {
+            pool.trim();
+        }
+    }
+
+    PoolAllocatorStats stats() const {
+        PoolAllocatorStats result;
+        for (std::size_t i = 0; i < kNumSizeClasses; ++i) {
+            result.classes[i] = pools_[i].stats();
+        }
+        result.large_allocations = large_allocations_.load(std::memory_order_relaxed);
+        return result;
+    }
+};
+
+// Per-thread front end; flushes everything back to the central pools when
+// the thread exits
+class ThreadCache {
+   private:
+    struct Bin {
+        FreeBlock *head = nullptr;
+        std::size_t count = 0;
+    };
+
+    std::array<Bin, kNumSizeClasses> bins_{};
+    SmallObjectPool &pool_;
+
+   public:
+    ThreadCache() : pool_(SmallObjectPool::instance()) {}
+    ~ThreadCache();
+
+    ThreadCache(const ThreadCache &) = delete;
+    ThreadCache &operator=(const ThreadCache &) = delete;
+
+    void *allocate(std::size_t size_class) {
+        Bin &bin = bins_[size_class];
+        if (bin.head == nullptr) [[unlikely]] {
+            bin.count = pool_.central(size_class).refill(bin.head, batch_size_of(size_class));
+        }
+        FreeBlock *block = bin.head;
+        bin.head = block->next;
+        --bin.count;
+        return block;
+    }
+
+    void deallocate(void *ptr, std::size_t size_class) {
+        Bin &bin = bins_[size_class];
+        auto *block = static_cast<FreeBlock *>(ptr);
+        block->next = bin.head;
+        bin.head = block;
+        if (++bin.count >= 2 * batch_size_of(size_class)) [[unlikely]] {
+            flush(size_class, batch_size_of(size_class));
+        }
+    }
+
+    // Give up to `count` cached blocks of one class back to the central pool
+    void flush(std::size_t size_class, std::size_t count) {
+        Bin &bin = bins_[size_class];
+        count = count < bin.count ? count : bin.count;
+        if (count == 0) {
+            return;
+        }
+        FreeBlock *first = bin.head;
+        FreeBlock *last = first;
+        for (std::size_t i = 1; i < count; ++i) {
+            last = last->next;
+        }
+        bin.head = last->next;
+        bin.count -= count;
+        last->next = nullptr;
+        pool_.central(size_class).release(first, count);
+    }
+
+    void flush_all() {
+        for (std::size_t i = 0; i < kNumSizeClasses; ++i) {
+            flush(i, bins_[i].count);
+        }
+    }
+};
+
+// Set once this thread's cache has been destroyed, so allocations made by
+// later thread_local destructors bypass it
+inline thread_local bool tls_cache_destroyed = false;
+
+inline ThreadCache::~ThreadCache() {
+    flush_all();
+    tls_cache_destroyed = true;
+}
+
+inline ThreadCache &thread_cache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+inline void *allocate_small(std::size_t bytes) {
+    const std::size_t size_class = size_class_of(bytes);
+    if (tls_cache_destroyed) [[unlikely]] {
+        FreeBlock *block = nullptr;
+        SmallObjectPool::instance().central(size_class).refill(block, 1);
+        return block;
+    }
+    return thread_cache().allocate(size_class);
+}
+
+inline void deallocate_small(void *ptr, std::size_t bytes) {
+    const std::size_t size_class = size_class_of(bytes);
+    if (tls_cache_destroyed) [[unlikely]] {
+        auto *block = static_cast<FreeBlock *>(ptr);
+        block->next = nullptr;
+        SmallObjectPool::instance().central(size_class).release(block, 1);
+        return;
+    }
+    thread_cache().deallocate(ptr, size_class);
+}
+
+}  // namespace pool_detail
+
+// Statistics for every size class plus the large-request fallback count
+inline PoolAllocatorStats pool_stats() {
+    return pool_detail::SmallObjectPool::instance().stats();
+}
+
+// Flush the calling thread's cache and release all idle chunks
+inline void pool_trim() {
+    if (!pool_detail::tls_cache_destroyed) {
+        pool_detail::thread_cache().flush_all();
+    }
+    pool_detail::SmallObjectPool::instance().trim();
+}
+
+// Stateless STL allocator over the shared size-class pools. Requests of any
+// n are pooled while n * sizeof(T) fits a size class (so unordered_map's
+// small bucket arrays are pooled too); larger or over-aligned requests go
+// to aligned ::operator new.
+template <typename T>
+class PoolAllocator {
+   public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const std::size_t bytes = n * sizeof(T);
+        if constexpr (alignof(T) <= pool_detail::kBlockAlign) {
+            if (bytes <= pool_detail::kMaxBlockSize) {
+                return static_cast<T *>(pool_detail::allocate_small(bytes));
+            }
+        }
+        pool_detail::SmallObjectPool::instance().count_large_allocation();
+        return static_cast<T *>(::operator new(bytes, std::align_val_t{alignof(T)}));
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if constexpr (alignof(T) <= pool_detail::kBlockAlign) {
+            if (bytes <= pool_detail::kMaxBlockSize) {
+                pool_detail::deallocate_small(ptr, bytes);
+                return;
+            }
+        }
+        ::operator delete(ptr, bytes, std::align_val_t{alignof(T)});
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) noexcept {
+    return true;
+}
+
+}  // namespace day1
@@ -0,0 +1,322 @@
+// day1/examples/radix_sort.hpp
+// LSD/MSD radix sort for integer and floating-point keys
+//
+// Keys are mapped to unsigned integers whose order matches the key order
+// (flip the sign bit of signed integers; for IEEE floats flip every bit of
+// negatives and only the sign bit of positives), then sorted one byte at a
+// time. Both variants are stable, so records sorted by an extracted key
+// keep their relative order.
+//
+//   seq: LSD over the key bytes that actually vary, ping-ponging through
+//        one scratch buffer.
+//   par: one MSD pass on the highest varying byte with a per-chunk parallel
+//        histogram and scatter, then every bucket is finished by LSD as its
+//        own task on the work-stealing pool.
+//
+// Inputs below kSmallSortThreshold go to comparison sorting instead (the
+// per-pass 256-bucket overhead does not pay off there).
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "parallel_algorithms.hpp"
+
+namespace day1 {
+
+template <typename K>
+concept radix_key = (std::integral<K> && !std::same_as<K, bool>) || std::floating_point<K>;
+
+namespace radix_detail {
+
+inline constexpr int kDigitBits = 8;
+inline constexpr std::size_t kBuckets = std::size_t{1} << kDigitBits;
+inline constexpr std::size_t kSmallSortThreshold = 2048;
+
+template <typename K>
+using bits_t = std::make_unsigned_t<
+    std::conditional_t<std::floating_point<K>,
+                       std::conditional_t<sizeof(K) == 4, std::int32_t, std::int64_t>, K>>;
+
+// Order-preserving map from a key to an unsigned integer
+template <radix_key K>
+constexpr bits_t<K> encode(K key) {
+    using U = bits_t<K>;
+    constexpr U sign = U{1} << (sizeof(U) * 8 - 1);
+    if constexpr (std::floating_point<K>) {
+        static_assert(sizeof(K) == 4 || sizeof(K) == 8, "radix_sort supports float and double");
+        U bits = std::bit_cast<U>(key);
+        return (bits & sign) ? static_cast<U>(~bits) : static_cast<U>(bits | sign);
+    } else if constexpr (std::is_signed_v<K>) {
+        return static_cast<U>(static_cast<U>(key) ^ sign);
+    } else {
+        return key;
+    }
+}
+
+template <typename U>
+std::size_t digit(U bits, int shift) {
+    return static_cast<std::size_t>((bits >> shift) & (kBuckets - 1));
+}
+
+using Histogram = std::array<std::size_t, kBuckets>;
+
+// LSD passes over bits [0, top_bit) of n records; returns whichever of the
+// two arrays holds the sorted result. Digits on which every key agrees are
+// skipped without moving data.
+template <typename T, typename Encode>
+T *lsd_passes(T *data, T *scratch, std::size_t n, int top_bit, const Encode &encode_key) {
+    const int passes = (top_bit + kDigitBits - 1) / kDigitBits;
+    if (passes == 0 || n < 2) {
+        return data;
+    }
+
+    // One read pass fills the histograms of every digit
+    std::vector<Histogram> counts(static_cast<std::size_t>(passes));
+    for (auto &h : counts) {
+        h.fill(0);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        auto bits = encode_key(data[i]);
+        for (int p = 0; p < passes; ++p) {
+            ++counts[static_cast<std::size_t>(p)][digit(bits, p * kDigitBits)];
+        }
+    }
+
+    T *src = data;
+    T *dst = scratch;
+    for (int p = 0; p < passes; ++p) {
+        Histogram &h = counts[static_cast<std::size_t>(p)];
+        if (std::find(h.begin(), h.end(), n) != h.end()) {
+            continue;  // every key has the same value for this digit
+        }
+        std::size_t offset = 0;
+        for (auto &count : h) {
+            std::size_t c = count;
+            count = offset;
+            offset += c;
+        }
+        const int shift = p * kDigitBits;
+        for (std::size_t i = 0; i < n; ++i) {
+            dst[h[digit(encode_key(src[i]), shift)]++] = std::move(src[i]);
+        }
+        std::swap(src, dst);
+    }
+    return src;
+}
+
+// Number of low bits that differ between at least two keys
+template <typename U>
+int varying_bits(U any_or, U all_and) {
+    return static_cast<int>(sizeof(U) * 8) - std::countl_zero(static_cast<U>(any_or ^ all_and));
+}
+
+// Compare encoded keys so the order matches the radix order exactly (e.g.
+// -0.0 before +0.0). Plain keys use introsort: equal encodings mean equal
+// values, so stability is moot. Records need std::stable_sort.
+template <bool Stable, typename T, typename Encode>
+void comparison_sort(T *first, T *last, const Encode &encode_key) {
+    auto less = [&](const T &a, const T &b) { return encode_key(a) < encode_key(b); };
+    if constexpr (Stable) {
+        std::stable_sort(first, last, less);
+    } else {
+        std::sort(first, last, less);
+    }
+}
+
+template <bool Stable, typename T, typename Encode>
+void sort_serial(T *data, std::size_t n, const Encode &encode_key) {
+    if (n < kSmallSortThreshold) {
+        comparison_sort<Stable>(data, data + n, encode_key);
+        return;
+    }
+    using U = decltype(encode_key(*data));
+    U any_or = 0;
+    U all_and = static_cast<U>(~U{0});
+    for (std::size_t i = 0; i < n; ++i) {
+        U bits = encode_key(data[i]);
+        any_or |= bits;
+        all_and &= bits;
+    }
+    std::unique_ptr<T[]> scratch(new T[n]);
+    T *result = lsd_passes(data, scratch.get(), n, varying_bits(any_or, all_and), encode_key);
+    if (result != data) {
+        std::move(result, result + n, data);
+    }
+}
+
+template <bool Stable, typename T, typename Encode>
+void sort_parallel(const execution::parallel_policy &policy, T *data, std::size_t n,
+                   const Encode &encode_key) {
+    using U = decltype(encode_key(*data));
+    const std::size_t grain = std::max(parallel_detail::grain_for(policy, n), kBuckets * 64);
+    if (n <= grain) {
+        sort_serial<Stable>(data, n, encode_key);
+        return;
+    }
+    WorkStealingPool &pool = policy.resolve_pool();
+    const std::size_t chunks = (n + grain - 1) / grain;
+    const std::size_t per_chunk = (n + chunks - 1) / chunks;
+    auto chunk_begin = [&](std::size_t c) { return std::min(n, c * per_chunk); };
+    auto chunk_end = [&](std::size_t c) { return std::min(n, (c + 1) * per_chunk); };
+
+    // Phase 1: which bits vary at all (parallel OR/AND reduction)
+    std::vector<U> ors(chunks, 0);
+    std::vector<U> ands(chunks, static_cast<U>(~U{0}));
+    {
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            group.run([&, c] {
+                U any_or = 0;
+                U all_and = static_cast<U>(~U{0});
+                for (std::size_t i = chunk_begin(c); i < chunk_end(c); ++i) {
+                    U bits = encode_key(data[i]);
+                    any_or |= bits;
+                    all_and &= bits;
+                }
+                ors[c] = any_or;
+                ands[c] = all_and;
+            });
+        }
+        group.wait();
+    }
+    U any_or = 0;
+    U all_and = static_cast<U>(~U{0});
+    for (std::size_t c = 0; c < chunks; ++c) {
+        any_or |= ors[c];
+        all_and &= ands[c];
+    }
+    const int top_bit = varying_bits(any_or, all_and);
+    if (top_bit == 0) {
+        return;  // all keys equal
+    }
+    const int msd_shift = std::max(0, top_bit - kDigitBits);
+
+    // Phase 2: per-chunk histograms of the MSD digit
+    std::vector<Histogram> counts(chunks);
+    {
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            group.run([&, c] {
+                Histogram &h = counts[c];
+                h.fill(0);
+                for (std::size_t i = chunk_begin(c); i < chunk_end(c); ++i) {
+                    ++h[digit(encode_key(data[i]), msd_shift)];
+                }
+            });
+        }
+        group.wait();
+    }
+
+    // Bucket-major prefix sums: chunk c writes bucket b after chunks < c,
+    // which keeps the scatter stable
+    std::vector<std::size_t> bucket_start(kBuckets + 1, 0);
+    {
+        std::size_t offset = 0;
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            bucket_start[b] = offset;
+            for (std::size_t c = 0; c < chunks; ++c) {
+                std::size_t count = counts[c][b];
+                counts[c][b] = offset;
+                offset += count;
+            }
+        }
+        bucket_start[kBuckets] = offset;
+    }
+
+    // Phase 3: parallel scatter into the scratch buffer
+    std::unique_ptr<T[]> scratch(new T[n]);
+    {
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            group.run([&, c] {
+                Histogram &offsets = counts[c];
+                for (std::size_t i = chunk_begin(c); i < chunk_end(c); ++i) {
+                    scratch[offsets[digit(encode_key(data[i]), msd_shift)]++] = std::move(data[i]);
+                }
+            });
+        }
+        group.wait();
+    }
+
+    // Phase 4: finish every bucket independently, landing back in data
+    {
+        TaskGroup group(pool);
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            const std::size_t begin = bucket_start[b];
+            const std::size_t count = bucket_start[b + 1] - begin;
+            if (count == 0) {
+                continue;
+            }
+            group.run([&, begin, count] {
+                T *in = scratch.get() + begin;
+                T *out = data + begin;
+                if (count < kSmallSortThreshold) {
+                    comparison_sort<Stable>(in, in + count, encode_key);
+                    std::move(in, in + count, out);
+                    return;
+                }
+                T *result = lsd_passes(in, out, count, msd_shift, encode_key);
+                if (result != out) {
+                    std::move(result, result + count, out);
+                }
+            });
+        }
+        group.wait();
+    }
+}
+
+}  // namespace radix_detail
+
+// Sort radix-able keys in ascending order
+template <std::contiguous_iterator It>
+    requires radix_key<std::iter_value_t<It>>
+void radix_sort(execution::sequenced_policy, It first, It last) {
+    using K = std::iter_value_t<It>;
+    radix_detail::sort_serial<false>(std::to_address(first),
+                                     static_cast<std::size_t>(last - first),
+                                     [](const K &key) { return radix_detail::encode(key); });
+}
+
+template <std::contiguous_iterator It>
+    requires radix_key<std::iter_value_t<It>>
+void radix_sort(const execution::parallel_policy &policy, It first, It last) {
+    using K = std::iter_value_t<It>;
+    radix_detail::sort_parallel<false>(policy, std::to_address(first),
+                                       static_cast<std::size_t>(last - first),
+                                       [](const K &key) { return radix_detail::encode(key); });
+}
+
+// Stable sort of records (e.g. key-value pairs) by an extracted key:
+//     radix_sort(execution::par, pairs.begin(), pairs.end(),
+//                [](const auto &kv) { return kv.first; });
+template <std::contiguous_iterator It, typename KeyFn>
+    requires radix_key<
+        std::remove_cvref_t<std::invoke_result_t<KeyFn &, std::iter_reference_t<It>>>>
+void radix_sort(execution::sequenced_policy, It first, It last, KeyFn key) {
+    using T = std::iter_value_t<It>;
+    radix_detail::sort_serial<true>(
+        std::to_address(first), static_cast<std::size_t>(last - first),
+        [&key](const T &item) { return radix_detail::encode(key(item)); });
+}
+
+template <std::contiguous_iterator It, typename KeyFn>
+    requires radix_key<
+        std::remove_cvref_t<std::invoke_result_t<KeyFn &, std::iter_reference_t<It>>>>
+void radix_sort(const execution::parallel_policy &policy, It first, It last, KeyFn key) {
+    using T = std::iter_value_t<It>;
+    radix_detail::sort_parallel<true>(
+        policy, std::to_address(first), static_cast<std::size_t>(last - first),
+        [&key](const T &item) { return radix_detail::encode(key(item)); });
+}
+
+}  // namespace day1
@@ -0,0 +1,242 @@
+// day1/examples/simd_reduction_kernels.inl
+// Reduction kernels written once with GCC vector extensions
+//
+// simd_reductions.hpp includes this file inside one struct per instruction
+// set, with kVectorBytes set to that set's register width and
+// DAY1_SIMD_KERNEL to its target attribute, so the same source becomes
+// SSE2, AVX2 and AVX-512 code. Every function here must carry
+// DAY1_SIMD_KERNEL. No includes or namespaces here.
+
+template <typename T>
+struct vec_of {
+    typedef T type __attribute__((vector_size(kVectorBytes)));
+};
+
+template <typename T>
+using vec = typename vec_of<T>::type;
+
+template <typename T>
+static constexpr std::size_t kLanes = kVectorBytes / sizeof(T);
+
+// Same-width signed integers: lane masks and argmin indices
+template <typename T>
+using lane_int = std::conditional_t<sizeof(T) == 8, std::int64_t, std::int32_t>;
+
+template <typename T>
+DAY1_SIMD_KERNEL static vec<T> load(const T *p) {
+    vec<T> v;
+    __builtin_memcpy(&v, p, sizeof v);
+    return v;
+}
+
+template <typename T>
+DAY1_SIMD_KERNEL static vec<T> broadcast(T x) {
+    return vec<T>{} + x;
+}
+
+template <typename V>
+DAY1_SIMD_KERNEL static auto horizontal_sum(V v) {
+    auto s = v[0];
+    for (std::size_t l = 1; l < kLanes<decltype(s)>; ++l) {
+        s += v[l];
+    }
+    return s;
+}
+
+// --- sum -----------------------------------------------------------------------
+
+// Four independent accumulators hide the add latency
+template <typename T>
+DAY1_SIMD_KERNEL static T sum_fast(const T *p, std::size_t n) {
+    constexpr std::size_t L = kLanes<T>;
+    vec<T> a0{}, a1{}, a2{}, a3{};
+    std::size_t i = 0;
+    for (; i + 4 * L <= n; i += 4 * L) {
+        a0 += load(p + i);
+        a1 += load(p + i + L);
+        a2 += load(p + i + 2 * L);
+        a3 += load(p + i + 3 * L);
+    }
+    for (; i + L <= n; i += L) {
+        a0 += load(p + i);
+    }
+    T s = horizontal_sum((a0 + a1) + (a2 + a3));
+    for (; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+template <typename T>
+DAY1_SIMD_KERNEL static T sum_pairwise(const T *p, std::size_t n) {
+    if (n <= kPairwiseLeaf) {
+        return sum_fast(p, n);
+    }
+    // Split on a leaf boundary so every leaf runs full vectors
+    std::size_t half = (n / 2 + kPairwiseLeaf - 1) / kPairwiseLeaf * kPairwiseLeaf;
+    return sum_pairwise(p, half) + sum_pairwise(p + half, n - half);
+}
+
+// Neumaier's variant of Kahan summation, per lane: c collects the low-order
+// bits each add loses, whichever operand is larger
+template <typename V>
+DAY1_SIMD_KERNEL static void neumaier_add(V &s, V &c, V x) {
+    V t = s + x;
+    V abs_s = s < 0 ? -s : s;
+    V abs_x = x < 0 ? -x : x;
+    c += abs_s >= abs_x ? (s - t) + x : (x - t) + s;
+    s = t;
+}
+
+template <typename T>
+DAY1_SIMD_KERNEL static void neumaier_add_scalar(T &s, T &c, T x) {
+    T t = s + x;
+    c += (s < 0 ? -s : s) >= (x < 0 ? -x : x) ? (s - t) + x : (x - t) + s;
+    s = t;
+}
+
+template <typename T>
+DAY1_SIMD_KERNEL static T sum_compensated(const T *p, std::size_t n) {
+    constexpr std::size_t L = kLanes<T>;
+    vec<T> s0{}, c0{}, s1{}, c1{};
+    std::size_t i = 0;
+    for (; i + 2 * L <= n; i += 2 * L) {
+        neumaier_add(s0, c0, load(p + i));
+        neumaier_add(s1, c1, load(p + i + L));
+    }
+    T s = 0;
+    T c = 0;
+    for (std::size_t l = 0; l < L; ++l) {
+        neumaier_add_scalar(s, c, s0[l]);
+        neumaier_add_scalar(s, c, s1[l]);
+        c += c0[l] + c1[l];
+    }
+    for (; i < n; ++i) {
+        neumaier_add_scalar(s, c, p[i]);
+    }
+    return s + c;
+}
+
+// --- dot -----------------------------------------------------------------------
+
+template <typename T>
+DAY1_SIMD_KERNEL static T dot_fast(const T *a, const T *b, std::size_t n) {
+    constexpr std::size_t L = kLanes<T>;
+    vec<T> a0{}, a1{}, a2{}, a3{};
+    std::size_t i = 0;
+    for (; i + 4 * L <= n; i += 4 * L) {
+        a0 += load(a + i) * load(b + i);
+        a1 += load(a + i + L) * load(b + i + L);
+        a2 += load(a + i + 2 * L) * load(b + i + 2 * L);
+        a3 += load(a + i + 3 * L) * load(b + i + 3 * L);
+    }
+    for (; i + L <= n; i += L) {
+        a0 += load(a + i) * load(b + i);
+    }
+    T s = horizontal_sum((a0 + a1) + (a2 + a3));
+    for (; i < n; ++i) {
+        s += a[i] * b[i];
+    }
+    return s;
+}
+
+// --- min / max / argmin --------------------------------------------------------
+
+// Requires n >= 1
+template <typename T>
+DAY1_SIMD_KERNEL static std::pair<T, T> min_max(const T *p, std::size_t n) {
+    constexpr std::size_t L = kLanes<T>;
+    vec<T> lo0 = broadcast(p[0]), hi0 = lo0, lo1 = lo0, hi1 = lo0;
+    std::size_t i = 0;
+    for (; i + 2 * L <= n; i += 2 * L) {
+        vec<T> v0 = load(p + i);
+        vec<T> v1 = load(p + i + L);
+        lo0 = v0 < lo0 ? v0 : lo0;
+        hi0 = v0 > hi0 ? v0 : hi0;
+        lo1 = v1 < lo1 ? v1 : lo1;
+        hi1 = v1 > hi1 ? v1 : hi1;
+    }
+    T lo = p[0];
+    T hi = p[0];
+    for (std::size_t l = 0; l < L; ++l) {
+        lo = std::min({lo, lo0[l], lo1[l]});
+        hi = std::max({hi, hi0[l], hi1[l]});
+    }
+    for (; i < n; ++i) {
+        lo = std::min(lo, p[i]);
+        hi = std::max(hi, p[i]);
+    }
+    return {lo, hi};
+}
+
+// Index of the first minimum; requires 1 <= n <= max of lane_int<T>
+template <typename T>
+DAY1_SIMD_KERNEL static std::size_t argmin(const T *p, std::size_t n) {
+    using I = lane_int<T>;
+    constexpr std::size_t L = kLanes<T>;
+    vec<T> best = broadcast(p[0]);
+    vec<I> best_index{};
+    vec<I> index;
+    for (std::size_t l = 0; l < L; ++l) {
+        index[l] = static_cast<I>(l);
+    }
+    const vec<I> step = vec<I>{} + static_cast<I>(L);
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        vec<T> v = load(p + i);
+        auto better = v < best;
+        best = better ? v : best;
+        best_index = better ? index : best_index;
+        index += step;
+    }
+    // Lanes keep their first minimum; across lanes prefer the lowest index
+    T value = p[0];
+    std::size_t at = 0;
+    for (std::size_t l = 0; l < L; ++l) {
+        auto lane_at = static_cast<std::size_t>(best_index[l]);
+        if (best[l] < value || (best[l] == value && lane_at < at)) {
+            value = best[l];
+            at = lane_at;
+        }
+    }
+    for (; i < n; ++i) {
+        if (p[i] < value) {
+            value = p[i];
+            at = i;
+        }
+    }
+    return at;
+}
+
+// --- histogram -------------------------------------------------------------------
+
+// counts[k] += number of keys equal to k, for buckets <= kSmallBuckets.
+// One compare per bucket per vector; lane counters drain before they can
+// overflow.
+DAY1_SIMD_KERNEL static void histogram_small(const std::uint32_t *keys, std::size_t n,
+                                             std::uint64_t *counts, std::size_t buckets) {
+    using V = vec<std::uint32_t>;
+    constexpr std::size_t L = kLanes<std::uint32_t>;
+    constexpr std::size_t kDrainEvery = std::size_t{1} << 30;
+    std::size_t i = 0;
+    while (i + L <= n) {
+        vec<std::int32_t> lane_counts[kSmallBuckets] = {};
+        const std::size_t stop = std::min(n - (n - i) % L, i + kDrainEvery * L);
+        for (; i < stop; i += L) {
+            V v = load(keys + i);
+            for (std::size_t b = 0; b < buckets; ++b) {
+                lane_counts[b] -= v == static_cast<std::uint32_t>(b);  // true lanes are -1
+            }
+        }
+        for (std::size_t b = 0; b < buckets; ++b) {
+            for (std::size_t l = 0; l < L; ++l) {
+                counts[b] += static_cast<std::uint64_t>(lane_counts[b][l]);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        if (keys[i] < buckets) {
+            ++counts[keys[i]];
+        }
+    }
+}
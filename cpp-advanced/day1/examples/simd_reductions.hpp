@@ -0,0 +1,227 @@
+// day1/examples/simd_reductions.hpp
+// SIMD horizontal reductions: sum, dot, min/max, argmin, histogram
+//
+// std::accumulate is one long dependency chain: every add waits for the
+// previous one, so it runs at one element per add latency no matter how
+// wide the vector units are. These kernels keep several vector
+// accumulators in flight and are compiled for SSE2, AVX2 and AVX-512 from
+// one source (simd_reduction_kernels.inl); the widest set the CPU supports
+// follows cpu::active_level() (cpu_dispatch.hpp) on every call, so
+// DAY1_CPU_LEVEL and cpu::force_level() select these kernels too:
+//
+//     double total = day1::simd::sum(std::span(values));
+//     double exact = day1::simd::sum(std::span(values), day1::simd::SumMode::compensated);
+//
+// Summation order differs from std::accumulate, so floating-point results
+// can differ in the last bits. SumMode trades speed for accuracy:
+//   fast         multi-accumulator, error grows with n
+//   pairwise     tree of fast leaves, error grows with log n
+//   compensated  Neumaier (improved Kahan), error independent of n
+//
+// Results are unspecified when the input contains NaNs.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "cpu_dispatch.hpp"
+
+namespace day1::simd {
+
+enum class SumMode { fast, pairwise, compensated };
+
+enum class Isa { sse2, avx2, avx512 };
+
+inline const char *isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::avx512:
+            return "avx512";
+        case Isa::avx2:
+            return "avx2";
+        default:
+            return "sse2";
+    }
+}
+
+namespace simd_detail {
+
+inline constexpr std::size_t kPairwiseLeaf = 4096;
+inline constexpr std::size_t kSmallBuckets = 8;
+
+// Baseline: 16-byte vectors are SSE2 on x86-64 and the generic lowering
+// elsewhere. Each set marks its kernels with DAY1_SIMD_KERNEL, a
+// per-function target attribute, which GCC and Clang both honour.
+#define DAY1_SIMD_KERNEL
+struct sse2_kernels {
+    static constexpr std::size_t kVectorBytes = 16;
+#include "simd_reduction_kernels.inl"
+};
+#undef DAY1_SIMD_KERNEL
+
+#if DAY1_CPU_X86_DISPATCH
+#define DAY1_SIMD_KERNEL DAY1_TARGET_V3
+struct avx2_kernels {
+    static constexpr std::size_t kVectorBytes = 32;
+#include "simd_reduction_kernels.inl"
+};
+#undef DAY1_SIMD_KERNEL
+
+#define DAY1_SIMD_KERNEL DAY1_TARGET_V4
+struct avx512_kernels {
+    static constexpr std::size_t kVectorBytes = 64;
+#include "simd_reduction_kernels.inl"
+};
+#undef DAY1_SIMD_KERNEL
+#endif
+
+inline Isa isa_for(cpu::Level level) {
+#if DAY1_CPU_X86_DISPATCH
+    if (level >= cpu::Level::v4) {
+        return Isa::avx512;
+    }
+    if (level >= cpu::Level::v3) {
+        return Isa::avx2;
+    }
+#endif
+    return Isa::sse2;
+}
+
+// Call f with the kernel set for the active instruction set
+template <typename F>
+decltype(auto) dispatch(F &&f) {
+#if DAY1_CPU_X86_DISPATCH
+    switch (isa_for(cpu::active_level())) {
+        case Isa::avx512:
+            return f(avx512_kernels{});
+        case Isa::avx2:
+            return f(avx2_kernels{});
+        default:
+            break;
+    }
+#endif
+    return f(sse2_kernels{});
+}
+
+}  // namespace simd_detail
+
+// Instruction set the kernels use at the current cpu::active_level()
+inline Isa active_isa() {
+    return simd_detail::isa_for(cpu::active_level());
+}
+
+template <typename T>
+concept reducible = std::same_as<T, float> || std::same_as<T, double>;
+
+template <typename T>
+concept orderable = reducible<T> || std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t>;
+
+template <reducible T>
+T sum(std::span<const T> values, SumMode mode = SumMode::fast) {
+    return simd_detail::dispatch([&](auto kernels) {
+        using K = decltype(kernels);
+        switch (mode) {
+            case SumMode::pairwise:
+                return K::sum_pairwise(values.data(), values.size());
+            case SumMode::compensated:
+                return K::sum_compensated(values.data(), values.size());
+            default:
+                return K::sum_fast(values.data(), values.size());
+        }
+    });
+}
+
+template <reducible T>
+T dot(std::span<const T> a, std::span<const T> b) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("dot: spans differ in length");
+    }
+    return simd_detail::dispatch(
+        [&](auto kernels) { return decltype(kernels)::dot_fast(a.data(), b.data(), a.size()); });
+}
+
+template <orderable T>
+std::pair<T, T> min_max(std::span<const T> values) {
+    if (values.empty()) {
+        throw std::invalid_argument("min_max: empty range");
+    }
+    return simd_detail::dispatch(
+        [&](auto kernels) { return decltype(kernels)::min_max(values.data(), values.size()); });
+}
+
+// Index of the first smallest element; values.size() if empty
+template <orderable T>
+std::size_t argmin(std::span<const T> values) {
+    if (values.empty()) {
+        return 0;
+    }
+    // 32-bit lane indices cap one kernel call; combine blocks for larger inputs
+    constexpr std::size_t kMaxBlock = sizeof(T) == 8 ? std::numeric_limits<std::size_t>::max()
+                                                     : std::size_t{1} << 30;
+    std::size_t best = 0;
+    for (std::size_t begin = 0; begin < values.size(); begin += kMaxBlock) {
+        const std::size_t len = std::min(kMaxBlock, values.size() - begin);
+        std::size_t at = begin + simd_detail::dispatch([&](auto kernels) {
+                             return decltype(kernels)::argmin(values.data() + begin, len);
+                         });
+        if (values[at] < values[best]) {
+            best = at;
+        }
+    }
+    return best;
+}
+
+// Byte histogram; four interleaved tables keep increments of repeated bytes
+// from serializing on store-to-load forwarding
+inline std::array<std::uint64_t, 256> histogram(std::span<const std::uint8_t> bytes) {
+    std::array<std::uint64_t, 256> counts{};
+    std::array<std::array<std::uint32_t, 256>, 4> tables{};
+    // 2^31 / 4 = 2^29 increments per table
+    constexpr std::size_t kFlushEvery = std::size_t{1} << 31;
+    std::size_t i = 0;
+    while (i < bytes.size()) {
+        const std::size_t stop = std::min(bytes.size(), i + kFlushEvery);
+        for (; i + 4 <= stop; i += 4) {
+            ++tables[0][bytes[i]];
+            ++tables[1][bytes[i + 1]];
+            ++tables[2][bytes[i + 2]];
+            ++tables[3][bytes[i + 3]];
+        }
+        for (; i < stop; ++i) {
+            ++tables[0][bytes[i]];
+        }
+        for (auto &table : tables) {
+            for (std::size_t b = 0; b < 256; ++b) {
+                counts[b] += table[b];
+            }
+            table.fill(0);
+        }
+    }
+    return counts;
+}
+
+// counts[k] += occurrences of key k; keys >= counts.size() are ignored.
+// Up to kSmallBuckets buckets are counted with vector compares.
+inline void histogram(std::span<const std::uint32_t> keys, std::span<std::uint64_t> counts) {
+    if (counts.size() <= simd_detail::kSmallBuckets) {
+        simd_detail::dispatch([&](auto kernels) {
+            decltype(kernels)::histogram_small(keys.data(), keys.size(), counts.data(),
+                                               counts.size());
+        });
+        return;
+    }
+    for (std::uint32_t key : keys) {
+        if (key < counts.size()) {
+            ++counts[key];
+        }
+    }
+}
+
+}  // namespace day1::simd
@@ -1,7 +1,516 @@
+// day1/examples/stl_advanced.cpp
+// Day 1 Afternoon: STL Algorithms, Containers & Allocators
+
+#include <algorithm>
 #include <iostream>
+#include <list>
+#include <map>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bloom_filter.hpp"
+#include "btree_map.hpp"
+#include "common/timer.hpp"
+#include "concurrent_skip_map.hpp"
+#include "flat_hash_map.hpp"
+#include "flat_map.hpp"
+#include "fused_pipeline.hpp"
+#include "parallel_algorithms.hpp"
+#include "pool_allocator.hpp"
+#include "radix_sort.hpp"
+#include "simd_reductions.hpp"
+
+// =============================================================================
+// Example 1: Custom Allocator
+// =============================================================================
+
+void print_pool_stats(const char *label) {
+    auto stats = day1::pool_stats();
+    std::cout << label << ": " << stats.chunks_live() << " chunks live ("
+              << stats.bytes_reserved() / 1024 << " KB), " << stats.chunks_released()
+              << " released, " << stats.large_allocations << " large allocations\n";
+}
+
+void pool_allocator_demo() {
+    std::cout << "\n=== Pool Allocator Demo ===\n";
+
+    // Every node-based container gets its nodes from the size-class pools
+    {
+        std::list<int, day1::PoolAllocator<int>> numbers;
+        for (int i = 0; i < 10'000; ++i) {
+            numbers.push_back(i);
+        }
+
+        using MapAlloc = day1::PoolAllocator<std::pair<const int, std::string>>;
+        std::map<int, std::string, std::less<>, MapAlloc> names;
+        for (int i = 0; i < 1'000; ++i) {
+            names.emplace(i, "item" + std::to_string(i));
+        }
+
+        std::unordered_map<int, int, std::hash<int>, std::equal_to<>,
+                           day1::PoolAllocator<std::pair<const int, int>>>
+            squares;
+        for (int i = 0; i < 1'000; ++i) {
+            squares[i] = i * i;
+        }
+
+        std::cout << "list size " << numbers.size() << ", map size " << names.size()
+                  << ", unordered_map[31] = " << squares[31] << "\n";
+        print_pool_stats("While containers are alive");
+    }
+
+    // Blocks freed by other threads land in their caches and are flushed to
+    // the central pool when each thread exits
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([] {
+            std::list<long, day1::PoolAllocator<long>> local;
+            for (long i = 0; i < 50'000; ++i) {
+                local.push_front(i);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    print_pool_stats("After worker threads exit");
+
+    // Idle chunks go back to the system
+    day1::pool_trim();
+    print_pool_stats("After pool_trim()");
+
+    auto per_class = day1::pool_stats().classes;
+    std::cout << "Size classes used:";
+    for (const auto &c : per_class) {
+        if (c.chunks_allocated > 0) {
+            std::cout << " " << c.block_size << "B(" << c.refills << " refills)";
+        }
+    }
+    std::cout << "\n";
+}
+
+// =============================================================================
+// Example 2: Flat Hash Containers
+// =============================================================================
+
+void flat_hash_demo() {
+    std::cout << "\n=== Flat Hash Map Demo ===\n";
+
+    // Heterogeneous lookup: string_view probes never build a std::string
+    day1::flat_hash_set<std::string> words{"apple", "banana", "cherry"};
+    std::string_view sv = "banana";
+    if (words.contains(sv)) {
+        std::cout << "Found: " << sv << "\n";
+    }
+
+    // try_emplace only constructs the value when the key is new
+    day1::flat_hash_map<int, std::string> cache;
+    auto [it1, inserted1] = cache.try_emplace(1, "value1");
+    auto [it2, inserted2] = cache.try_emplace(1, "value2");  // Not inserted
+    std::cout << "Inserted first: " << inserted1 << ", second: " << inserted2
+              << ", cache[1] = " << it2->second << "\n";
+
+    // insert_or_assign overwrites in place
+    cache.insert_or_assign(1, "value3");
+    std::cout << "After insert_or_assign: cache[1] = " << cache.at(1) << "\n";
+
+    // All elements live in one slot array: no allocation per insert
+    day1::flat_hash_map<std::string, int> counts;
+    counts.reserve(1000);
+    const std::size_t capacity_before = counts.capacity();
+    for (int i = 0; i < 1000; ++i) {
+        ++counts["key" + std::to_string(i % 100)];
+    }
+    std::cout << "Distinct keys: " << counts.size() << ", counts[\"key7\"] = "
+              << counts.at(std::string_view("key7")) << ", capacity unchanged: "
+              << (counts.capacity() == capacity_before) << ", load factor "
+              << counts.load_factor() << "\n";
+
+    counts.erase_if([](const auto &kv) { return kv.first.size() == 4; });  // key0..key9
+    std::cout << "After erase_if: " << counts.size() << " keys\n";
+}
+
+// =============================================================================
+// Example 3: Sorted-Vector Containers
+// =============================================================================
+
+void flat_map_demo() {
+    std::cout << "\n=== Flat Map Demo ===\n";
+
+    // Bulk build from unsorted input: one sort instead of n tree inserts
+    std::vector<int> keys{5, 3, 9, 1, 7, 3};
+    std::vector<std::string> values{"five", "three", "nine", "one", "seven", "dup"};
+    day1::flat_map<int, std::string> map1(std::move(keys), std::move(values));
+
+    std::cout << "map1:";
+    for (const auto &[key, value] : map1) {
+        std::cout << " " << key << "=" << value;
+    }
+    std::cout << "\n";
+
+    // Batch insert sorts the new elements and merges them in one pass
+    std::vector<std::pair<int, std::string>> batch{{8, "eight"}, {2, "two"}, {5, "ignored"}};
+    map1.insert(batch.begin(), batch.end());
+    std::cout << "After batch insert: " << map1.size() << " elements, map1[5] = " << map1.at(5)
+              << "\n";
+
+    // Node-extract equivalent: move a whole key range into another map
+    day1::flat_map<int, std::string> map2{{20, "twenty"}};
+    map2.merge(map1.extract_range(3, 8));  // keys 3, 5, 7
+    std::cout << "map1 keys:";
+    for (int key : map1.keys()) {
+        std::cout << " " << key;
+    }
+    std::cout << " | map2 keys:";
+    for (int key : map2.keys()) {
+        std::cout << " " << key;
+    }
+    std::cout << "\n";
+
+    // Range scans walk two dense arrays
+    long sum = 0;
+    map2.for_each_in_range(0, 10, [&](int key, const std::string &) { sum += key; });
+    std::cout << "Sum of map2 keys in [0, 10): " << sum << "\n";
+
+    day1::flat_set<std::string, std::less<>> words{"cherry", "apple", "banana"};
+    std::cout << "flat_set front: " << *words.begin()
+              << ", contains(\"banana\"sv): " << words.contains(std::string_view("banana"))
+              << "\n";
+}
+
+// =============================================================================
+// Example 4: Parallel Algorithms
+// =============================================================================
+
+// One untimed warm-up run, then the best of `reps` timed runs in μs, the
+// same estimate parallel_algorithms_bench reports
+template <typename F>
+double warm_best_of_us(int reps, F &&f) {
+    f();
+    double best = 0.0;
+    for (int i = 0; i < reps; ++i) {
+        common::Stopwatch watch;
+        f();
+        const double us = watch.elapsed_us();
+        best = i == 0 ? us : std::min(best, us);
+    }
+    return best;
+}
+
+void parallel_algorithms() {
+    std::cout << "\n=== Parallel Algorithms ===\n";
+
+    std::vector<double> data(1'000'000);
+    std::iota(data.begin(), data.end(), 1.0);
+
+    // Start the pool's threads before any timing
+    const std::size_t threads = day1::WorkStealingPool::global().size();
+    constexpr int kReps = 5;
+
+    // Sequential
+    double sum_seq = 0.0;
+    const double seq_us = warm_best_of_us(
+        kReps, [&] { sum_seq = std::accumulate(data.begin(), data.end(), 0.0); });
+
+    // Parallel on the in-project work-stealing pool (no TBB needed)
+    double sum_par = 0.0;
+    const double par_us = warm_best_of_us(kReps, [&] {
+        sum_par = day1::reduce(day1::execution::par, data.begin(), data.end(), 0.0);
+    });
+
+    std::cout << "Pool threads: " << threads << "\n";
+    std::cout << "Sums match: " << (sum_seq == sum_par) << "\n";
+    std::cout << "Sequential (best of " << kReps << "): " << seq_us << "μs\n";
+    std::cout << "Parallel (best of " << kReps << "): " << par_us << "μs\n";
+    if (threads > 1) {
+        std::cout << "Speedup: " << seq_us / std::max(1.0, par_us) << "x\n";
+    } else {
+        std::cout << "Speedup: n/a, the pool has one thread so there is nothing to compare\n";
+    }
+
+    // The rest of the family shares the same policy argument
+    std::vector<long> values(200'000);
+    day1::transform(day1::execution::par, data.begin(), data.begin() + 200'000, values.begin(),
+                    [](double d) { return static_cast<long>(d) * 7919 % 100'003; });
+    day1::sort(day1::execution::par, values.begin(), values.end());
+    std::vector<long> prefix(values.size());
+    day1::inclusive_scan(day1::execution::par, values.begin(), values.end(), prefix.begin());
+    std::cout << "Sorted: " << std::is_sorted(values.begin(), values.end())
+              << ", prefix total: " << prefix.back() << "\n";
+}
+
+// =============================================================================
+// Example 5: Radix Sort
+// =============================================================================
+
+void radix_sort_demo() {
+    std::cout << "\n=== Radix Sort ===\n";
+
+    std::vector<int> ints = {42, -7, 1'000'000, 0, -1'000'000, 13, -7, 8};
+    day1::radix_sort(day1::execution::seq, ints.begin(), ints.end());
+    std::cout << "Integers:";
+    for (int v : ints) {
+        std::cout << " " << v;
+    }
+    std::cout << "\n";
+
+    // Floats go through an order-preserving bit transform, so negatives work
+    std::vector<double> doubles = {3.5, -0.25, 1e9, -1e9, 0.0, -2.75, 1e-9};
+    day1::radix_sort(day1::execution::seq, doubles.begin(), doubles.end());
+    std::cout << "Doubles:";
+    for (double v : doubles) {
+        std::cout << " " << v;
+    }
+    std::cout << "\n";
+
+    // Records sorted by key keep their original order among equal keys
+    std::vector<std::pair<unsigned, std::string>> tasks = {
+        {2, "compile"}, {1, "fetch"}, {2, "link"}, {0, "plan"}, {1, "configure"}};
+    day1::radix_sort(day1::execution::seq, tasks.begin(), tasks.end(),
+                     [](const auto &task) { return task.first; });
+    std::cout << "By priority (stable):";
+    for (const auto &[priority, name] : tasks) {
+        std::cout << " " << priority << ":" << name;
+    }
+    std::cout << "\n";
+
+    // Large inputs take the parallel MSD + per-bucket LSD path
+    std::vector<unsigned> big(2'000'000);
+    for (std::size_t i = 0; i < big.size(); ++i) {
+        big[i] = static_cast<unsigned>(i * 2'654'435'761u);
+    }
+    common::Stopwatch watch;
+    day1::radix_sort(day1::execution::par, big.begin(), big.end());
+    const double sort_us = watch.elapsed_us();
+    std::cout << "2M keys sorted: " << std::is_sorted(big.begin(), big.end()) << " in " << sort_us
+              << "μs\n";
+}
+
+// =============================================================================
+// Example 6: Fused Range Pipelines
+// =============================================================================
+
+void fused_pipeline_demo() {
+    std::cout << "\n=== Fused Range Pipelines ===\n";
+
+    // The sum of even squares up to 2M is ~1.3e18, within a long
+    std::vector<int> numbers(2'000'000);
+    std::iota(numbers.begin(), numbers.end(), 1);
+    auto even = [](int n) { return n % 2 == 0; };
+    auto square = [](int n) { return static_cast<long>(n) * n; };
+
+    // Lazy views: one element at a time, one branch per element
+    common::Stopwatch watch;
+    long views_sum = 0;
+    for (long v : numbers | std::views::filter(even) | std::views::transform(square)) {
+        views_sum += v;
+    }
+    const double views_us = watch.elapsed_us();
+    watch.reset();
+
+    // Same chain fused into block kernels: masks, SIMD compaction, reduce
+    auto squares =
+        day1::fused::from(numbers) | day1::fused::filter(even) | day1::fused::transform(square);
+    long fused_sum = squares.reduce(day1::execution::par, 0L);
+    const double fused_us = watch.elapsed_us();
+
+    std::cout << "Sums match: " << (views_sum == fused_sum) << "\n";
+    std::cout << "std::views: " << views_us << "μs\n";
+    std::cout << "Fused: " << fused_us << "μs\n";
+
+    std::vector<int> head(numbers.begin(), numbers.begin() + 10);
+    auto small =
+        day1::fused::from(head) | day1::fused::filter(even) | day1::fused::transform(square);
+    std::cout << "Even squares:";
+    for (long v : small.to_vector(day1::execution::seq)) {
+        std::cout << " " << v;
+    }
+    std::cout << "\n";
+}
+
+// =============================================================================
+// Example 7: SIMD Reductions
+// =============================================================================
+
+void simd_reductions_demo() {
+    std::cout << "\n=== SIMD Reductions ===\n";
+    std::cout << "Kernels: " << day1::simd::isa_name(day1::simd::active_isa()) << "\n";
+
+    // 0.1 is not representable; a million of them shows how error accumulates
+    std::vector<double> tenths(1'000'000, 0.1);
+    std::span<const double> span(tenths);
+    std::cout.precision(17);
+    std::cout << "std::accumulate:  " << std::accumulate(tenths.begin(), tenths.end(), 0.0) << "\n";
+    std::cout << "simd fast:        " << day1::simd::sum(span) << "\n";
+    std::cout << "simd pairwise:    " << day1::simd::sum(span, day1::simd::SumMode::pairwise)
+              << "\n";
+    std::cout << "simd compensated: " << day1::simd::sum(span, day1::simd::SumMode::compensated)
+              << "\n";
+    std::cout.precision(6);
+
+    std::vector<double> samples(100'000);
+    std::mt19937 rng(1);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    for (auto &s : samples) {
+        s = dist(rng);
+    }
+    std::span<const double> sample_span(samples);
+    auto [lo, hi] = day1::simd::min_max(sample_span);
+    std::cout << "Samples in [" << lo << ", " << hi << "], min at index "
+              << day1::simd::argmin(sample_span) << ", sum of squares "
+              << day1::simd::dot(sample_span, sample_span) << "\n";
+}
+
+// =============================================================================
+// Example 8: Bloom Filters
+// =============================================================================
+
+void bloom_filter_demo() {
+    std::cout << "\n=== Bloom Filters ===\n";
+
+    std::set<std::string, std::less<>> words;
+    for (int i = 0; i < 100'000; ++i) {
+        words.insert("word" + std::to_string(i));
+    }
+    day1::BlockedBloomFilter<std::string> filter(words.size(), 0.01);
+    for (const auto &w : words) {
+        filter.insert(w);
+    }
+    std::cout << "Filter: " << filter.memory_bytes() / 1024 << " KB for " << words.size()
+              << " words, predicted false-positive rate "
+              << filter.estimated_false_positive_rate() << "\n";
+
+    // Half the probes miss; the filter answers most of those without the set
+    int set_lookups = 0;
+    int found = 0;
+    for (int i = 0; i < 200'000; i += 2) {
+        std::string probe = "word" + std::to_string(i);
+        std::string_view sv = probe;
+        if (filter.contains(sv)) {
+            ++set_lookups;
+            found += words.find(sv) != words.end();
+        }
+    }
+    std::cout << "Probes: 100000, set lookups: " << set_lookups << ", found: " << found << "\n";
+
+    // The counting variant supports removal
+    day1::CountingBloomFilter<std::string> sessions(1000);
+    sessions.insert(std::string("alice"));
+    sessions.insert(std::string("bob"));
+    sessions.erase(std::string("alice"));
+    std::cout << "Counting filter: alice=" << sessions.contains(std::string_view("alice"))
+              << ", bob=" << sessions.contains(std::string_view("bob")) << "\n";
+}
+
+// =============================================================================
+// Example 9: B+Tree Map
+// =============================================================================
+
+void btree_map_demo() {
+    std::cout << "\n=== B+Tree Map ===\n";
+
+    // Ordered like std::map, but keys sit contiguously in 512-byte nodes
+    day1::btree_map<int, std::string> events;
+    for (int t = 0; t < 10'000; t += 7) {
+        events.try_emplace(t, "event@" + std::to_string(t));
+    }
+    std::cout << "Stored " << events.size() << " events in a tree of height " << events.height()
+              << "\n";
+
+    auto it = events.lower_bound(5000);
+    std::cout << "First event at or after t=5000: " << (*it).second << "\n";
+
+    // Range scans walk the linked leaves without revisiting inner nodes
+    int in_window = 0;
+    events.for_each_in_range(2000, 3000, [&](const int &, const std::string &) { ++in_window; });
+    std::cout << "Events in [2000, 3000): " << in_window << "\n";
+
+    std::size_t dropped = events.erase_if([](const auto &kv) { return kv.first % 2 == 0; });
+    std::cout << "Dropped " << dropped << " even timestamps, " << events.size() << " remain\n";
+
+    // erase_if leaves the tree intact when nothing matches, and keeps every
+    // non-matching element when some do
+    std::size_t none = events.erase_if([](const auto &kv) { return kv.first < 0; });
+    std::size_t late = events.erase_if([](const auto &kv) { return kv.first >= 9000; });
+    std::cout << "erase_if(no match) dropped " << none << ", erase_if(t >= 9000) dropped " << late
+              << ", " << events.size() << " remain, t=7 -> " << (*events.find(7)).second << "\n";
+}
+
+// =============================================================================
+// Example 10: Concurrent Skip List
+// =============================================================================
+
+void concurrent_skip_map_demo() {
+    std::cout << "\n=== Concurrent Skip List ===\n";
+
+    // Writers insert and erase while a reader scans, with no lock anywhere
+    day1::concurrent_skip_map<int, int> prices;
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; ++w) {
+        writers.emplace_back([&prices, w] {
+            for (int i = w; i < 20'000; i += 4) {
+                prices.try_emplace(i, i * 10);
+                if (i % 3 == 0) {
+                    prices.erase(i);
+                }
+            }
+        });
+    }
+
+    // A snapshot sees exactly the elements present at one instant
+    std::size_t seen = 0;
+    bool ordered = true;
+    {
+        auto snap = prices.make_snapshot();
+        int previous = -1;
+        for (auto [key, value] : snap) {
+            ordered = ordered && key > previous && value == key * 10;
+            previous = key;
+            ++seen;
+        }
+    }
+    for (auto &t : writers) {
+        t.join();
+    }
+    std::cout << "Mid-write snapshot: " << seen << " entries, ordered: " << std::boolalpha
+              << ordered << "\n";
+
+    int in_range = 0;
+    prices.for_each_in_range(1000, 2000, [&](const int &, const int &) { ++in_range; });
+    std::cout << "Final size: " << prices.size() << ", keys in [1000, 2000): " << in_range
+              << "\n";
+}
 
 int main() {
-    std::cout << "Hello from Day 1 - STL Advanced Demo!\n";
-    std::cout << "This is a placeholder for the afternoon session.\n";
+    std::cout << "🚀 Day 1 Afternoon: STL Algorithms & Containers\n";
+    std::cout << "==============================================\n";
+
+    try {
+        pool_allocator_demo();
+        flat_hash_demo();
+        flat_map_demo();
+        parallel_algorithms();
+        radix_sort_demo();
+        fused_pipeline_demo();
+        simd_reductions_demo();
+        bloom_filter_demo();
+        btree_map_demo();
+        concurrent_skip_map_demo();
+
+        std::cout << "\n✅ All demonstrations completed successfully!\n";
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,377 @@
+// day1/examples/work_stealing_pool.hpp
+// Work-stealing thread pool built on Chase-Lev deques
+//
+// Every worker owns a deque: it pushes and pops tasks at the bottom (LIFO,
+// cache-warm for fork-join), while idle workers steal from the top (FIFO,
+// the oldest and usually largest pieces of work). Tasks submitted from
+// outside the pool go through a shared injection queue. Threads waiting on
+// a TaskGroup help run tasks instead of blocking, so nested fork-join
+// cannot deadlock the pool.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/cache_line.hpp"
+
+namespace day1 {
+
+// Single-owner, multi-thief deque (Chase & Lev 2005, with the C11 memory
+// orderings from Le et al. 2013). Only the owner calls push/pop.
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_pointer_v<T>, "ChaseLevDeque stores pointers");
+
+   private:
+    struct Buffer {
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Buffer(std::int64_t cap)
+            : capacity(cap),
+              mask(cap - 1),
+              slots(new std::atomic<T>[static_cast<std::size_t>(cap)]) {}
+
+        T load(std::int64_t i, std::memory_order order = std::memory_order_relaxed) const {
+            return slots[static_cast<std::size_t>(i & mask)].load(order);
+        }
+        void store(std::int64_t i, T value,
+                   std::memory_order order = std::memory_order_relaxed) {
+            slots[static_cast<std::size_t>(i & mask)].store(value, order);
+        }
+    };
+
+    alignas(common::kCacheLine) std::atomic<std::int64_t> top_{0};
+    alignas(common::kCacheLine) std::atomic<std::int64_t> bottom_{0};
+    alignas(common::kCacheLine) std::atomic<Buffer *> buffer_;
+    // Thieves may still read an old buffer after a grow; keep every buffer
+    // alive until the deque itself goes away
+    std::vector<std::unique_ptr<Buffer>> retired_;
+
+   public:
+    explicit ChaseLevDeque(std::int64_t capacity = 256) {
+        auto initial = std::make_unique<Buffer>(capacity);
+        buffer_.store(initial.get(), std::memory_order_relaxed);
+        retired_.push_back(std::move(initial));
+    }
+
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+    void push(T item) {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        if (b - t > buffer->capacity - 1) {
+            buffer = grow(buffer, t, b);
+        }
+        // Release on the slot as well as the fence: free on x86, and it lets
+        // race detectors see that a thief's acquire load publishes the task
+        buffer->store(b, item, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    T pop() {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {  // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T item = buffer->load(b);
+        if (t == b) {  // last element: race the thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T steal() {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Buffer *buffer = buffer_.load(std::memory_order_acquire);
+        T item = buffer->load(t, std::memory_order_acquire);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;  // lost the race; caller may retry elsewhere
+        }
+        return item;
+    }
+
+    bool empty() const {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    Buffer *grow(Buffer *old, std::int64_t t, std::int64_t b) {
+        auto bigger = std::make_unique<Buffer>(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            bigger->store(i, old->load(i));
+        }
+        Buffer *raw = bigger.get();
+        retired_.push_back(std::move(bigger));
+        buffer_.store(raw, std::memory_order_release);
+        return raw;
+    }
+};
+
+class WorkStealingPool {
+   private:
+    struct Task {
+        std::function<void()> fn;
+    };
+
+    struct Worker {
+        ChaseLevDeque<Task *> deque;
+        std::thread thread;
+    };
+
+    // Which pool/worker (if any) the current thread belongs to
+    struct WorkerContext {
+        WorkStealingPool *pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    static WorkerContext &context() {
+        thread_local WorkerContext ctx;
+        return ctx;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex inject_mutex_;
+    std::deque<Task *> inject_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<std::int64_t> queued_{0};  // pushed but not yet claimed
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+
+   public:
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency()) {
+        threads = std::max(1u, threads);
+        workers_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stop_.store(true, std::memory_order_seq_cst);
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_) {
+            worker->thread.join();
+        }
+        // Drop anything never run (only possible if callers did not wait)
+        for (auto &worker : workers_) {
+            while (Task *task = worker->deque.pop()) {
+                delete task;
+            }
+        }
+        for (Task *task : inject_) {
+            delete task;
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    // Process-wide pool sized to the machine
+    static WorkStealingPool &global() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    // Fire-and-forget; use TaskGroup to wait for completion
+    void submit(std::function<void()> fn) {
+        auto *task = new Task{std::move(fn)};
+        WorkerContext &ctx = context();
+        if (ctx.pool == this) {
+            workers_[ctx.index]->deque.push(task);
+        } else {
+            std::lock_guard lock(inject_mutex_);
+            inject_.push_back(task);
+        }
+        queued_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard lock(sleep_mutex_);
+            wake_.notify_one();
+        }
+    }
+
+    // Run one pending task on the calling thread; false if none was found
+    bool try_run_one() {
+        Task *task = find_task();
+        if (task == nullptr) {
+            return false;
+        }
+        run(task);
+        return true;
+    }
+
+   private:
+    Task *find_task() {
+        WorkerContext &ctx = context();
+        Task *task = nullptr;
+        if (ctx.pool == this) {
+            task = workers_[ctx.index]->deque.pop();
+        }
+        if (task == nullptr) {
+            task = steal(ctx.pool == this ? ctx.index : workers_.size());
+        }
+        if (task == nullptr) {
+            std::lock_guard lock(inject_mutex_);
+            if (!inject_.empty()) {
+                task = inject_.front();
+                inject_.pop_front();
+            }
+        }
+        if (task != nullptr) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task *steal(std::size_t self) {
+        thread_local std::minstd_rand rng(std::random_device{}());
+        const std::size_t n = workers_.size();
+        const std::size_t start = rng() % n;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t victim = (start + i) % n;
+            if (victim == self) {
+                continue;
+            }
+            if (Task *task = workers_[victim]->deque.steal()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    static void run(Task *task) {
+        std::unique_ptr<Task> owned(task);
+        owned->fn();
+    }
+
+    void worker_loop(std::size_t index) {
+        context() = {this, index};
+        int idle_spins = 0;
+        while (true) {
+            if (Task *task = find_task()) {
+                run(task);
+                idle_spins = 0;
+                continue;
+            }
+            if (++idle_spins < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            wake_.wait(lock, [this] {
+                return stop_.load(std::memory_order_seq_cst) ||
+                       queued_.load(std::memory_order_seq_cst) > 0;
+            });
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+            if (stop_.load() && queued_.load() <= 0) {
+                return;
+            }
+            idle_spins = 0;
+        }
+    }
+};
+
+// Fork-join scope: run() spawns, wait() helps execute until all spawned
+// tasks finished, then rethrows the first exception any of them threw
+class TaskGroup {
+   private:
+    WorkStealingPool &pool_;
+    std::atomic<std::size_t> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+   public:
+    explicit TaskGroup(WorkStealingPool &pool = WorkStealingPool::global()) : pool_(pool) {}
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    ~TaskGroup() {
+        // Tasks reference this object; never leave while they are in flight
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (!pool_.try_run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    WorkStealingPool &pool() {
+        return pool_;
+    }
+
+    template <typename F>
+    void run(F &&f) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit([this, fn = std::forward<F>(f)]() mutable {
+            try {
+                fn();
+            } catch (...) {
+                std::lock_guard lock(error_mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            pending_.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait() {
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (!pool_.try_run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        std::lock_guard lock(error_mutex_);
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+};
+
+}  // namespace day1
@@ -2,12 +2,13 @@
 // Move Semantics Hands-On Exercises
 
 #include <algorithm>
-#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "common/timer.hpp"
+
 // =============================================================================
 // Exercise 1: Fix the String Wrapper Class
 // =============================================================================
@@ -197,9 +198,9 @@ void performance_test() {
 
     // TODO: Test copy performance
     // Guide: 1. Start timer, 2. Create vector and copy resources ITERATIONS times, 3. End timer
-    // Hint: Use std::chrono::high_resolution_clock
+    // Hint: Use common::Stopwatch (common/timer.hpp)
 
-    auto start_copy = std::chrono::high_resolution_clock::now();
+    common::Stopwatch copy_watch;
     {
         std::vector<HeavyResource> resources;
         resources.reserve(ITERATIONS);
@@ -211,12 +212,12 @@ void performance_test() {
             resources.push_back(temp);
         }
     }
-    auto end_copy = std::chrono::high_resolution_clock::now();
+    const double copy_ms = copy_watch.elapsed_ms();
 
     // TODO: Test move performance
     // Guide: Same as above but use std::move when pushing
 
-    auto start_move = std::chrono::high_resolution_clock::now();
+    common::Stopwatch move_watch;
     {
         std::vector<HeavyResource> resources;
         resources.reserve(ITERATIONS);
@@ -228,14 +229,12 @@ void performance_test() {
             resources.push_back(std::move(temp));
         }
     }
-    auto end_move = std::chrono::high_resolution_clock::now();
+    const double move_ms = move_watch.elapsed_ms();
 
     // TODO: Calculate and print timing results
-    // Guide: Use duration_cast to get milliseconds, compare copy vs move times
-    auto copy_time = std::chrono::duration_cast<std::chrono::microseconds>(end_copy - start_copy);
-    std::cout << "Copy: " << copy_time.count() << std::endl;
-    auto move_time = std::chrono::duration_cast<std::chrono::microseconds>(end_move - start_move);
-    std::cout << "Move: " << move_time.count() << std::endl;
+    // Guide: Print both times in milliseconds, compare copy vs move times
+    std::cout << "Copy: " << copy_ms << " ms\n";
+    std::cout << "Move: " << move_ms << " ms\n";
 
     std::cout << "Performance test completed!\n";
 }
@@ -0,0 +1,415 @@
+// day1/project/cache_policy.hpp
+// Eviction and admission policies for ResourceManager
+//
+// Pure LRU admits everything and evicts the oldest entry, so one long
+// sequential pass over cold assets (a level load, a directory scan)
+// replaces the whole hot set with entries that are never used again. The
+// policies here keep the same container interface and differ in which
+// entry they give up:
+//
+//   - LruPolicy: plain LRU (lru_cache.hpp)
+//   - WTinyLfuPolicy: new entries enter a small LRU window (1%). An entry
+//     pushed out of the window is a candidate for the main area: at the
+//     next eviction it must beat the main area's oldest entry on estimated
+//     access frequency, from a count-min sketch of recent accesses, or it
+//     is evicted instead. A scan's one-hit entries lose that duel. The
+//     main area is a segmented LRU: entries hit again move from probation
+//     to protected (80%).
+//   - ArcPolicy: Adaptive Replacement Cache. Entries seen once (T1) and
+//     more than once (T2) are separate LRUs, and the keys recently evicted
+//     from each are kept as ghosts (B1, B2). A miss that hits a ghost list
+//     shifts the target size of T1 toward the list that would have kept it.
+//
+// The owner decides when to evict; a policy never knows a capacity. W-TinyLFU's
+// window and protected shares and ARC's ghost lists follow the current
+// number of entries instead, so the policies also work under byte budgets.
+//
+// Interface, for ResourceManager's Policy parameter:
+//
+//     Value *find(key)              hit: counts the access, may reorder
+//     const Value *peek(key) const  no side effects
+//     void record_miss(key)         called once per miss, before insert
+//     Value &insert(key, value)     requires key absent
+//     const Value &victim() const   entry evict() would remove
+//     pair<string, Value> evict()
+//     contains, erase, clear, size, empty
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "flat_hash_map.hpp"
+#include "lru_cache.hpp"
+
+namespace day1 {
+
+namespace policy_detail {
+
+inline std::uint64_t key_hash(std::string_view key) {
+    return hash_detail::mix(string_hash{}(key));
+}
+
+// Count-min sketch of 4-bit counters, 16 per word, four rows sharing one
+// table. Once the number of increments reaches ten per tracked entry, every
+// counter is halved, so popularity that is no longer current fades
+// (TinyLFU's reset).
+class FrequencySketch {
+   public:
+    // Grows the table for entries keys; growing forgets all counts
+    void ensure_capacity(std::size_t entries) {
+        const std::size_t words = std::bit_ceil(std::max<std::size_t>(entries, 16));
+        if (words <= table_.size()) {
+            return;
+        }
+        table_.assign(words, 0);
+        sample_size_ = 10 * words;
+        additions_ = 0;
+    }
+
+    unsigned frequency(std::uint64_t hash) const {
+        if (table_.empty()) {
+            return 0;
+        }
+        unsigned count = 15;
+        for (unsigned row = 0; row < 4; ++row) {
+            const auto [word, shift] = locate(hash, row);
+            count = std::min(count, static_cast<unsigned>((table_[word] >> shift) & 0xF));
+        }
+        return count;
+    }
+
+    void increment(std::uint64_t hash) {
+        if (table_.empty()) {
+            return;
+        }
+        bool added = false;
+        for (unsigned row = 0; row < 4; ++row) {
+            const auto [word, shift] = locate(hash, row);
+            if (((table_[word] >> shift) & 0xF) != 0xF) {
+                table_[word] += std::uint64_t{1} << shift;
+                added = true;
+            }
+        }
+        if (added && ++additions_ >= sample_size_) {
+            for (std::uint64_t &w : table_) {
+                w = (w >> 1) & 0x7777777777777777ULL;
+            }
+            additions_ /= 2;
+        }
+    }
+
+   private:
+    // Word and bit offset of key's counter in row
+    std::pair<std::size_t, unsigned> locate(std::uint64_t hash, unsigned row) const {
+        static constexpr std::uint64_t kSeeds[4] = {0x97cb3127ULL, 0xc3a5c85c97cb3127ULL,
+                                                    0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL};
+        const std::uint64_t h = (hash + kSeeds[row]) * 0x9e3779b97f4a7c15ULL;
+        const auto word = static_cast<std::size_t>(h >> 32) & (table_.size() - 1);
+        const auto nibble = static_cast<unsigned>((hash >> (row * 4)) & 0xF);
+        return {word, nibble * 4};
+    }
+
+    std::vector<std::uint64_t> table_;
+    std::size_t sample_size_ = 0;
+    std::size_t additions_ = 0;
+};
+
+}  // namespace policy_detail
+
+template <typename Value>
+class LruPolicy {
+   public:
+    std::size_t size() const noexcept {
+        return cache_.size();
+    }
+    bool empty() const noexcept {
+        return cache_.empty();
+    }
+
+    Value *find(std::string_view key) {
+        return cache_.find(key);
+    }
+    const Value *peek(std::string_view key) const {
+        return cache_.peek(key);
+    }
+    bool contains(std::string_view key) const {
+        return cache_.contains(key);
+    }
+    void record_miss(std::string_view) {}
+    Value &insert(std::string key, Value value) {
+        return cache_.insert(std::move(key), std::move(value));
+    }
+    const Value &victim() const {
+        return cache_.lru_value();
+    }
+    std::pair<std::string, Value> evict() {
+        return cache_.pop_lru();
+    }
+    bool erase(std::string_view key) {
+        return cache_.erase(key);
+    }
+    void clear() {
+        cache_.clear();
+    }
+
+   private:
+    LruCache<Value> cache_;
+};
+
+template <typename Value>
+class WTinyLfuPolicy {
+   public:
+    WTinyLfuPolicy() = default;
+    WTinyLfuPolicy(const WTinyLfuPolicy &) = delete;
+    WTinyLfuPolicy &operator=(const WTinyLfuPolicy &) = delete;
+
+    std::size_t size() const noexcept {
+        return lists_.size();
+    }
+    bool empty() const noexcept {
+        return lists_.size() == 0;
+    }
+
+    Value *find(std::string_view key) {
+        const Slot slot = lists_.find(key);
+        if (slot == Lists::npos) {
+            return nullptr;
+        }
+        sketch_.increment(policy_detail::key_hash(key));
+        if (lists_.segment(slot) == kWindow) {
+            lists_.move_to_front(slot, kWindow);
+        } else {
+            lists_.move_to_front(slot, kProtected);
+            const std::size_t main = lists_.size(kProbation) + lists_.size(kProtected);
+            if (lists_.size(kProtected) > main * 4 / 5) {
+                lists_.move_to_front(lists_.lru(kProtected), kProbation);
+            }
+        }
+        return &lists_.value(slot);
+    }
+
+    const Value *peek(std::string_view key) const {
+        const Slot slot = lists_.find(key);
+        return slot == Lists::npos ? nullptr : &lists_.value(slot);
+    }
+
+    bool contains(std::string_view key) const {
+        return lists_.find(key) != Lists::npos;
+    }
+
+    void record_miss(std::string_view key) {
+        sketch_.ensure_capacity(lists_.size() + 1);
+        sketch_.increment(policy_detail::key_hash(key));
+    }
+
+    // New entries enter the window; the window's overflow moves to
+    // probation as the next admission candidate
+    Value &insert(std::string key, Value value) {
+        const Slot slot = lists_.insert(std::move(key), std::move(value), kWindow);
+        if (lists_.size(kWindow) > std::max<std::size_t>(1, lists_.size() / 100)) {
+            candidate_ = lists_.lru(kWindow);
+            lists_.move_to_front(candidate_, kProbation);
+        }
+        return lists_.value(slot);
+    }
+
+    const Value &victim() const {
+        return lists_.value(choose());
+    }
+
+    std::pair<std::string, Value> evict() {
+        return remove(choose());
+    }
+
+    bool erase(std::string_view key) {
+        const Slot slot = lists_.find(key);
+        if (slot == Lists::npos) {
+            return false;
+        }
+        remove(slot);
+        return true;
+    }
+
+    void clear() {
+        lists_.clear();
+        candidate_ = Lists::npos;
+    }
+
+   private:
+    enum Segment : std::size_t { kWindow, kProbation, kProtected };
+    using Lists = SegmentedLru<Value, 3>;
+    using Slot = typename Lists::Slot;
+
+    unsigned frequency(Slot slot) const {
+        return sketch_.frequency(policy_detail::key_hash(lists_.key(slot)));
+    }
+
+    // The TinyLFU duel: the latest candidate stays only if it is used more
+    // often than probation's oldest entry. Requires !empty().
+    Slot choose() const {
+        Slot victim = lists_.lru(kProbation);
+        if (victim == Lists::npos) {
+            victim = lists_.lru(kProtected);
+        }
+        if (victim == Lists::npos) {
+            return lists_.lru(kWindow);
+        }
+        if (candidate_ != Lists::npos && candidate_ != victim &&
+            lists_.segment(candidate_) == kProbation &&
+            frequency(candidate_) <= frequency(victim)) {
+            return candidate_;
+        }
+        return victim;
+    }
+
+    std::pair<std::string, Value> remove(Slot slot) {
+        if (slot == candidate_) {
+            candidate_ = Lists::npos;
+        }
+        return lists_.remove(slot);
+    }
+
+    Lists lists_;
+    policy_detail::FrequencySketch sketch_;
+    Slot candidate_ = Lists::npos;  // last window overflow, in probation until hit
+};
+
+template <typename Value>
+class ArcPolicy {
+   public:
+    ArcPolicy() = default;
+    ArcPolicy(const ArcPolicy &) = delete;
+    ArcPolicy &operator=(const ArcPolicy &) = delete;
+
+    std::size_t size() const noexcept {
+        return lists_.size(kT1) + lists_.size(kT2);
+    }
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    Value *find(std::string_view key) {
+        const Slot slot = resident(key);
+        if (slot == Lists::npos) {
+            return nullptr;
+        }
+        lists_.move_to_front(slot, kT2);
+        return &lists_.value(slot);
+    }
+
+    const Value *peek(std::string_view key) const {
+        const Slot slot = resident(key);
+        return slot == Lists::npos ? nullptr : &lists_.value(slot);
+    }
+
+    bool contains(std::string_view key) const {
+        return resident(key) != Lists::npos;
+    }
+
+    // Adapts the T1 target when key is a ghost
+    void record_miss(std::string_view key) {
+        ghost_hit_ = kNone;
+        const Slot slot = lists_.find(key);
+        if (slot == Lists::npos) {
+            return;
+        }
+        const std::size_t b1 = lists_.size(kB1);
+        const std::size_t b2 = lists_.size(kB2);
+        if (lists_.segment(slot) == kB1) {
+            target_t1_ = std::min(size(), target_t1_ + std::max<std::size_t>(1, b2 / b1));
+            ghost_hit_ = kB1;
+        } else if (lists_.segment(slot) == kB2) {
+            const std::size_t step = std::max<std::size_t>(1, b1 / b2);
+            target_t1_ = target_t1_ > step ? target_t1_ - step : 0;
+            ghost_hit_ = kB2;
+        }
+    }
+
+    // A key back from a ghost list has been used more than once: into T2
+    Value &insert(std::string key, Value value) {
+        std::size_t segment = kT1;
+        if (const Slot ghost = lists_.find(key); ghost != Lists::npos) {
+            lists_.remove(ghost);
+            segment = kT2;
+        }
+        ghost_hit_ = kNone;
+        Value &inserted = lists_.value(lists_.insert(std::move(key), std::move(value), segment));
+        trim_ghosts();
+        return inserted;
+    }
+
+    const Value &victim() const {
+        return lists_.value(choose());
+    }
+
+    // The evicted key stays behind as a ghost
+    std::pair<std::string, Value> evict() {
+        const Slot slot = choose();
+        std::pair<std::string, Value> evicted(lists_.key(slot), std::move(lists_.value(slot)));
+        lists_.value(slot) = Value{};
+        lists_.move_to_front(slot, lists_.segment(slot) == kT1 ? kB1 : kB2);
+        trim_ghosts();
+        return evicted;
+    }
+
+    bool erase(std::string_view key) {
+        const Slot slot = resident(key);
+        if (slot == Lists::npos) {
+            return false;
+        }
+        lists_.remove(slot);
+        return true;
+    }
+
+    void clear() {
+        lists_.clear();
+        target_t1_ = 0;
+        ghost_hit_ = kNone;
+    }
+
+   private:
+    enum Segment : std::size_t { kT1, kT2, kB1, kB2, kNone };
+    using Lists = SegmentedLru<Value, 4>;
+    using Slot = typename Lists::Slot;
+
+    Slot resident(std::string_view key) const {
+        const Slot slot = lists_.find(key);
+        return slot != Lists::npos && lists_.segment(slot) <= kT2 ? slot : Lists::npos;
+    }
+
+    // ARC's REPLACE. Requires !empty().
+    Slot choose() const {
+        const std::size_t t1 = lists_.size(kT1);
+        if (t1 > 0 && (t1 > target_t1_ || (ghost_hit_ == kB2 && t1 == target_t1_) ||
+                       lists_.size(kT2) == 0)) {
+            return lists_.lru(kT1);
+        }
+        return lists_.lru(kT2);
+    }
+
+    // Ghosts are bounded by the resident count c: |T1| + |B1| <= c and all
+    // four lists together <= 2c
+    void trim_ghosts() {
+        const std::size_t c = std::max<std::size_t>(1, size());
+        while (lists_.size(kB1) > 0 && lists_.size(kT1) + lists_.size(kB1) > c) {
+            lists_.remove(lists_.lru(kB1));
+        }
+        while (lists_.size(kB1) + lists_.size(kB2) > c) {
+            lists_.remove(lists_.lru(lists_.size(kB2) > 0 ? kB2 : kB1));
+        }
+        target_t1_ = std::min(target_t1_, c);
+    }
+
+    Lists lists_;
+    std::size_t target_t1_ = 0;
+    Segment ghost_hit_ = kNone;
+};
+
+}  // namespace day1
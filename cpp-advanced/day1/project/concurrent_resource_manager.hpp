@@ -0,0 +1,541 @@
+// day1/project/concurrent_resource_manager.hpp
+// Thread-safe resource cache: hash-partitioned shards with striped locks
+//
+// Wrapping ResourceManager in one mutex serializes every get(), including
+// hits that only read. ConcurrentResourceManager splits the key space
+// across independent shards instead, each with its own reader/writer lock
+// and its own LRU list (lru_cache.hpp):
+//
+//   - a hit takes its shard's lock shared and does not reorder the list;
+//     it only sets the entry's reference bit, a relaxed store that is
+//     skipped when the bit is already set, so hot entries are read-only
+//   - eviction takes the lock exclusively and gives referenced entries at
+//     the LRU end a second chance (CLOCK), which approximates LRU order
+//   - the loader runs with no lock held. Concurrent misses on one path
+//     share a single load (single flight): the first miss calls the
+//     loader, later ones wait on its shared_future and get the same
+//     resource, or the same exception if the loader throws
+//   - get_async() returns a shared_future and loads on a bounded I/O pool
+//     (load_scheduler.hpp); prefetch() queues speculative loads at low
+//     priority, and a demand for a path still queued as a prefetch
+//     promotes it
+//   - optionally, failed loads (nullptr or an exception) are remembered for
+//     negative_ttl, so a missing asset does not hit the loader on every get
+//   - hit counters are per shard and incremented without a locked
+//     instruction, so concurrent hits may lose a few counts
+//
+// Capacity is split evenly over the shards, so eviction is least recently
+// used per shard rather than globally. A loader must not get() the path it
+// is loading: with single flight that waits on itself.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/cache_line.hpp"
+#include "flat_hash_map.hpp"
+#include "load_scheduler.hpp"
+#include "lru_cache.hpp"
+#include "resource_manager.hpp"
+
+namespace day1 {
+
+namespace resource_detail {
+
+// Lossy increment: no lock prefix, so concurrent updates may be dropped
+inline void bump(std::atomic<std::uint64_t> &counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+inline std::size_t shard_hash(std::string_view path) {
+    return hash_detail::mix(string_hash{}(path));
+}
+
+inline std::size_t default_shard_count(std::size_t max_size) {
+    const std::size_t wanted = 4 * std::max(1u, std::thread::hardware_concurrency());
+    // At least a few entries per shard so per-shard LRU stays meaningful
+    const std::size_t by_size = std::max<std::size_t>(1, max_size / 8);
+    return std::bit_floor(std::clamp<std::size_t>(std::min(wanted, by_size), 1, 256));
+}
+
+}  // namespace resource_detail
+
+struct ConcurrentResourceOptions {
+    // Rounded down to a power of two; 0 picks a count from the hardware
+    // thread count and max_size
+    std::size_t shard_count = 0;
+    // Concurrent get() misses on one path share one loader call (async
+    // loads are always shared)
+    bool single_flight = true;
+    // How long a failed load is remembered; zero disables negative caching
+    std::chrono::steady_clock::duration negative_ttl{};
+    // I/O pool behind get_async() and prefetch(), started on first use
+    std::size_t io_threads = 4;
+    std::size_t max_queued_prefetches = 256;
+};
+
+template <typename Resource>
+class ConcurrentResourceManager {
+   public:
+    using Loader = std::function<std::unique_ptr<Resource>(const std::string &)>;
+    using SharedLoad = std::shared_future<std::shared_ptr<Resource>>;
+
+    ConcurrentResourceManager(std::size_t max_size, Loader loader,
+                              ConcurrentResourceOptions options = {})
+        : max_cache_size_(max_size), loader_(std::move(loader)), options_(options) {
+        if (!loader_) {
+            throw std::invalid_argument("ConcurrentResourceManager: loader is empty");
+        }
+        std::size_t shard_count = options_.shard_count;
+        if (shard_count == 0) {
+            shard_count = resource_detail::default_shard_count(max_size);
+        }
+        shard_count = std::bit_floor(shard_count);
+        shards_ = std::vector<Shard>(shard_count);
+        for (std::size_t i = 0; i < shard_count; ++i) {
+            shards_[i].capacity = max_size / shard_count + (i < max_size % shard_count);
+        }
+        shard_shift_ = 64 - std::countr_zero(shard_count);
+    }
+
+    std::shared_ptr<Resource> get(const std::string &path) {
+        Shard &shard = shard_for(path);
+        {
+            std::shared_lock lock(shard.mutex);
+            if (const Cached *cached = shard.cache.peek(path)) {
+                if (!cached->referenced.load(std::memory_order_relaxed)) {
+                    cached->referenced.store(true, std::memory_order_relaxed);
+                }
+                resource_detail::bump(shard.hits);
+                return cached->resource;
+            }
+        }
+        return load(shard, path);
+    }
+
+    // Like get(), but a miss is loaded on the I/O pool and this returns at
+    // once; the future is already ready on a hit
+    SharedLoad get_async(const std::string &path) {
+        Shard &shard = shard_for(path);
+        {
+            std::shared_lock lock(shard.mutex);
+            if (const Cached *cached = shard.cache.peek(path)) {
+                if (!cached->referenced.load(std::memory_order_relaxed)) {
+                    cached->referenced.store(true, std::memory_order_relaxed);
+                }
+                resource_detail::bump(shard.hits);
+                return ready(cached->resource);
+            }
+        }
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return schedule(shard, path, LoadPriority::demand);
+    }
+
+    // Hints that paths will be needed soon: queues low-priority loads for
+    // those not cached, in flight or known to fail. Returns how many were
+    // queued; the rest are dropped once the prefetch queue is full.
+    std::size_t prefetch(std::span<const std::string> paths) {
+        std::size_t queued = 0;
+        for (const std::string &path : paths) {
+            queued += schedule(shard_for(path), path, LoadPriority::prefetch).valid();
+        }
+        return queued;
+    }
+
+    bool contains(std::string_view path) const {
+        const Shard &shard = shard_for(path);
+        std::shared_lock lock(shard.mutex);
+        return shard.cache.contains(path);
+    }
+
+    bool erase(std::string_view path) {
+        Shard &shard = shard_for(path);
+        std::unique_lock lock(shard.mutex);
+        return shard.cache.erase(path);
+    }
+
+    // Loads path again, e.g. after its file changed (file_watcher.hpp),
+    // and swaps the new version into the cache if path is still cached.
+    // Holders of the old shared_ptr keep the old version. If the load
+    // fails the entry is dropped, so the next get() sees the failure. Any
+    // remembered failure for path is forgotten, and a load of path already
+    // in flight may have read the old file, so its result is handed to its
+    // waiters but not cached. True if a new version was swapped in.
+    bool reload(const std::string &path) {
+        Shard &shard = shard_for(path);
+        bool cached = false;
+        {
+            std::shared_lock lock(shard.mutex);
+            cached = shard.cache.contains(path);
+        }
+        std::shared_ptr<Resource> fresh;
+        if (cached) {
+            shard.loads.fetch_add(1, std::memory_order_relaxed);
+            try {
+                fresh = loader_(path);
+            } catch (...) {
+                // Dropped below like a nullptr result
+            }
+        }
+        std::unique_lock lock(shard.mutex);
+        shard.failures.erase(path);
+        if (auto running = shard.in_flight.find(path); running != shard.in_flight.end()) {
+            running->second.stale = true;
+        }
+        ++shard.reloads;
+        Cached *entry = shard.cache.peek(path);
+        if (!entry) {
+            return false;
+        }
+        if (!fresh) {
+            shard.cache.erase(path);
+            return false;
+        }
+        entry->resource = std::move(fresh);
+        return true;
+    }
+
+    // Drops cached resources and remembered failures; loads in flight
+    // still complete and insert their result
+    void clear() {
+        for (Shard &shard : shards_) {
+            std::unique_lock lock(shard.mutex);
+            shard.cache.clear();
+            shard.failures.clear();
+        }
+    }
+
+    // Sum over shards; each shard is read under its own lock, so the total
+    // is approximate while other threads are loading
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const Shard &shard : shards_) {
+            std::shared_lock lock(shard.mutex);
+            total += shard.cache.size();
+        }
+        return total;
+    }
+
+    std::size_t max_size() const {
+        return max_cache_size_;
+    }
+    std::size_t shard_count() const {
+        return shards_.size();
+    }
+
+    // Approximate: hit counts may miss concurrent increments
+    CacheStats stats() const {
+        CacheStats total;
+        for (const Shard &shard : shards_) {
+            total.hits += shard.hits.load(std::memory_order_relaxed);
+            total.misses += shard.misses.load(std::memory_order_relaxed);
+            total.evictions += shard.evictions.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Loader invocations so far (misses that joined another load or hit a
+    // remembered failure do not count)
+    std::uint64_t loads() const {
+        std::uint64_t total = 0;
+        for (const Shard &shard : shards_) {
+            total += shard.loads.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+   private:
+    struct Cached {
+        std::shared_ptr<Resource> resource;
+        mutable std::atomic<bool> referenced{false};
+
+        Cached() = default;
+        explicit Cached(std::shared_ptr<Resource> r) : resource(std::move(r)) {}
+        Cached(Cached &&other) noexcept
+            : resource(std::move(other.resource)),
+              referenced(other.referenced.load(std::memory_order_relaxed)) {}
+        Cached &operator=(Cached &&other) noexcept {
+            resource = std::move(other.resource);
+            referenced.store(other.referenced.load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+    using Promise = std::promise<std::shared_ptr<Resource>>;
+
+    // A failed load: error is null when the loader returned nullptr
+    struct Failure {
+        Clock::time_point expires;
+        std::exception_ptr error;
+    };
+
+    // A load in progress; ticket is set when it runs on the I/O pool, and
+    // stale when path was reloaded after the load started
+    struct InFlight {
+        SharedLoad result;
+        LoadScheduler::Ticket ticket;
+        bool stale = false;
+    };
+
+    struct alignas(common::kCacheLine) Shard {
+        mutable std::shared_mutex mutex;
+        LruCache<Cached> cache;
+        flat_hash_map<std::string, InFlight> in_flight;
+        flat_hash_map<std::string, Failure> failures;
+        std::size_t capacity = 0;
+        // reload() calls so far; unregistered loads compare it to spot a
+        // reload that raced them
+        std::uint64_t reloads = 0;
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> evictions{0};
+        std::atomic<std::uint64_t> loads{0};
+    };
+
+    Shard &shard_for(std::string_view path) {
+        return shards_[shard_index(path)];
+    }
+    const Shard &shard_for(std::string_view path) const {
+        return shards_[shard_index(path)];
+    }
+
+    // High bits of the mixed hash; the LRU's own hash map uses the low ones
+    std::size_t shard_index(std::string_view path) const {
+        return shard_shift_ == 64 ? 0 : resource_detail::shard_hash(path) >> shard_shift_;
+    }
+
+    LoadScheduler &scheduler() {
+        std::call_once(scheduler_once_, [this] {
+            scheduler_ = std::make_unique<LoadScheduler>(options_.io_threads,
+                                                         options_.max_queued_prefetches);
+        });
+        return *scheduler_;
+    }
+
+    static SharedLoad ready(std::shared_ptr<Resource> resource) {
+        Promise promise;
+        promise.set_value(std::move(resource));
+        return promise.get_future().share();
+    }
+
+    static SharedLoad ready(const Failure &failure) {
+        Promise promise;
+        if (failure.error) {
+            promise.set_exception(failure.error);
+        } else {
+            promise.set_value(nullptr);
+        }
+        return promise.get_future().share();
+    }
+
+    // Unexpired remembered failure for path, if any. Requires the
+    // exclusive lock.
+    static const Failure *live_failure(Shard &shard, const std::string &path) {
+        auto failed = shard.failures.find(path);
+        if (failed == shard.failures.end()) {
+            return nullptr;
+        }
+        if (Clock::now() < failed->second.expires) {
+            return &failed->second;
+        }
+        shard.failures.erase(failed);
+        return nullptr;
+    }
+
+    // Synchronous miss path. Joins a load already in flight for path (
+    // promoting it if it is a queued prefetch), or loads on this thread and
+    // publishes the outcome to everyone who joined.
+    std::shared_ptr<Resource> load(Shard &shard, const std::string &path) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        Promise promise;
+        std::uint64_t reloads = 0;
+        {
+            std::unique_lock lock(shard.mutex);
+            if (Cached *cached = shard.cache.find(path)) {
+                return cached->resource;  // loaded while we waited for the lock
+            }
+            if (const Failure *failure = live_failure(shard, path)) {
+                if (failure->error) {
+                    std::rethrow_exception(failure->error);
+                }
+                return nullptr;
+            }
+            if (options_.single_flight) {
+                if (auto running = shard.in_flight.find(path); running != shard.in_flight.end()) {
+                    if (running->second.ticket) {
+                        scheduler().promote(running->second.ticket);
+                    }
+                    SharedLoad pending = running->second.result;
+                    lock.unlock();
+                    return pending.get();
+                }
+                shard.in_flight.try_emplace(path, InFlight{promise.get_future().share(), nullptr});
+            }
+            reloads = shard.reloads;
+        }
+        return run_load(shard, path, promise, {options_.single_flight, reloads});
+    }
+
+    // Asynchronous miss path. For a prefetch, returns an empty future when
+    // nothing new was queued.
+    SharedLoad schedule(Shard &shard, const std::string &path, LoadPriority priority) {
+        const bool demand = priority == LoadPriority::demand;
+        std::unique_lock lock(shard.mutex);
+        if (const Cached *cached = shard.cache.peek(path)) {
+            return demand ? ready(cached->resource) : SharedLoad();
+        }
+        if (const Failure *failure = live_failure(shard, path)) {
+            return demand ? ready(*failure) : SharedLoad();
+        }
+        if (auto running = shard.in_flight.find(path); running != shard.in_flight.end()) {
+            if (!demand) {
+                return {};
+            }
+            if (running->second.ticket) {
+                scheduler().promote(running->second.ticket);
+            }
+            return running->second.result;
+        }
+        auto promise = std::make_shared<Promise>();
+        SharedLoad result = promise->get_future().share();
+        // The job cannot finish before in_flight is updated: finish() needs
+        // the shard lock held here
+        auto ticket = scheduler().submit(priority, [this, &shard, path, promise] {
+            try {
+                run_load(shard, path, *promise, {true, 0});
+            } catch (...) {
+                // Already delivered through the promise
+            }
+        });
+        if (!ticket) {
+            return {};  // prefetch queue full
+        }
+        shard.in_flight.try_emplace(path, InFlight{result, std::move(ticket)});
+        return result;
+    }
+
+    // How finish() tells whether a reload overtook a load: through the
+    // in_flight entry the load registered, or else by comparing the shard's
+    // reload count with the one seen when the load started
+    struct LoadOrigin {
+        bool registered;
+        std::uint64_t reloads;
+    };
+
+    // Calls the loader, records the outcome and fulfils promise; rethrows
+    // what the loader throws
+    std::shared_ptr<Resource> run_load(Shard &shard, const std::string &path, Promise &promise,
+                                       LoadOrigin origin) {
+        shard.loads.fetch_add(1, std::memory_order_relaxed);
+        std::shared_ptr<Resource> resource;
+        try {
+            resource = loader_(path);
+        } catch (...) {
+            finish(shard, path, nullptr, std::current_exception(), origin);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+        resource = finish(shard, path, std::move(resource), nullptr, origin);
+        promise.set_value(resource);
+        return resource;
+    }
+
+    // Records a load's outcome and returns the resource callers should get.
+    // An unregistered load (a get() miss without single flight) leaves
+    // in_flight alone: the entry there belongs to a concurrent async load.
+    // A load overtaken by reload() is neither cached nor remembered as a
+    // failure, since it may have read the old file.
+    std::shared_ptr<Resource> finish(Shard &shard, const std::string &path,
+                                     std::shared_ptr<Resource> resource, std::exception_ptr error,
+                                     LoadOrigin origin) {
+        std::unique_lock lock(shard.mutex);
+        bool stale = !origin.registered && shard.reloads != origin.reloads;
+        if (origin.registered) {
+            if (auto running = shard.in_flight.find(path); running != shard.in_flight.end()) {
+                stale = running->second.stale;
+                shard.in_flight.erase(running);
+            }
+        }
+        if (stale) {
+            return resource;
+        }
+        if (!resource) {
+            remember_failure(shard, path, error);
+            return nullptr;
+        }
+        if (shard.capacity == 0) {
+            return resource;
+        }
+        // Without single flight another thread may have loaded it meanwhile
+        if (Cached *cached = shard.cache.find(path)) {
+            return cached->resource;
+        }
+        if (shard.cache.size() >= shard.capacity) {
+            evict_one(shard);
+        }
+        return shard.cache.insert(path, Cached(std::move(resource))).resource;
+    }
+
+    void remember_failure(Shard &shard, const std::string &path, std::exception_ptr error) {
+        if (options_.negative_ttl <= Clock::duration::zero()) {
+            return;
+        }
+        const auto now = Clock::now();
+        // Bounded like the cache: drop expired entries, then everything
+        const std::size_t limit = std::max<std::size_t>(shard.capacity, 16);
+        if (shard.failures.size() >= limit) {
+            shard.failures.erase_if([&](const auto &f) { return f.second.expires <= now; });
+            if (shard.failures.size() >= limit) {
+                shard.failures.clear();
+            }
+        }
+        shard.failures.insert_or_assign(path, Failure{now + options_.negative_ttl, error});
+    }
+
+    // Second chance: referenced entries at the LRU end move to the front
+    // with the bit cleared; each hit buys at most one such pass
+    static void evict_one(Shard &shard) {
+        for (;;) {
+            const Cached &oldest = shard.cache.lru_value();
+            if (!oldest.referenced.load(std::memory_order_relaxed)) {
+                break;
+            }
+            oldest.referenced.store(false, std::memory_order_relaxed);
+            shard.cache.find(shard.cache.lru_key());
+        }
+        shard.cache.pop_lru();
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::size_t max_cache_size_;
+    Loader loader_;
+    ConcurrentResourceOptions options_;
+    std::vector<Shard> shards_;
+    int shard_shift_ = 64;
+    // Started on first async use; declared last so its queued jobs drain
+    // while the shards and loader still exist
+    std::once_flag scheduler_once_;
+    std::unique_ptr<LoadScheduler> scheduler_;
+};
+
+}  // namespace day1
@@ -0,0 +1,512 @@
+// day1/project/disk_cache.hpp
+// Persistent second-tier cache: an append-only log read through mmap
+//
+// Every restart used to re-run the loaders for the whole working set.
+// DiskCache keeps decoded resources on disk instead, and a
+// ResourceManager with it as its lower tier (disk_tier()) writes entries
+// there as they are evicted and reads them back on the next miss:
+//
+//     day1::DiskCache l2("cache/textures.l2", 1 << 30);
+//     textures.set_tier(day1::disk_tier<Texture>(l2));
+//     ...
+//     textures.spill_all();  // at shutdown: persist what is still resident
+//
+// The file is a log of records, each a header, the key and the data,
+// with the data 64-byte aligned. put() only appends; a key written again
+// points at its newest record and the old one becomes garbage, and erase()
+// appends a tombstone so a rescan does not bring the key back. Records
+// carry the size and modification time of the source they were made from
+// (SourceVersion); find() with a version skips records made from an older
+// source.
+//
+// The whole file is mapped read-only once, with room for max_bytes, so
+// find() returns a span straight into the page cache: no read() copy, and
+// a codec that views the bytes in place does no copy at all. Those spans
+// stay valid for the DiskCache's lifetime.
+//
+// flush() syncs the log and writes an index next to it (path + ".idx").
+// Opening with an index that matches the log skips the scan; otherwise
+// the log is scanned and a torn record at its end is dropped. The log does
+// not compact: once it reaches max_bytes, put() refuses new records.
+//
+// POSIX only (Linux and macOS). Not thread-safe.
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "flat_hash_map.hpp"
+#include "resource_manager.hpp"
+
+namespace day1 {
+
+namespace disk_detail {
+
+inline constexpr std::uint32_t kRecordMagic = 0x3252324c;     // "L2R2"
+inline constexpr std::uint32_t kTombstoneMagic = 0x5852324c;  // "L2RX", erases the key
+inline constexpr std::uint64_t kIndexMagic = 0x3258444932434c44;  // "DLC2IDX2"
+inline constexpr std::uint64_t kAlign = 64;
+
+struct RecordHeader {
+    std::uint32_t magic;
+    std::uint32_t key_size;
+    std::uint64_t data_size;
+    std::uint64_t source_size;
+    std::int64_t source_mtime_ns;
+    std::uint64_t check;  // over the sizes, the source version and the key
+};
+
+inline std::uint64_t align_up(std::uint64_t n) {
+    return (n + kAlign - 1) & ~(kAlign - 1);
+}
+
+inline std::uint64_t header_check(std::string_view key, std::uint64_t data_size,
+                                  std::uint64_t source_size, std::int64_t source_mtime_ns) {
+    const std::uint64_t source =
+        hash_detail::mix(source_size ^ static_cast<std::uint64_t>(source_mtime_ns));
+    return hash_detail::mix(string_hash{}(key) ^ (data_size * 0x9e3779b97f4a7c15ULL) ^
+                            key.size() ^ source);
+}
+
+inline std::uint64_t data_offset(std::uint64_t record, std::size_t key_size) {
+    return align_up(record + sizeof(RecordHeader) + key_size);
+}
+
+[[noreturn]] inline void throw_errno(const std::string &what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+inline void write_all(int fd, const void *data, std::size_t size, std::uint64_t offset) {
+    const auto *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        const ssize_t n = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("DiskCache: write failed");
+        }
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+        offset += static_cast<std::uint64_t>(n);
+    }
+}
+
+// Modification time in nanoseconds; Apple spells the field st_mtimespec
+inline std::int64_t mtime_ns(const struct stat &st) {
+#if defined(__APPLE__)
+    const timespec &mtime = st.st_mtimespec;
+#else
+    const timespec &mtime = st.st_mtim;
+#endif
+    return static_cast<std::int64_t>(mtime.tv_sec) * 1'000'000'000 + mtime.tv_nsec;
+}
+
+// Pushes the file's data to stable storage. Apple has no fdatasync(), and
+// its fsync() stops at the drive's write cache, so ask for F_FULLFSYNC and
+// fall back to fsync() on file systems that do not support it.
+inline int sync_data(int fd) {
+#if defined(__APPLE__)
+    if (::fcntl(fd, F_FULLFSYNC) == 0) {
+        return 0;
+    }
+    return ::fsync(fd);
+#else
+    return ::fdatasync(fd);
+#endif
+}
+
+}  // namespace disk_detail
+
+// The source file a record was made from, as stat() saw it. A source that
+// does not exist has the default version, so keys that are not file
+// paths always match.
+struct SourceVersion {
+    std::uint64_t size = 0;
+    std::int64_t mtime_ns = 0;
+
+    friend bool operator==(const SourceVersion &, const SourceVersion &) = default;
+};
+
+inline SourceVersion source_version(const std::string &path) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) {
+        return {};
+    }
+    return {static_cast<std::uint64_t>(st.st_size), disk_detail::mtime_ns(st)};
+}
+
+struct DiskCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;  // includes stale records
+    std::uint64_t stale = 0;   // records skipped because their source changed
+    std::uint64_t writes = 0;
+    std::uint64_t rejected = 0;  // put() calls refused because the log is full
+};
+
+class DiskCache {
+   public:
+    DiskCache(std::string path, std::size_t max_bytes)
+        : path_(std::move(path)), max_bytes_(disk_detail::align_up(max_bytes)) {
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            disk_detail::throw_errno("DiskCache: cannot open " + path_);
+        }
+        try {
+            struct stat st {};
+            if (::fstat(fd_, &st) != 0) {
+                disk_detail::throw_errno("DiskCache: cannot stat " + path_);
+            }
+            const auto file_size = static_cast<std::uint64_t>(st.st_size);
+            if (file_size > max_bytes_) {
+                max_bytes_ = disk_detail::align_up(file_size);
+            }
+            if (max_bytes_ > 0) {
+                void *base = ::mmap(nullptr, max_bytes_, PROT_READ, MAP_SHARED, fd_, 0);
+                if (base == MAP_FAILED) {
+                    disk_detail::throw_errno("DiskCache: cannot map " + path_);
+                }
+                base_ = static_cast<const std::byte *>(base);
+            }
+            if (!load_index(file_size)) {
+                scan(file_size);
+            }
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    DiskCache(const DiskCache &) = delete;
+    DiskCache &operator=(const DiskCache &) = delete;
+
+    ~DiskCache() {
+        try {
+            flush();
+        } catch (...) {
+            // The next open falls back to scanning the log
+        }
+        close();
+    }
+
+    // The stored bytes for key, mapped in place
+    std::optional<std::span<const std::byte>> find(std::string_view key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+        ++stats_.hits;
+        return std::span<const std::byte>(base_ + it->second.offset, it->second.size);
+    }
+
+    // Same, but only if the record was made from this version of its source
+    std::optional<std::span<const std::byte>> find(std::string_view key,
+                                                   const SourceVersion &source) {
+        auto it = index_.find(key);
+        if (it != index_.end() && it->second.source != source) {
+            ++stats_.stale;
+            ++stats_.misses;
+            return std::nullopt;
+        }
+        return find(key);
+    }
+
+    bool contains(std::string_view key) const {
+        return index_.contains(key);
+    }
+
+    // Whether key has a record made from this version of its source
+    bool contains(std::string_view key, const SourceVersion &source) const {
+        auto it = index_.find(key);
+        return it != index_.end() && it->second.source == source;
+    }
+
+    // Forgets key and appends a tombstone for it. If the log is full the
+    // tombstone is skipped: the next index still omits key, but a rescan
+    // after a crash may bring back its last record.
+    bool erase(std::string_view key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return false;
+        }
+        live_bytes_ -= it->second.size;
+        index_.erase(it);
+        index_dirty_ = true;
+        append(disk_detail::kTombstoneMagic, key, {}, {});
+        return true;
+    }
+
+    // Appends a record for key; false if the log has no room for it
+    bool put(std::string_view key, std::span<const std::byte> data,
+             const SourceVersion &source = {}) {
+        const std::optional<std::uint64_t> data_at =
+            append(disk_detail::kRecordMagic, key, data, source);
+        if (!data_at) {
+            ++stats_.rejected;
+            return false;
+        }
+        ++stats_.writes;
+        record(key, Extent{*data_at, data.size(), source});
+        return true;
+    }
+
+    // Makes the log durable and writes the index; a no-op when nothing
+    // was put since the last flush
+    void flush() {
+        if (!index_dirty_ || fd_ < 0) {
+            return;
+        }
+        if (disk_detail::sync_data(fd_) != 0) {
+            disk_detail::throw_errno("DiskCache: cannot sync " + path_);
+        }
+        const std::string index_path = path_ + ".idx";
+        const std::string tmp_path = index_path + ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            const std::uint64_t header[3] = {disk_detail::kIndexMagic, end_, index_.size()};
+            out.write(reinterpret_cast<const char *>(header), sizeof(header));
+            for (const auto &[key, extent] : index_) {
+                const std::uint64_t fields[5] = {
+                    extent.offset, extent.size, extent.source.size,
+                    static_cast<std::uint64_t>(extent.source.mtime_ns), key.size()};
+                out.write(reinterpret_cast<const char *>(fields), sizeof(fields));
+                out.write(key.data(), static_cast<std::streamsize>(key.size()));
+            }
+            if (!out) {
+                throw std::runtime_error("DiskCache: cannot write " + tmp_path);
+            }
+        }
+        std::filesystem::rename(tmp_path, index_path);
+        index_dirty_ = false;
+    }
+
+    std::size_t size() const {
+        return index_.size();
+    }
+    std::size_t max_bytes() const {
+        return max_bytes_;
+    }
+    // Bytes of the log, including records superseded by newer ones
+    std::size_t file_bytes() const {
+        return end_;
+    }
+    std::size_t live_bytes() const {
+        return live_bytes_;
+    }
+    // Whether opening used the index rather than scanning the log
+    bool opened_from_index() const {
+        return opened_from_index_;
+    }
+    const DiskCacheStats &stats() const {
+        return stats_;
+    }
+
+   private:
+    struct Extent {
+        std::uint64_t offset;
+        std::uint64_t size;
+        SourceVersion source;
+    };
+
+    // Writes a record at the end of the log; returns where its data starts,
+    // or nothing if it does not fit
+    std::optional<std::uint64_t> append(std::uint32_t magic, std::string_view key,
+                                        std::span<const std::byte> data,
+                                        const SourceVersion &source) {
+        const std::uint64_t at = end_;
+        const std::uint64_t data_at = disk_detail::data_offset(at, key.size());
+        const std::uint64_t next = disk_detail::align_up(data_at + data.size());
+        if (next > max_bytes_) {
+            return std::nullopt;
+        }
+        std::vector<char> head(data_at - at, 0);
+        const disk_detail::RecordHeader header{
+            magic,
+            static_cast<std::uint32_t>(key.size()),
+            data.size(),
+            source.size,
+            source.mtime_ns,
+            disk_detail::header_check(key, data.size(), source.size, source.mtime_ns)};
+        std::memcpy(head.data(), &header, sizeof(header));
+        std::memcpy(head.data() + sizeof(header), key.data(), key.size());
+        disk_detail::write_all(fd_, head.data(), head.size(), at);
+        disk_detail::write_all(fd_, data.data(), data.size(), data_at);
+        end_ = next;
+        index_dirty_ = true;
+        return data_at;
+    }
+
+    // Points key at its newest record
+    void record(std::string_view key, Extent extent) {
+        auto [it, inserted] = index_.try_emplace(std::string(key), extent);
+        if (!inserted) {
+            live_bytes_ -= it->second.size;
+            it->second = extent;
+        }
+        live_bytes_ += extent.size;
+    }
+
+    void close() {
+        if (base_) {
+            ::munmap(const_cast<std::byte *>(base_), max_bytes_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    // Trusts the index only if it describes exactly this log, and every
+    // extent and key length in it is in bounds; a damaged index is not an
+    // error, the caller scans the log instead
+    bool load_index(std::uint64_t file_size) {
+        std::error_code error;
+        const std::uint64_t index_size = std::filesystem::file_size(path_ + ".idx", error);
+        std::ifstream in(path_ + ".idx", std::ios::binary);
+        std::uint64_t header[3];
+        if (error || !in.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+            header[0] != disk_detail::kIndexMagic ||
+            header[1] != disk_detail::align_up(file_size)) {
+            return false;
+        }
+        flat_hash_map<std::string, Extent> index;
+        std::uint64_t live = 0;
+        std::uint64_t consumed = sizeof(header);
+        for (std::uint64_t i = 0; i < header[2]; ++i) {
+            std::uint64_t fields[5];
+            if (!in.read(reinterpret_cast<char *>(fields), sizeof(fields))) {
+                return false;
+            }
+            consumed += sizeof(fields);
+            // Written so that no sum can wrap around
+            if (fields[1] > file_size || fields[0] > file_size - fields[1] ||
+                fields[4] > index_size - consumed) {
+                return false;
+            }
+            consumed += fields[4];
+            std::string key(fields[4], '\0');
+            if (!in.read(key.data(), static_cast<std::streamsize>(key.size()))) {
+                return false;
+            }
+            index.insert_or_assign(
+                std::move(key),
+                Extent{fields[0], fields[1],
+                       SourceVersion{fields[2], static_cast<std::int64_t>(fields[3])}});
+            live += fields[1];
+        }
+        index_ = std::move(index);
+        live_bytes_ = live;
+        end_ = header[1];
+        opened_from_index_ = true;
+        return true;
+    }
+
+    // Rebuilds the index from the records; stops at the first one that is
+    // damaged or runs past the end of the file
+    void scan(std::uint64_t file_size) {
+        std::uint64_t offset = 0;
+        while (offset + sizeof(disk_detail::RecordHeader) <= file_size) {
+            disk_detail::RecordHeader header;
+            std::memcpy(&header, base_ + offset, sizeof(header));
+            const bool tombstone = header.magic == disk_detail::kTombstoneMagic;
+            if ((header.magic != disk_detail::kRecordMagic && !tombstone) ||
+                offset + sizeof(header) + header.key_size > file_size) {
+                break;
+            }
+            const auto *key_at = reinterpret_cast<const char *>(base_ + offset + sizeof(header));
+            const std::string_view key(key_at, header.key_size);
+            const std::uint64_t data_at = disk_detail::data_offset(offset, key.size());
+            if (header.check != disk_detail::header_check(key, header.data_size,
+                                                          header.source_size,
+                                                          header.source_mtime_ns) ||
+                data_at > file_size || header.data_size > file_size - data_at) {
+                break;
+            }
+            if (!tombstone) {
+                record(key, Extent{data_at, header.data_size,
+                                   SourceVersion{header.source_size, header.source_mtime_ns}});
+            } else if (auto it = index_.find(key); it != index_.end()) {
+                live_bytes_ -= it->second.size;
+                index_.erase(it);
+            }
+            offset = disk_detail::align_up(data_at + header.data_size);
+        }
+        end_ = offset;
+        if (end_ < file_size && ::ftruncate(fd_, static_cast<off_t>(end_)) != 0) {
+            disk_detail::throw_errno("DiskCache: cannot truncate " + path_);
+        }
+        index_dirty_ = true;
+    }
+
+    std::string path_;
+    std::uint64_t max_bytes_;
+    int fd_ = -1;
+    const std::byte *base_ = nullptr;
+    std::uint64_t end_ = 0;  // where the next record goes
+    std::uint64_t live_bytes_ = 0;
+    flat_hash_map<std::string, Extent> index_;
+    bool index_dirty_ = false;
+    bool opened_from_index_ = false;
+    DiskCacheStats stats_;
+};
+
+// How a Resource is stored in a DiskCache. Specialize with
+//
+//     static void encode(const Resource &, std::vector<std::byte> &out);
+//     static std::unique_ptr<Resource> decode(std::span<const std::byte>);
+//
+// decode()'s bytes stay mapped as long as the DiskCache exists, so a
+// resource may view them instead of copying.
+template <typename Resource>
+struct ResourceCodec;
+
+// A ResourceManager tier backed by cache. Records are stamped with the
+// source file's version when stored; fetch() ignores a record whose source
+// has changed since, and store() rewrites it. A source edited while its
+// resource is resident is stamped with the new version, so erase() the
+// path from the manager when it changes on disk. Storing is best effort:
+// a full log or a failed write leaves the resource unpersisted.
+template <typename Resource, typename Codec = ResourceCodec<Resource>>
+ResourceTier<Resource> disk_tier(DiskCache &cache) {
+    return {
+        [&cache](const std::string &path) -> std::unique_ptr<Resource> {
+            auto bytes = cache.find(path, source_version(path));
+            return bytes ? Codec::decode(*bytes) : nullptr;
+        },
+        [&cache](const std::string &path, const Resource &resource) {
+            const SourceVersion source = source_version(path);
+            if (cache.contains(path, source)) {
+                return;
+            }
+            std::vector<std::byte> bytes;
+            Codec::encode(resource, bytes);
+            try {
+                cache.put(path, bytes, source);
+            } catch (const std::system_error &) {
+                // Not persisted; the loader runs again next time
+            }
+        },
+    };
+}
+
+}  // namespace day1
@@ -0,0 +1,186 @@
+// day1/project/file_watcher.hpp
+// inotify-based file change notifications with per-file debouncing
+//
+// Cached resources never notice that their file changed. A FileWatcher
+// watches directories and calls back, on its own thread, with the path of
+// each file that was written, moved in or deleted:
+//
+//     day1::FileWatcher watcher([&](const std::string &path) { textures.reload(path); });
+//     watcher.watch("assets/textures");  // reports "assets/textures/<name>"
+//
+// Directories are watched rather than files because deploys usually
+// replace a file by renaming a new one over it, which a watch on the old
+// inode never reports. Reported paths are the watched directory as given
+// plus "/" and the file name, so they match cache keys only if those are
+// spelled the same way.
+//
+// A deploy writes a file in bursts (many writes, or write then rename), so
+// each file's events are debounced: the callback runs once the file has
+// been quiet for the debounce interval, however many events came before.
+// If the kernel's event queue overflows, the lost events are not recovered.
+//
+// Linux only. The callback runs on the watcher thread, one call at a time;
+// exceptions it throws are dropped.
+
+#pragma once
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "flat_hash_map.hpp"
+
+namespace day1 {
+
+struct FileWatcherStats {
+    std::uint64_t events = 0;         // inotify events for watched files
+    std::uint64_t notifications = 0;  // callback invocations
+};
+
+class FileWatcher {
+   public:
+    using Callback = std::function<void(const std::string &path)>;
+
+    explicit FileWatcher(Callback on_change,
+                         std::chrono::milliseconds debounce = std::chrono::milliseconds(50))
+        : on_change_(std::move(on_change)), debounce_(debounce) {
+        inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "inotify_init1");
+        }
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            const int error = errno;
+            ::close(inotify_fd_);
+            throw std::system_error(error, std::generic_category(), "eventfd");
+        }
+        try {
+            thread_ = std::thread([this] { run(); });
+        } catch (...) {
+            ::close(wake_fd_);
+            ::close(inotify_fd_);
+            throw;
+        }
+    }
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    // Stops without reporting changes still inside their debounce interval
+    ~FileWatcher() {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(wake_fd_, &one, sizeof(one));
+        thread_.join();
+        ::close(wake_fd_);
+        ::close(inotify_fd_);
+    }
+
+    // Reports changes to files directly inside directory
+    void watch(const std::string &directory) {
+        const int wd =
+            ::inotify_add_watch(inotify_fd_, directory.c_str(),
+                                IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+        if (wd < 0) {
+            throw std::system_error(errno, std::generic_category(), "watch " + directory);
+        }
+        std::lock_guard lock(mutex_);
+        directories_.insert_or_assign(wd, directory);
+    }
+
+    FileWatcherStats stats() const {
+        return {events_.load(std::memory_order_relaxed),
+                notifications_.load(std::memory_order_relaxed)};
+    }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    void run() {
+        flat_hash_map<std::string, Clock::time_point> pending;  // path -> quiet deadline
+        for (;;) {
+            int timeout = -1;
+            if (!pending.empty()) {
+                Clock::time_point next = Clock::time_point::max();
+                for (const auto &[path, deadline] : pending) {
+                    next = std::min(next, deadline);
+                }
+                const auto wait = std::chrono::ceil<std::chrono::milliseconds>(next - Clock::now());
+                timeout = static_cast<int>(std::max<std::int64_t>(0, wait.count()));
+            }
+            pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+            if (::poll(fds, 2, timeout) < 0 && errno != EINTR) {
+                return;
+            }
+            if (fds[1].revents & POLLIN) {
+                return;
+            }
+            if (fds[0].revents & POLLIN) {
+                read_events(pending);
+            }
+            const auto now = Clock::now();
+            std::vector<std::string> due;
+            for (const auto &[path, deadline] : pending) {
+                if (deadline <= now) {
+                    due.push_back(path);
+                }
+            }
+            for (const std::string &path : due) {
+                pending.erase(pending.find(path));
+                notifications_.fetch_add(1, std::memory_order_relaxed);
+                try {
+                    on_change_(path);
+                } catch (...) {
+                    // Keep watching
+                }
+            }
+        }
+    }
+
+    void read_events(flat_hash_map<std::string, Clock::time_point> &pending) {
+        alignas(inotify_event) char buffer[16 * 1024];
+        for (;;) {
+            const ssize_t n = ::read(inotify_fd_, buffer, sizeof(buffer));
+            if (n <= 0) {
+                return;  // EAGAIN: drained
+            }
+            const auto deadline = Clock::now() + debounce_;
+            std::lock_guard lock(mutex_);
+            for (ssize_t offset = 0; offset < n;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                auto dir = directories_.find(event->wd);
+                if (event->len == 0 || dir == directories_.end()) {
+                    continue;
+                }
+                events_.fetch_add(1, std::memory_order_relaxed);
+                pending.insert_or_assign(dir->second + "/" + event->name, deadline);
+            }
+        }
+    }
+
+    Callback on_change_;
+    std::chrono::milliseconds debounce_;
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;
+    std::mutex mutex_;  // guards directories_
+    flat_hash_map<int, std::string> directories_;
+    std::atomic<std::uint64_t> events_{0};
+    std::atomic<std::uint64_t> notifications_{0};
+    std::thread thread_;
+};
+
+}  // namespace day1
@@ -0,0 +1,175 @@
+// day1/project/load_scheduler.hpp
+// Bounded I/O worker pool with demand and prefetch priorities
+//
+// Resource loads block on disk, so they run on a small dedicated pool
+// rather than the CPU work-stealing pool. Jobs come in two priorities:
+//
+//   - demand: someone is waiting for the result. The demand queue is
+//     unbounded (callers are the bound) and always served first.
+//   - prefetch: speculative. The prefetch queue is bounded and submit()
+//     refuses new prefetches when it is full. At most half the workers
+//     (at least one) run prefetches at a time, so a demand load never
+//     waits behind a wall of prefetches.
+//
+// A queued prefetch that becomes needed can be promote()d to demand.
+// Destruction runs every job already queued, then joins the workers.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace day1 {
+
+enum class LoadPriority { demand, prefetch };
+
+class LoadScheduler {
+    struct Job {
+        std::function<void()> run;
+        LoadPriority priority;
+        bool started = false;
+    };
+
+   public:
+    // Identifies a submitted job, for promote()
+    using Ticket = std::shared_ptr<Job>;
+
+    LoadScheduler(std::size_t threads, std::size_t max_queued_prefetches)
+        : max_queued_prefetches_(max_queued_prefetches),
+          prefetch_limit_(std::max<std::size_t>(1, threads / 2)) {
+        threads = std::max<std::size_t>(1, threads);
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    LoadScheduler(const LoadScheduler &) = delete;
+    LoadScheduler &operator=(const LoadScheduler &) = delete;
+
+    ~LoadScheduler() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto &w : workers_) {
+            w.join();
+        }
+    }
+
+    // Queues run; nullptr if it is a prefetch and the prefetch queue is full
+    Ticket submit(LoadPriority priority, std::function<void()> run) {
+        auto job = std::make_shared<Job>(Job{std::move(run), priority});
+        {
+            std::lock_guard lock(mutex_);
+            if (priority == LoadPriority::prefetch) {
+                if (queued_prefetches_ >= max_queued_prefetches_) {
+                    return nullptr;
+                }
+                prefetch_.push_back(job);
+                ++queued_prefetches_;
+            } else {
+                demand_.push_back(job);
+            }
+        }
+        ready_.notify_one();
+        return job;
+    }
+
+    // Moves a still-queued prefetch to the demand queue
+    void promote(const Ticket &job) {
+        {
+            std::lock_guard lock(mutex_);
+            if (job->started || job->priority == LoadPriority::demand) {
+                return;
+            }
+            job->priority = LoadPriority::demand;
+            demand_.push_back(job);  // the prefetch queue entry is skipped later
+            --queued_prefetches_;
+        }
+        ready_.notify_one();
+    }
+
+    std::size_t thread_count() const {
+        return workers_.size();
+    }
+
+   private:
+    bool prefetch_allowed() const {
+        return stopping_ || running_prefetches_ < prefetch_limit_;
+    }
+
+    // Next job to run, or nullptr; drops stale entries on the way
+    Ticket pop() {
+        while (!demand_.empty()) {
+            Ticket job = std::move(demand_.front());
+            demand_.pop_front();
+            if (!job->started) {
+                return job;
+            }
+        }
+        while (!prefetch_.empty() && prefetch_allowed()) {
+            Ticket job = std::move(prefetch_.front());
+            prefetch_.pop_front();
+            if (!job->started && job->priority == LoadPriority::prefetch) {
+                --queued_prefetches_;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void work() {
+        for (;;) {
+            Ticket job;
+            {
+                std::unique_lock lock(mutex_);
+                ready_.wait(lock, [&] {
+                    return stopping_ || !demand_.empty() ||
+                           (!prefetch_.empty() && prefetch_allowed());
+                });
+                job = pop();
+                if (!job) {
+                    if (stopping_ && demand_.empty() && prefetch_.empty()) {
+                        return;
+                    }
+                    continue;
+                }
+                job->started = true;
+                if (job->priority == LoadPriority::prefetch) {
+                    ++running_prefetches_;
+                }
+            }
+            job->run();
+            if (job->priority == LoadPriority::prefetch) {
+                {
+                    std::lock_guard lock(mutex_);
+                    --running_prefetches_;
+                }
+                ready_.notify_one();
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Ticket> demand_;
+    std::deque<Ticket> prefetch_;
+    std::size_t queued_prefetches_ = 0;
+    std::size_t running_prefetches_ = 0;
+    std::size_t max_queued_prefetches_;
+    std::size_t prefetch_limit_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace day1
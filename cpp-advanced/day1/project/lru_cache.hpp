@@ -0,0 +1,283 @@
+// day1/project/lru_cache.hpp
+// String-keyed LRU index with O(1) lookup, promotion and eviction
+//
+// Finding the least recently used entry by scanning every entry's last
+// access time makes each eviction O(n). Here entries are kept in recency
+// order instead, on a doubly-linked list threaded through the entries by
+// index, and a flat hash map finds an entry by key:
+//
+//   - a hit unlinks the entry and relinks it at the front (most recent)
+//   - the least recently used entry is always the list tail
+//
+// Entries live in fixed-size chunks that never move, so the hash map keys
+// are string_views into the entries' own key strings and each key is
+// stored once. Slots of erased entries are reused through a free list.
+//
+// SegmentedLru is the same structure with several lists over one index,
+// for policies that move entries between segments (cache_policy.hpp).
+// LruCache is the single-list case; it only orders entries and the owner
+// decides when to evict. Value must be default constructible and movable.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "flat_hash_map.hpp"
+
+namespace day1 {
+
+template <typename Value, std::size_t Segments>
+class SegmentedLru {
+   public:
+    using Slot = std::uint32_t;
+    static constexpr Slot npos = ~Slot{0};
+
+    SegmentedLru() {
+        clear_lists();
+    }
+    SegmentedLru(const SegmentedLru &) = delete;
+    SegmentedLru &operator=(const SegmentedLru &) = delete;
+
+    std::size_t size() const noexcept {
+        return index_.size();
+    }
+    std::size_t size(std::size_t segment) const noexcept {
+        return lists_[segment].size;
+    }
+
+    // Slot holding key, or npos; does not touch recency
+    Slot find(std::string_view key) const {
+        auto it = index_.find(key);
+        return it == index_.end() ? npos : it->second;
+    }
+
+    const std::string &key(Slot slot) const {
+        return entry(slot).key;
+    }
+    Value &value(Slot slot) {
+        return entry(slot).value;
+    }
+    const Value &value(Slot slot) const {
+        return entry(slot).value;
+    }
+    std::size_t segment(Slot slot) const {
+        return entry(slot).segment;
+    }
+
+    // Least recently used slot of segment, or npos if it is empty
+    Slot lru(std::size_t segment) const {
+        return lists_[segment].tail;
+    }
+
+    // Adds key at the front of segment. Requires that key is absent.
+    Slot insert(std::string key, Value value, std::size_t segment) {
+        const Slot slot = allocate_slot();
+        Entry &e = entry(slot);
+        e.key = std::move(key);
+        e.value = std::move(value);
+        try {
+            index_.try_emplace(std::string_view(e.key), slot);
+        } catch (...) {
+            release_slot(slot);
+            throw;
+        }
+        link_front(slot, segment);
+        return slot;
+    }
+
+    // Makes slot the most recent entry of segment, which may be a
+    // different segment from its current one
+    void move_to_front(Slot slot, std::size_t segment) {
+        if (slot != lists_[segment].head) {
+            unlink(slot);
+            link_front(slot, segment);
+        }
+    }
+
+    std::pair<std::string, Value> remove(Slot slot) {
+        Entry &e = entry(slot);
+        index_.erase(std::string_view(e.key));
+        unlink(slot);
+        std::pair<std::string, Value> removed(std::move(e.key), std::move(e.value));
+        release_slot(slot);
+        return removed;
+    }
+
+    void clear() {
+        index_.clear();
+        chunks_.clear();
+        used_ = 0;
+        free_ = npos;
+        clear_lists();
+    }
+
+   private:
+    static constexpr std::size_t kChunkShift = 10;
+    static constexpr std::size_t kChunkSize = std::size_t{1} << kChunkShift;
+
+    struct Entry {
+        std::string key;
+        Value value{};
+        Slot prev = npos;
+        Slot next = npos;  // also chains free slots
+        std::uint32_t segment = 0;
+    };
+
+    struct List {
+        Slot head;  // most recently used
+        Slot tail;  // least recently used
+        std::size_t size;
+    };
+
+    Entry &entry(Slot slot) {
+        return chunks_[slot >> kChunkShift][slot & (kChunkSize - 1)];
+    }
+    const Entry &entry(Slot slot) const {
+        return chunks_[slot >> kChunkShift][slot & (kChunkSize - 1)];
+    }
+
+    void clear_lists() {
+        lists_.fill(List{npos, npos, 0});
+    }
+
+    Slot allocate_slot() {
+        if (free_ != npos) {
+            const Slot slot = free_;
+            free_ = entry(slot).next;
+            return slot;
+        }
+        if (used_ == chunks_.size() * kChunkSize) {
+            chunks_.push_back(std::make_unique<Entry[]>(kChunkSize));
+        }
+        return static_cast<Slot>(used_++);
+    }
+
+    // Drops the slot's contents now rather than when it is next reused
+    void release_slot(Slot slot) {
+        Entry &e = entry(slot);
+        e.key = std::string();
+        e.value = Value{};
+        e.next = free_;
+        free_ = slot;
+    }
+
+    void link_front(Slot slot, std::size_t segment) {
+        List &list = lists_[segment];
+        Entry &e = entry(slot);
+        e.segment = static_cast<std::uint32_t>(segment);
+        e.prev = npos;
+        e.next = list.head;
+        if (list.head != npos) {
+            entry(list.head).prev = slot;
+        } else {
+            list.tail = slot;
+        }
+        list.head = slot;
+        ++list.size;
+    }
+
+    void unlink(Slot slot) {
+        Entry &e = entry(slot);
+        List &list = lists_[e.segment];
+        (e.prev != npos ? entry(e.prev).next : list.head) = e.next;
+        (e.next != npos ? entry(e.next).prev : list.tail) = e.prev;
+        --list.size;
+    }
+
+    flat_hash_map<std::string_view, Slot> index_;
+    std::vector<std::unique_ptr<Entry[]>> chunks_;
+    std::size_t used_ = 0;
+    Slot free_ = npos;
+    std::array<List, Segments> lists_;
+};
+
+template <typename Value>
+class LruCache {
+   public:
+    LruCache() = default;
+    LruCache(const LruCache &) = delete;
+    LruCache &operator=(const LruCache &) = delete;
+
+    std::size_t size() const noexcept {
+        return lists_.size();
+    }
+    bool empty() const noexcept {
+        return lists_.size() == 0;
+    }
+
+    // Marks key as most recently used; nullptr if absent
+    Value *find(std::string_view key) {
+        const Slot slot = lists_.find(key);
+        if (slot == Lists::npos) {
+            return nullptr;
+        }
+        lists_.move_to_front(slot, 0);
+        return &lists_.value(slot);
+    }
+
+    // Lookup without touching recency
+    Value *peek(std::string_view key) {
+        const Slot slot = lists_.find(key);
+        return slot == Lists::npos ? nullptr : &lists_.value(slot);
+    }
+    const Value *peek(std::string_view key) const {
+        const Slot slot = lists_.find(key);
+        return slot == Lists::npos ? nullptr : &lists_.value(slot);
+    }
+
+    bool contains(std::string_view key) const {
+        return lists_.find(key) != Lists::npos;
+    }
+
+    // Adds key as most recently used. Requires that key is absent.
+    Value &insert(std::string key, Value value) {
+        return lists_.value(lists_.insert(std::move(key), std::move(value), 0));
+    }
+
+    bool erase(std::string_view key) {
+        const Slot slot = lists_.find(key);
+        if (slot == Lists::npos) {
+            return false;
+        }
+        lists_.remove(slot);
+        return true;
+    }
+
+    // Key of the least recently used entry. Requires !empty().
+    const std::string &lru_key() const {
+        return lists_.key(lists_.lru(0));
+    }
+
+    // Value of the least recently used entry, without touching recency.
+    // Requires !empty().
+    Value &lru_value() {
+        return lists_.value(lists_.lru(0));
+    }
+    const Value &lru_value() const {
+        return lists_.value(lists_.lru(0));
+    }
+
+    // Removes and returns the least recently used entry. Requires !empty().
+    std::pair<std::string, Value> pop_lru() {
+        return lists_.remove(lists_.lru(0));
+    }
+
+    void clear() {
+        lists_.clear();
+    }
+
+   private:
+    using Lists = SegmentedLru<Value, 1>;
+    using Slot = typename Lists::Slot;
+
+    Lists lists_;
+};
+
+}  // namespace day1
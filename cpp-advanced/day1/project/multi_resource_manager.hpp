@@ -0,0 +1,122 @@
+// day1/project/multi_resource_manager.hpp
+// One cache per resource type, chosen at compile time from a type list
+//
+// Storing every resource as std::variant<Texture, Sound> makes each entry
+// as large as the largest alternative, and get<T>() checks the variant's
+// index on every access. MultiResourceManager keeps one ResourceManager
+// per type instead, in a tuple, so get<T>() resolves to T's cache during
+// compilation and returns a plain std::shared_ptr<T>:
+//
+//     day1::MultiResourceManager<Texture, Sound> assets(
+//         64 << 20,                                               // total bytes
+//         {.limits = {.max_bytes = 48 << 20}, .loader = load_texture},
+//         {.limits = {.max_bytes = 24 << 20}, .loader = load_sound});
+//     std::shared_ptr<Texture> wall = assets.get<Texture>("wall.png");
+//
+// Each type has its own limits and eviction order; all of them share one
+// ResourceBudget (resource_budget.hpp), so the total stays under its cap
+// and room is taken from whichever type was used least recently. Asking
+// for a type that is not in the list does not compile.
+//
+// Not thread-safe, like ResourceManager.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "resource_budget.hpp"
+#include "resource_manager.hpp"
+
+namespace day1 {
+
+template <typename Resource>
+struct ResourceConfig {
+    // shared is set by MultiResourceManager
+    ResourceLimits limits{};
+    typename ResourceManager<Resource>::Loader loader;
+    typename ResourceManager<Resource>::Sizer sizer = ResourceCost<Resource>{};
+};
+
+template <typename... Resources>
+class MultiResourceManager {
+   public:
+    explicit MultiResourceManager(std::size_t max_bytes, ResourceConfig<Resources>... configs)
+        : budget_(max_bytes), pools_(share(std::move(configs))...) {}
+
+    MultiResourceManager(const MultiResourceManager &) = delete;
+    MultiResourceManager &operator=(const MultiResourceManager &) = delete;
+
+    template <typename Resource>
+    std::shared_ptr<Resource> get(const std::string &path) {
+        return manager<Resource>().get(path);
+    }
+
+    template <typename Resource>
+    bool contains(std::string_view path) const {
+        return manager<Resource>().contains(path);
+    }
+
+    template <typename Resource>
+    ResourceManager<Resource> &manager() {
+        return std::get<Pool<Resource>>(pools_).manager;
+    }
+    template <typename Resource>
+    const ResourceManager<Resource> &manager() const {
+        return std::get<Pool<Resource>>(pools_).manager;
+    }
+
+    void clear() {
+        (manager<Resources>().clear(), ...);
+    }
+
+    std::size_t size() const {
+        return (manager<Resources>().size() + ...);
+    }
+    std::size_t resident_bytes() const {
+        return budget_.resident_bytes();
+    }
+    const ResourceBudget &budget() const {
+        return budget_;
+    }
+
+    // Summed over types
+    CacheStats stats() const {
+        CacheStats total;
+        (add(total, manager<Resources>().stats()), ...);
+        return total;
+    }
+
+   private:
+    template <typename Resource>
+    struct Pool {
+        explicit Pool(ResourceConfig<Resource> config)
+            : manager(config.limits, std::move(config.loader), std::move(config.sizer)) {}
+
+        ResourceManager<Resource> manager;
+    };
+
+    template <typename Resource>
+    ResourceConfig<Resource> share(ResourceConfig<Resource> config) {
+        config.limits.shared = &budget_;
+        return config;
+    }
+
+    static void add(CacheStats &total, const CacheStats &part) {
+        total.hits += part.hits;
+        total.misses += part.misses;
+        total.evictions += part.evictions;
+        total.resident_bytes += part.resident_bytes;
+        total.tier_hits += part.tier_hits;
+    }
+
+    // Declared first: the pools leave the budget when they are destroyed
+    ResourceBudget budget_;
+    std::tuple<Pool<Resources>...> pools_;
+};
+
+}  // namespace day1
@@ -0,0 +1,109 @@
+// day1/project/resource_budget.hpp
+// Memory budget shared by several resource caches
+//
+// Each ResourceManager can cap its own bytes (a per-type sub-budget: say
+// 48MB of textures, 8MB of sounds). A ResourceBudget caps their sum. When
+// a cache needs room under the shared cap, make_room() evicts the least
+// recently used of the members' next victims, whatever their type, so
+// one type's burst can take memory another type has not touched lately.
+//
+// Recency has to be comparable across caches, so members stamp their
+// entries from the budget's shared clock (next_tick()).
+//
+// Not thread-safe, like ResourceManager: keep a budget and its members on
+// one thread. Members must leave() before the budget is destroyed.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace day1 {
+
+class ResourceBudget {
+   public:
+    // How a member cache takes part in cross-cache eviction
+    struct Member {
+        // Last-use tick of the entry the member would evict next; empty
+        // when the member holds nothing
+        std::function<std::optional<std::uint64_t>()> victim_tick;
+        // Evicts that entry; the member release()s its bytes
+        std::function<void()> evict;
+    };
+
+    explicit ResourceBudget(std::size_t max_bytes) : max_bytes_(max_bytes) {}
+
+    ResourceBudget(const ResourceBudget &) = delete;
+    ResourceBudget &operator=(const ResourceBudget &) = delete;
+
+    std::size_t max_bytes() const {
+        return max_bytes_;
+    }
+    std::size_t resident_bytes() const {
+        return resident_bytes_;
+    }
+    // Entries evicted to stay under max_bytes (members' own limits excluded)
+    std::uint64_t evictions() const {
+        return evictions_;
+    }
+
+    std::uint64_t next_tick() {
+        return ++clock_;
+    }
+
+    // Returns an id for leave()
+    std::size_t join(Member member) {
+        members_.emplace_back(next_id_, std::move(member));
+        return next_id_++;
+    }
+
+    void leave(std::size_t id) {
+        std::erase_if(members_, [id](const auto &m) { return m.first == id; });
+    }
+
+    // Evicts the members' least recently used victims until bytes more
+    // fit; false if bytes exceeds max_bytes or nothing is left to evict
+    bool make_room(std::size_t bytes) {
+        if (bytes > max_bytes_) {
+            return false;
+        }
+        while (resident_bytes_ + bytes > max_bytes_) {
+            Member *victim = nullptr;
+            std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+            for (auto &[id, member] : members_) {
+                if (auto tick = member.victim_tick(); tick && *tick < oldest) {
+                    oldest = *tick;
+                    victim = &member;
+                }
+            }
+            if (!victim) {
+                return false;
+            }
+            victim->evict();
+            ++evictions_;
+        }
+        return true;
+    }
+
+    void charge(std::size_t bytes) {
+        resident_bytes_ += bytes;
+    }
+    void release(std::size_t bytes) {
+        resident_bytes_ -= bytes;
+    }
+
+   private:
+    std::size_t max_bytes_;
+    std::size_t resident_bytes_ = 0;
+    std::uint64_t evictions_ = 0;
+    std::uint64_t clock_ = 0;
+    std::size_t next_id_ = 0;
+    std::vector<std::pair<std::size_t, Member>> members_;
+};
+
+}  // namespace day1
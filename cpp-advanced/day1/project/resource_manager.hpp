@@ -0,0 +1,285 @@
+// day1/project/resource_manager.hpp
+// Path-keyed resource cache with least-recently-used eviction
+//
+//     day1::ResourceManager<Texture> textures(64, [](const std::string &path) {
+//         return std::make_unique<Texture>(path);
+//     });
+//     std::shared_ptr<Texture> t = textures.get("assets/wall.png");
+//
+// get() returns the cached resource or calls the loader; once max_size
+// resources are cached, a miss evicts the least recently used one. Hits,
+// promotion and eviction are all O(1) (see lru_cache.hpp). Evicted
+// resources stay alive for as long as callers hold their shared_ptr.
+//
+// An entry count says little about memory when one texture is 4MB and one
+// sound 176KB, so the cache can also be limited in bytes:
+//
+//     day1::ResourceBudget budget(64 << 20);
+//     day1::ResourceManager<Texture> textures({.max_bytes = 48 << 20, .shared = &budget},
+//                                             load_texture);
+//
+// Each entry's cost comes from ResourceCost<Resource> (byte_size() if the
+// resource has one, else sizeof) or a custom sizer. Eviction keeps the
+// manager under its own max_bytes and, when it shares a ResourceBudget
+// with managers of other types, the total under the budget's cap. A
+// resource larger than either limit is returned but not cached.
+//
+// Which entry goes is up to the Policy parameter: LRU by default, or a
+// scan-resistant policy from cache_policy.hpp:
+//
+//     day1::ResourceManager<Texture, day1::WTinyLfuPolicy> textures(64, load_texture);
+//
+// Not thread-safe: one manager per thread, or external locking.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "cache_policy.hpp"
+#include "resource_budget.hpp"
+
+namespace day1 {
+
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    // Bytes of cached entries by their sizer; 0 where bytes are not tracked
+    std::uint64_t resident_bytes = 0;
+    // Misses served by the lower tier instead of the loader
+    std::uint64_t tier_hits = 0;
+
+    double hit_ratio() const {
+        const std::uint64_t lookups = hits + misses;
+        return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
+};
+
+// Bytes a cached Resource accounts for. Specialize for types whose heap
+// usage byte_size() does not report.
+template <typename Resource>
+struct ResourceCost {
+    std::size_t operator()(const Resource &resource) const {
+        if constexpr (requires {
+                          { resource.byte_size() } -> std::convertible_to<std::size_t>;
+                      }) {
+            return resource.byte_size();
+        } else {
+            return sizeof(Resource);
+        }
+    }
+};
+
+// Storage below the in-memory cache, e.g. a DiskCache (disk_cache.hpp):
+// misses try fetch() before the loader, and evicted entries go to store()
+template <typename Resource>
+struct ResourceTier {
+    std::function<std::unique_ptr<Resource>(const std::string &)> fetch;
+    std::function<void(const std::string &, const Resource &)> store;
+};
+
+struct ResourceLimits {
+    std::size_t max_entries = std::numeric_limits<std::size_t>::max();
+    std::size_t max_bytes = std::numeric_limits<std::size_t>::max();
+    // Cap shared with other managers; must outlive this one
+    ResourceBudget *shared = nullptr;
+};
+
+template <typename Resource, template <typename> class Policy = LruPolicy>
+class ResourceManager {
+   public:
+    using Loader = std::function<std::unique_ptr<Resource>(const std::string &)>;
+    using Sizer = std::function<std::size_t(const Resource &)>;
+
+    ResourceManager(std::size_t max_size, Loader loader)
+        : ResourceManager(ResourceLimits{.max_entries = max_size}, std::move(loader)) {}
+
+    ResourceManager(ResourceLimits limits, Loader loader, Sizer sizer = ResourceCost<Resource>{})
+        : limits_(limits), loader_(std::move(loader)), sizer_(std::move(sizer)) {
+        if (!loader_) {
+            throw std::invalid_argument("ResourceManager: loader is empty");
+        }
+        if (!sizer_) {
+            throw std::invalid_argument("ResourceManager: sizer is empty");
+        }
+        if (limits_.shared) {
+            membership_ = limits_.shared->join({
+                [this]() -> std::optional<std::uint64_t> {
+                    if (cache_.empty()) {
+                        return std::nullopt;
+                    }
+                    return cache_.victim().tick;
+                },
+                [this] { evict_for_budget(); },
+            });
+        }
+    }
+
+    ResourceManager(const ResourceManager &) = delete;
+    ResourceManager &operator=(const ResourceManager &) = delete;
+
+    ~ResourceManager() {
+        if (limits_.shared) {
+            limits_.shared->leave(membership_);
+            limits_.shared->release(stats_.resident_bytes);
+        }
+    }
+
+    // Cached resource for path, loading it on a miss; nullptr if the loader
+    // returns nullptr. A throwing loader leaves the cache unchanged.
+    std::shared_ptr<Resource> get(const std::string &path) {
+        if (Entry *cached = cache_.find(path)) {
+            ++stats_.hits;
+            cached->tick = next_tick();
+            return cached->resource;
+        }
+        ++stats_.misses;
+        cache_.record_miss(path);
+        // Load before evicting so a failed load costs no cached entry
+        std::shared_ptr<Resource> resource = load(path);
+        if (!resource) {
+            return resource;
+        }
+        const std::size_t bytes = sizer_(*resource);
+        if (!fits(bytes)) {
+            return resource;
+        }
+        while (cache_.size() >= limits_.max_entries ||
+               stats_.resident_bytes + bytes > limits_.max_bytes) {
+            evict_one();
+            ++stats_.evictions;
+        }
+        if (limits_.shared && !limits_.shared->make_room(bytes)) {
+            return resource;
+        }
+        Entry &entry = cache_.insert(path, Entry{std::move(resource), bytes, next_tick()});
+        charge(bytes);
+        return entry.resource;
+    }
+
+    bool contains(std::string_view path) const {
+        return cache_.contains(path);
+    }
+
+    // Drops path from the cache; true if it was cached
+    bool erase(std::string_view path) {
+        const Entry *cached = cache_.peek(path);
+        if (!cached) {
+            return false;
+        }
+        release(cached->bytes);
+        return cache_.erase(path);
+    }
+
+    void clear() {
+        release(stats_.resident_bytes);
+        cache_.clear();
+    }
+
+    // Evicted entries are stored in tier from now on; an empty tier
+    // detaches it
+    void set_tier(ResourceTier<Resource> tier) {
+        tier_ = std::move(tier);
+    }
+
+    // Evicts every entry into the tier, e.g. before shutdown so the next
+    // run finds the whole working set there
+    void spill_all() {
+        while (!cache_.empty()) {
+            evict_one();
+        }
+    }
+
+    std::size_t size() const {
+        return cache_.size();
+    }
+    std::size_t max_size() const {
+        return limits_.max_entries;
+    }
+    std::size_t max_bytes() const {
+        return limits_.max_bytes;
+    }
+    std::size_t resident_bytes() const {
+        return stats_.resident_bytes;
+    }
+    // evictions counts entries dropped for any limit, including ones the
+    // shared budget took for another manager
+    const CacheStats &stats() const {
+        return stats_;
+    }
+
+   private:
+    struct Entry {
+        std::shared_ptr<Resource> resource;
+        std::size_t bytes = 0;
+        std::uint64_t tick = 0;  // last use, on the shared budget's clock if any
+    };
+
+    bool fits(std::size_t bytes) const {
+        return limits_.max_entries > 0 && bytes <= limits_.max_bytes &&
+               (!limits_.shared || bytes <= limits_.shared->max_bytes());
+    }
+
+    std::uint64_t next_tick() {
+        return limits_.shared ? limits_.shared->next_tick() : ++clock_;
+    }
+
+    std::shared_ptr<Resource> load(const std::string &path) {
+        if (tier_.fetch) {
+            if (std::shared_ptr<Resource> stored = tier_.fetch(path)) {
+                ++stats_.tier_hits;
+                return stored;
+            }
+        }
+        return loader_(path);
+    }
+
+    void evict_one() {
+        auto [path, entry] = cache_.evict();
+        release(entry.bytes);
+        if (tier_.store) {
+            tier_.store(path, *entry.resource);
+        }
+    }
+
+    // Called by the shared budget when it needs room for any member
+    void evict_for_budget() {
+        evict_one();
+        ++stats_.evictions;
+    }
+
+    void charge(std::size_t bytes) {
+        stats_.resident_bytes += bytes;
+        if (limits_.shared) {
+            limits_.shared->charge(bytes);
+        }
+    }
+
+    void release(std::size_t bytes) {
+        stats_.resident_bytes -= bytes;
+        if (limits_.shared) {
+            limits_.shared->release(bytes);
+        }
+    }
+
+    ResourceLimits limits_;
+    Loader loader_;
+    Sizer sizer_;
+    ResourceTier<Resource> tier_;
+    Policy<Entry> cache_;
+    CacheStats stats_;
+    std::uint64_t clock_ = 0;
+    std::size_t membership_ = 0;
+};
+
+}  // namespace day1
@@ -1,7 +1,265 @@
+// day1/project/resource_manager_project.cpp
+// Evening Project: Resource Manager
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/timer.hpp"
+#include "concurrent_resource_manager.hpp"
+#include "multi_resource_manager.hpp"
+#include "streaming_loader.hpp"
+
+// =============================================================================
+// Example resources
+// =============================================================================
+
+struct Rgba8 {
+    std::uint8_t r, g, b, a;
+};
+
+// On-disk layouts of the streamed formats: the header, then RGB8 rows
+// top to bottom, or mono 16-bit samples
+struct TextureHeader {
+    static constexpr std::uint32_t kMagic = 0x31584554;  // "TEX1"
+    std::uint32_t magic, width, height, reserved;
+};
+
+struct SoundHeader {
+    static constexpr std::uint32_t kMagic = 0x31444e53;  // "SND1"
+    std::uint32_t magic, sample_rate;
+    std::uint64_t samples;
+};
+
+struct Texture {
+    day1::StreamedBuffer<Rgba8> pixels;
+    int width, height;
+
+    explicit Texture(const std::string &path) {
+        // Simulate loading
+        std::cout << "Loading texture: " << path << "\n";
+        width = 1024;
+        height = 1024;
+        pixels = day1::StreamedBuffer<Rgba8>(static_cast<std::size_t>(width) * height);
+    }
+
+    Texture(int w, int h, day1::StreamedBuffer<Rgba8> streamed)
+        : pixels(std::move(streamed)), width(w), height(h) {}
+
+    // Returns as soon as the file's header is read; rows arrive on io
+    static std::unique_ptr<Texture> stream(day1::LoadScheduler &io, const std::string &path,
+                                           day1::StreamOptions options = {}) {
+        const auto header = day1::read_header<TextureHeader>(path);
+        if (header.magic != TextureHeader::kMagic) {
+            throw std::runtime_error("not a texture: " + path);
+        }
+        auto expand = [](std::span<const std::byte> rgb, std::span<Rgba8> out) {
+            for (std::size_t i = 0; i < out.size(); ++i) {
+                out[i] = {std::to_integer<std::uint8_t>(rgb[3 * i]),
+                          std::to_integer<std::uint8_t>(rgb[3 * i + 1]),
+                          std::to_integer<std::uint8_t>(rgb[3 * i + 2]), 255};
+            }
+        };
+        auto pixels = day1::stream_file<Rgba8>(
+            io, path,
+            {.offset = sizeof(header),
+             .count = std::size_t{header.width} * header.height,
+             .encoded_size = 3,
+             .decode = expand},
+            options);
+        return std::make_unique<Texture>(static_cast<int>(header.width),
+                                         static_cast<int>(header.height), std::move(pixels));
+    }
+
+    int rows_ready() const {
+        return static_cast<int>(pixels.ready() / width);
+    }
+
+    std::size_t byte_size() const {
+        return sizeof(*this) + pixels.size() * sizeof(Rgba8);
+    }
+};
+
+struct Sound {
+    day1::StreamedBuffer<std::int16_t> samples;
+    int sample_rate;
+
+    explicit Sound(const std::string &path) {
+        std::cout << "Loading sound: " << path << "\n";
+        sample_rate = 44100;
+        samples = day1::StreamedBuffer<std::int16_t>(static_cast<std::size_t>(sample_rate) * 2);
+    }
+
+    Sound(int rate, day1::StreamedBuffer<std::int16_t> streamed)
+        : samples(std::move(streamed)), sample_rate(rate) {}
+
+    // Returns as soon as the file's header is read; samples arrive on io
+    static std::unique_ptr<Sound> stream(day1::LoadScheduler &io, const std::string &path,
+                                         day1::StreamOptions options = {}) {
+        const auto header = day1::read_header<SoundHeader>(path);
+        if (header.magic != SoundHeader::kMagic) {
+            throw std::runtime_error("not a sound: " + path);
+        }
+        auto samples = day1::stream_file<std::int16_t>(
+            io, path, {.offset = sizeof(header), .count = header.samples}, options);
+        return std::make_unique<Sound>(static_cast<int>(header.sample_rate), std::move(samples));
+    }
+
+    std::size_t byte_size() const {
+        return sizeof(*this) + samples.size() * sizeof(std::int16_t);
+    }
+};
+
+// Demo files for the streaming loaders
+void write_demo_sound(const std::string &path, std::uint32_t rate, std::uint32_t seconds) {
+    const SoundHeader header{SoundHeader::kMagic, rate, std::uint64_t{rate} * seconds};
+    std::vector<std::int16_t> samples(header.samples);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<std::int16_t>((i * 440 % rate) * 65535 / rate - 32768);
+    }
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(samples.data()),
+              static_cast<std::streamsize>(samples.size() * sizeof(std::int16_t)));
+}
+
+void write_demo_texture(const std::string &path, std::uint32_t width, std::uint32_t height) {
+    const TextureHeader header{TextureHeader::kMagic, width, height, 0};
+    std::vector<std::uint8_t> rgb(std::size_t{width} * height * 3);
+    for (std::size_t i = 0; i < rgb.size(); ++i) {
+        rgb[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+}
+
+// =============================================================================
+// Loaders
+// =============================================================================
+
+std::unique_ptr<Texture> load_texture(const std::string &path) {
+    return std::make_unique<Texture>(path);
+}
+
+std::unique_ptr<Sound> load_sound(const std::string &path) {
+    return std::make_unique<Sound>(path);
+}
 
 int main() {
-    std::cout << "Hello from Day 1 - Resource Manager Project!\n";
-    std::cout << "This is a placeholder for the evening project.\n";
+    std::cout << "Day 1 Evening Project: Resource Manager\n";
+    std::cout << "=======================================\n";
+
+    // One cache per type: at most two textures, any number of sounds
+    day1::MultiResourceManager<Texture, Sound> manager(
+        std::numeric_limits<std::size_t>::max(),
+        {.limits = {.max_entries = 2}, .loader = load_texture}, {.loader = load_sound});
+
+    auto tex1 = manager.get<Texture>("image1.png");
+    auto tex2 = manager.get<Texture>("image2.png");
+    auto sound1 = manager.get<Sound>("sound1.wav");
+
+    // Touch image1 so image2 becomes the least recently used texture
+    auto tex1_hit = manager.get<Texture>("image1.png");
+
+    // Texture cache is full: this evicts image2
+    auto tex3 = manager.get<Texture>("image3.png");
+
+    // image1 is still cached; image2 has to be loaded again
+    auto tex1_again = manager.get<Texture>("image1.png");
+    auto tex2_again = manager.get<Texture>("image2.png");
+
+    const auto stats = manager.stats();
+    std::cout << "hits: " << stats.hits << ", misses: " << stats.misses
+              << ", evictions: " << stats.evictions << "\n";
+    std::cout << "Same texture object on hit: " << std::boolalpha << (tex1 == tex1_again) << "\n";
+    std::cout << "Resident: " << stats.resident_bytes / 1024 << " KB\n";
+
+    // Byte budgets: 10MB in total, at most 9MB of it textures (two). Loading a
+    // third texture evicts the least recently used one; loading sounds
+    // past the total evicts whichever entry of either type is oldest.
+    day1::MultiResourceManager<Texture, Sound> budgeted(
+        10 << 20, {.limits = {.max_bytes = 9 << 20}, .loader = load_texture},
+        {.limits = {.max_bytes = 4 << 20}, .loader = load_sound});
+    for (const char *path : {"wall.png", "floor.png", "sky.png"}) {
+        budgeted.get<Texture>(path);
+    }
+    for (int i = 0; i < 12; ++i) {
+        budgeted.get<Sound>("sfx/hit" + std::to_string(i) + ".wav");
+    }
+    const auto &textures = budgeted.manager<Texture>();
+    const auto &effects = budgeted.manager<Sound>();
+    const auto &budget = budgeted.budget();
+    std::cout << "Budget: " << budget.resident_bytes() / 1024 << " / " << budget.max_bytes() / 1024
+              << " KB resident; textures " << textures.size() << " ("
+              << textures.resident_bytes() / 1024 << " KB), sounds " << effects.size() << " ("
+              << effects.resident_bytes() / 1024 << " KB), " << budget.evictions()
+              << " cross-type evictions\n";
+
+    // Shared between threads: each path hashes to one of several
+    // independently locked shards
+    day1::ConcurrentResourceManager<Sound> sounds(16, load_sound);
+    std::vector<std::thread> players;
+    for (int t = 0; t < 4; ++t) {
+        players.emplace_back([&sounds, t] {
+            for (int i = 0; i < 100; ++i) {
+                sounds.get("sfx/step" + std::to_string((t + i) % 4) + ".wav");
+            }
+        });
+    }
+    for (auto &p : players) {
+        p.join();
+    }
+    const auto sound_stats = sounds.stats();
+    std::cout << "Concurrent sounds: " << sounds.size() << " cached in " << sounds.shard_count()
+              << " shards, ~" << sound_stats.hits << " hits, " << sound_stats.misses
+              << " misses\n";
+
+    // Level streaming: hint the next area's sounds, then ask for one of them
+    // without blocking; the demand request overtakes the queued hints
+    const std::vector<std::string> next_area = {"sfx/door.wav", "sfx/wind.wav", "sfx/drip.wav"};
+    const std::size_t queued = sounds.prefetch(next_area);
+    auto door = sounds.get_async("sfx/door.wav").get();
+    std::cout << "Prefetched " << queued << " sounds; door sound at " << door->sample_rate
+              << " Hz\n";
+
+    // Progressive loading: the first second of music is playable, and the
+    // top of the skybox drawable, long before either file is decoded
+    const auto dir = std::filesystem::temp_directory_path() / "day1_streaming";
+    std::filesystem::create_directories(dir);
+    const std::string music_path = (dir / "music.snd").string();
+    const std::string sky_path = (dir / "sky.tex").string();
+    write_demo_sound(music_path, 44100, 60);
+    write_demo_texture(sky_path, 4096, 4096);
+    {
+        day1::LoadScheduler io(2, 0);
+        const common::Stopwatch since_start;
+        auto music = Sound::stream(io, music_path);
+        auto sky = Texture::stream(io, sky_path);
+        music->samples.wait(static_cast<std::size_t>(music->sample_rate));
+        const double music_first = since_start.elapsed_ms();
+        sky->pixels.wait(static_cast<std::size_t>(sky->width) * 256);
+        const double sky_first = since_start.elapsed_ms();
+        music->samples.wait_all();
+        const double music_all = since_start.elapsed_ms();
+        sky->pixels.wait_all();
+        const double sky_all = since_start.elapsed_ms();
+        std::cout << "Streamed music: first second after " << music_first << " ms, all "
+                  << music->samples.size() / static_cast<std::size_t>(music->sample_rate)
+                  << " s after " << music_all << " ms\n";
+        std::cout << "Streamed skybox: 256 rows after " << sky_first << " ms, all "
+                  << sky->rows_ready() << " rows after " << sky_all << " ms\n";
+    }
+    std::filesystem::remove_all(dir);
     return 0;
 }
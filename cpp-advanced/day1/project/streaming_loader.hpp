@@ -0,0 +1,308 @@
+// day1/project/streaming_loader.hpp
+// Progressive loading: decode a file in chunks into preallocated storage
+//
+// A loader that reads and decodes the whole file before returning makes
+// the caller wait for the last byte even when the first ones are all it
+// needs now, such as the opening seconds of a sound or the top rows of a
+// texture. stream_file() allocates the decoded storage up front from a
+// size the caller read from the file's header, queues the decode on a
+// LoadScheduler, and returns at once. The decoded prefix grows chunk by
+// chunk and can be used while the rest is still streaming in:
+//
+//     auto header = day1::read_header<SoundHeader>(path);
+//     day1::StreamedBuffer<std::int16_t> samples = day1::stream_file<std::int16_t>(
+//         io, path, {.offset = sizeof(header), .count = header.frames});
+//     play(samples.wait(header.sample_rate));  // first second
+//
+// The source is either a read-only mmap of the file (the decoder reads the
+// page cache in place; MADV_SEQUENTIAL lets the kernel read ahead) or
+// pread() into one chunk-sized staging buffer. The decoder is a function
+// from encoded bytes to elements; without one the bytes are copied, which
+// requires the file layout to match T.
+//
+// The decode job shares ownership of the storage, so a StreamedBuffer can
+// be dropped while it streams. A read error or short file marks the buffer
+// failed and wait() throws; the elements already decoded remain readable.
+//
+// Linux/POSIX only.
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "load_scheduler.hpp"
+
+namespace day1 {
+
+enum class StreamSource { mmap, pread };
+
+struct StreamOptions {
+    StreamSource source = StreamSource::mmap;
+    std::size_t chunk_bytes = std::size_t{256} << 10;  // encoded bytes per step
+};
+
+template <typename T>
+using ChunkDecoder = std::function<void(std::span<const std::byte> in, std::span<T> out)>;
+
+template <typename T>
+struct StreamLayout {
+    std::size_t offset = 0;                // first encoded byte in the file
+    std::size_t count = 0;                 // elements to decode
+    std::size_t encoded_size = sizeof(T);  // bytes per element in the file
+    ChunkDecoder<T> decode = {};           // empty: copy bytes
+};
+
+namespace stream_detail {
+
+[[noreturn]] inline void throw_errno(const std::string &what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Read-only view of a file through mmap or pread
+class FileSource {
+   public:
+    FileSource(const std::string &path, StreamSource source) : path_(path) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw_errno("stream: cannot open " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) {
+            const int error = errno;
+            ::close(fd_);
+            throw std::system_error(error, std::generic_category(), "stream: cannot stat " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (source == StreamSource::mmap && size_ > 0) {
+            void *base = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (base == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd_);
+                throw std::system_error(error, std::generic_category(),
+                                        "stream: cannot map " + path);
+            }
+            ::madvise(base, size_, MADV_SEQUENTIAL);
+            base_ = static_cast<const std::byte *>(base);
+        }
+    }
+
+    FileSource(const FileSource &) = delete;
+    FileSource &operator=(const FileSource &) = delete;
+
+    ~FileSource() {
+        if (base_) {
+            ::munmap(const_cast<std::byte *>(base_), size_);
+        }
+        ::close(fd_);
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    // Bytes [offset, offset + n), which the caller has checked are in the
+    // file. pread() fills staging; the span is valid until the next read.
+    std::span<const std::byte> read(std::size_t offset, std::size_t n,
+                                    std::vector<std::byte> &staging) const {
+        if (base_) {
+            return {base_ + offset, n};
+        }
+        staging.resize(n);
+        for (std::size_t done = 0; done < n;) {
+            const ssize_t got =
+                ::pread(fd_, staging.data() + done, n - done, static_cast<off_t>(offset + done));
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_errno("stream: read failed on " + path_);
+            }
+            if (got == 0) {
+                throw std::runtime_error("stream: " + path_ + " is shorter than expected");
+            }
+            done += static_cast<std::size_t>(got);
+        }
+        return {staging.data(), n};
+    }
+
+   private:
+    std::string path_;
+    int fd_ = -1;
+    std::size_t size_ = 0;
+    const std::byte *base_ = nullptr;
+};
+
+}  // namespace stream_detail
+
+template <typename T>
+class StreamedBuffer;
+
+template <typename T>
+StreamedBuffer<T> stream_file(LoadScheduler &io, const std::string &path, StreamLayout<T> layout,
+                              StreamOptions options = {});
+
+// Decoded storage that fills in front to back
+template <typename T>
+class StreamedBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "StreamedBuffer: T must be trivially copyable");
+
+   public:
+    StreamedBuffer() : StreamedBuffer(0) {}
+
+    // count value-initialized elements, already complete
+    explicit StreamedBuffer(std::size_t count) : state_(std::make_shared<State>(count, true)) {
+        state_->ready.store(count, std::memory_order_relaxed);
+    }
+
+    std::size_t size() const {
+        return state_->size;
+    }
+    std::size_t ready() const {
+        return state_->ready.load(std::memory_order_acquire);
+    }
+    bool complete() const {
+        return ready() == size();
+    }
+    bool failed() const {
+        return state_->failed.load(std::memory_order_acquire);
+    }
+
+    // Decoded prefix; never blocks
+    std::span<const T> available() const {
+        return {state_->data.get(), ready()};
+    }
+
+    // Blocks until at least count elements (at most size()) are decoded and
+    // returns the decoded prefix. Throws std::runtime_error if decoding
+    // failed before reaching count.
+    std::span<const T> wait(std::size_t count) const {
+        count = std::min(count, size());
+        if (ready() < count) {
+            std::unique_lock lock(state_->mutex);
+            state_->progress.wait(lock, [&] { return ready() >= count || failed(); });
+            if (ready() < count) {
+                throw std::runtime_error("StreamedBuffer: stream failed at element " +
+                                         std::to_string(ready()));
+            }
+        }
+        return available();
+    }
+    std::span<const T> wait_all() const {
+        return wait(size());
+    }
+
+   private:
+    struct State {
+        // Storage the decoder fills is left uninitialized: zeroing it first
+        // would touch every page before the first chunk is available
+        State(std::size_t count, bool zeroed)
+            : data(zeroed ? std::make_unique<T[]>(count)
+                          : std::make_unique_for_overwrite<T[]>(count)),
+              size(count) {}
+
+        void publish(std::size_t count) {
+            ready.store(count, std::memory_order_release);
+            { std::lock_guard lock(mutex); }
+            progress.notify_all();
+        }
+
+        void fail() {
+            {
+                std::lock_guard lock(mutex);
+                failed.store(true, std::memory_order_release);
+            }
+            progress.notify_all();
+        }
+
+        std::unique_ptr<T[]> data;
+        std::size_t size;
+        std::atomic<std::size_t> ready{0};
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable progress;
+    };
+
+    explicit StreamedBuffer(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    template <typename U>
+    friend StreamedBuffer<U> stream_file(LoadScheduler &, const std::string &, StreamLayout<U>,
+                                         StreamOptions);
+
+    std::shared_ptr<State> state_;
+};
+
+// Reads sizeof(Header) bytes at the start of path
+template <typename Header>
+Header read_header(const std::string &path) {
+    static_assert(std::is_trivially_copyable_v<Header>);
+    stream_detail::FileSource file(path, StreamSource::pread);
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error("stream: " + path + " has no header");
+    }
+    std::vector<std::byte> staging;
+    Header header;
+    std::memcpy(&header, file.read(0, sizeof(Header), staging).data(), sizeof(Header));
+    return header;
+}
+
+// Opens path now (throwing if it cannot be opened or is too short for
+// layout) and decodes it on io as a demand job
+template <typename T>
+StreamedBuffer<T> stream_file(LoadScheduler &io, const std::string &path, StreamLayout<T> layout,
+                              StreamOptions options) {
+    if (!layout.decode && layout.encoded_size != sizeof(T)) {
+        throw std::invalid_argument(
+            "stream_file: a decoder is needed when encoded_size != sizeof(T)");
+    }
+    auto file = std::make_shared<stream_detail::FileSource>(path, options.source);
+    if (layout.encoded_size == 0 || file->size() < layout.offset ||
+        (file->size() - layout.offset) / layout.encoded_size < layout.count) {
+        throw std::runtime_error("stream_file: " + path + " is shorter than its layout");
+    }
+    using State = typename StreamedBuffer<T>::State;
+    auto state = std::make_shared<State>(layout.count, false);
+    const std::size_t step = std::max<std::size_t>(1, options.chunk_bytes / layout.encoded_size);
+    io.submit(LoadPriority::demand, [state, file, layout = std::move(layout), step] {
+        std::vector<std::byte> staging;
+        try {
+            for (std::size_t done = 0; done < layout.count;) {
+                const std::size_t n = std::min(step, layout.count - done);
+                auto in = file->read(layout.offset + done * layout.encoded_size,
+                                     n * layout.encoded_size, staging);
+                std::span<T> out(state->data.get() + done, n);
+                if (layout.decode) {
+                    layout.decode(in, out);
+                } else {
+                    std::memcpy(out.data(), in.data(), in.size());
+                }
+                done += n;
+                state->publish(done);
+            }
+        } catch (...) {
+            state->fail();
+        }
+    });
+    return StreamedBuffer<T>(std::move(state));
+}
+
+}  // namespace day1
@@ -0,0 +1,83 @@
+#!/bin/bash
+# Link-time optimization and post-link layout comparison for Day 1
+#
+#   1. build-release    Release build without LTO, the baseline
+#   2. build-lto-thin   -DLTO=THIN
+#   3. build-lto-full   -DLTO=FULL
+#   4. build-bolt       -DLTO=THIN -DBOLT=ON plus bolt_optimize (--bolt only)
+#
+# Then every benchmark runs on its training workload (the arguments in
+# day1/CMakeLists.txt) in each build. The table shows the best of three
+# wall times and, when perf is installed, L1 instruction-cache misses per
+# thousand instructions from one extra run under `perf stat`.
+#
+# Usage: ./lto.sh [--bolt]
+# --bolt needs perf, perf2bolt and llvm-bolt; add BOLT_LBR=OFF to the
+# environment on machines without last-branch records.
+
+set -euo pipefail
+cd "$(dirname "$0")"
+# shellcheck source=bench_common.sh
+. ./bench_common.sh
+
+BOLT=0
+if [ "${1:-}" = "--bolt" ]; then
+    BOLT=1
+fi
+HAVE_PERF=0
+if command -v perf >/dev/null 2>&1; then
+    HAVE_PERF=1
+fi
+
+build() {
+    local dir=$1
+    shift
+    echo "🔨 Building $dir..."
+    cmake -S . -B "$dir" -DCMAKE_BUILD_TYPE=Release -DPGO=OFF "$@" >/dev/null
+    cmake --build "$dir" --parallel >/dev/null
+}
+
+build build-release -DLTO=OFF -DBOLT=OFF
+build build-lto-thin -DLTO=THIN -DBOLT=OFF
+build build-lto-full -DLTO=FULL -DBOLT=OFF
+if [ "$BOLT" = 1 ]; then
+    build build-bolt -DLTO=THIN -DBOLT=ON -DBOLT_LBR="${BOLT_LBR:-ON}"
+    echo "⚡ Applying BOLT layout..."
+    cmake --build build-bolt --target bolt_optimize >/dev/null
+fi
+
+# L1 instruction-cache misses per 1000 instructions, or "-" without perf
+icache_mpki() {
+    if [ "$HAVE_PERF" = 0 ]; then
+        echo "-"
+        return
+    fi
+    perf stat -x, -e instructions:u,L1-icache-load-misses:u -- "$@" </dev/null 2>&1 >/dev/null |
+        awk -F, '$3 ~ /^instructions/ { ins = $1 } $3 ~ /icache/ { miss = $1 }
+                 END { if (ins > 0 && miss ~ /^[0-9]+$/) printf "%.2f", 1000 * miss / ins; else print "-" }'
+}
+
+# One "ms/mpki" cell
+measure() {
+    echo "$(run_ms "$@")/$(icache_mpki "$@")"
+}
+
+echo
+echo "Each cell: best wall ms / L1-icache misses per 1000 instructions"
+header=$(printf "%-36s %16s %16s %16s" "benchmark" "baseline" "thin LTO" "full LTO")
+if [ "$BOLT" = 1 ]; then
+    header=$(printf "%s %16s" "$header" "thin LTO + BOLT")
+fi
+echo "$header"
+while read -r name args; do
+    # shellcheck disable=SC2086 # args is a list of words
+    row=$(printf "%-36s %16s %16s %16s" "$name" \
+        "$(measure build-release/day1/"$name" $args)" \
+        "$(measure build-lto-thin/day1/"$name" $args)" \
+        "$(measure build-lto-full/day1/"$name" $args)")
+    if [ "$BOLT" = 1 ]; then
+        # shellcheck disable=SC2086
+        row=$(printf "%s %16s" "$row" "$(measure build-bolt/day1/"$name".bolt $args)")
+    fi
+    echo "$row"
+done < build-release/day1/benchmarks.txt
@@ -0,0 +1,55 @@
+#!/bin/bash
+# Profile-guided optimization cycle for the Day 1 targets
+#
+#   1. build-release   Release build without PGO, the baseline
+#   2. build-pgo-gen   instrumented build; pgo_train runs the training
+#                      workload and writes profiles to build-pgo-profiles
+#   3. build-pgo       Release build optimized with those profiles
+#
+# Then every benchmark runs in builds 1 and 3 and the wall times are
+# compared. By default the benchmarks run on their training workloads
+# (the arguments in day1/CMakeLists.txt); --full runs their default
+# workloads instead, which is slower and not what the profiles were
+# trained on.
+#
+# Usage: ./pgo.sh [--full]
+# The compiler is CMake's choice unless CXX is set (g++ or clang++).
+
+set -euo pipefail
+cd "$(dirname "$0")"
+# shellcheck source=bench_common.sh
+. ./bench_common.sh
+
+FULL=0
+if [ "${1:-}" = "--full" ]; then
+    FULL=1
+fi
+PROFILES="$PWD/build-pgo-profiles"
+
+build() {
+    local dir=$1
+    shift
+    echo "🔨 Building $dir..."
+    cmake -S . -B "$dir" -DCMAKE_BUILD_TYPE=Release -DPGO_PROFILE_DIR="$PROFILES" "$@" >/dev/null
+    cmake --build "$dir" --parallel >/dev/null
+}
+
+build build-release -DPGO=OFF
+build build-pgo-gen -DPGO=GENERATE
+echo "🏋️ Training..."
+cmake --build build-pgo-gen --target pgo_train >/dev/null
+build build-pgo -DPGO=USE
+
+echo
+printf "%-36s %12s %12s %8s\n" "benchmark" "baseline ms" "PGO ms" "speedup"
+while read -r name args; do
+    if [ "$FULL" = 1 ]; then
+        args=""
+    fi
+    # shellcheck disable=SC2086 # args is a list of words
+    base=$(run_ms build-release/day1/"$name" $args)
+    # shellcheck disable=SC2086
+    pgo=$(run_ms build-pgo/day1/"$name" $args)
+    awk -v n="$name" -v b="$base" -v p="$pgo" \
+        'BEGIN { printf "%-36s %12d %12d %7.2fx\n", n, b, p, (p > 0 ? b / p : 0) }'
+done < build-release/day1/benchmarks.txt